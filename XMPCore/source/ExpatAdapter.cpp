@@ -70,7 +70,7 @@ extern "C" ExpatAdapter * XMP_NewExpatAdapter ( bool useGlobalNamespaces )
 
 // =================================================================================================
 
-ExpatAdapter::ExpatAdapter ( bool useGlobalNamespaces ) : parser(0), registeredNamespaces(0)
+ExpatAdapter::ExpatAdapter ( bool useGlobalNamespaces ) : parser(0), registeredNamespaces(0), eventNode(0,"",kElemNode), parsedBytes(0)
 {
 
 	#if XMP_DebugBuild
@@ -91,19 +91,9 @@ ExpatAdapter::ExpatAdapter ( bool useGlobalNamespaces ) : parser(0), registeredN
 			this->registeredNamespaces = new XMP_NamespaceTable ( *sRegisteredNamespaces );
 		}
 	
-		XML_SetUserData ( this->parser, this );
-	
-		XML_SetNamespaceDeclHandler ( this->parser, StartNamespaceDeclHandler, EndNamespaceDeclHandler );
-		XML_SetElementHandler ( this->parser, StartElementHandler, EndElementHandler );
-
-		XML_SetCharacterDataHandler ( this->parser, CharacterDataHandler );
-		XML_SetCdataSectionHandler ( this->parser, StartCdataSectionHandler, EndCdataSectionHandler );
-
-		XML_SetProcessingInstructionHandler ( this->parser, ProcessingInstructionHandler );
-		XML_SetCommentHandler ( this->parser, CommentHandler );
+		this->SetHandlers();
 
 		#if BanAllEntityUsage
-			XML_SetStartDoctypeDeclHandler ( this->parser, StartDoctypeDeclHandler );
 			isAborted = false;
 		#endif
 
@@ -113,6 +103,128 @@ ExpatAdapter::ExpatAdapter ( bool useGlobalNamespaces ) : parser(0), registeredN
 
 // =================================================================================================
 
+void ExpatAdapter::SetHandlers()
+{
+
+	XML_SetUserData ( this->parser, this );
+
+	XML_SetNamespaceDeclHandler ( this->parser, StartNamespaceDeclHandler, EndNamespaceDeclHandler );
+	XML_SetElementHandler ( this->parser, StartElementHandler, EndElementHandler );
+
+	XML_SetCharacterDataHandler ( this->parser, CharacterDataHandler );
+	XML_SetCdataSectionHandler ( this->parser, StartCdataSectionHandler, EndCdataSectionHandler );
+
+	XML_SetProcessingInstructionHandler ( this->parser, ProcessingInstructionHandler );
+	XML_SetCommentHandler ( this->parser, CommentHandler );
+
+	#if BanAllEntityUsage
+		XML_SetStartDoctypeDeclHandler ( this->parser, StartDoctypeDeclHandler );
+	#endif
+
+}	// ExpatAdapter::SetHandlers
+
+// =================================================================================================
+// ExpatAdapter::Reset
+// ===================
+//
+// XML_ParserReset keeps the parser's buffers and hash tables but clears the handlers and user data,
+// they are set again.
+
+bool ExpatAdapter::Reset()
+{
+
+	if ( (this->parser == 0) || (! XML_ParserReset ( this->parser, 0 )) ) return false;
+	this->SetHandlers();
+
+	this->XMLParserAdapter::Reset();
+	this->parseStack.push_back ( &this->tree );	// Push the XML root node.
+
+	this->eventNesting.clear();
+	this->parsedBytes = 0;
+
+	#if BanAllEntityUsage
+		this->isAborted = false;
+	#endif
+
+	#if XMP_DebugBuild
+		this->elemNesting = 0;
+	#endif
+
+	return true;
+
+}	// ExpatAdapter::Reset
+
+// =================================================================================================
+// Expat adapter pool
+// ==================
+//
+// Creating an Expat parser, with its hash tables and buffers, is a noticeable part of parsing a small
+// packet. XMPMeta gets its adapter from a small per-thread pool and gives it back after the parse.
+// Adapters that parsed a lot of input are deleted instead of pooled, so a thread does not hold on to
+// the buffers of an unusually big packet. A thread's pool is deleted when the thread exits.
+
+static const size_t kMaxPooledAdapters = 4;
+static const size_t kMaxPooledParsedBytes = 1024*1024;
+
+// ! The pool state is trivially destructible, so it stays readable while other thread_local objects
+// ! are destroyed during thread exit. Only the reaper has a destructor, it is touched when the pool
+// ! becomes non-empty and never after it ran.
+
+static thread_local ExpatAdapter * sPooledAdapters [kMaxPooledAdapters];
+static thread_local size_t sPooledCount = 0;
+static thread_local bool   sAdapterPoolClosed = false;
+
+class ExpatAdapterPoolReaper {
+public:
+
+	bool armed;
+
+	ExpatAdapterPoolReaper() : armed(false) {};
+
+	~ExpatAdapterPoolReaper()
+	{
+		while ( sPooledCount > 0 ) {
+			--sPooledCount;
+			sPooledAdapters[sPooledCount]->registeredNamespaces = sRegisteredNamespaces;	// ! Might be a later table.
+			delete sPooledAdapters[sPooledCount];
+		}
+		sAdapterPoolClosed = true;	// ! Adapters released later during thread exit are deleted.
+	};
+
+};
+
+static thread_local ExpatAdapterPoolReaper sAdapterPoolReaper;
+
+ExpatAdapter * XMP_AcquireExpatAdapter()
+{
+	if ( sPooledCount == 0 ) return new ExpatAdapter ( ExpatAdapter::kUseGlobalNamespaces );
+
+	--sPooledCount;
+	ExpatAdapter * adapter = sPooledAdapters[sPooledCount];
+	adapter->registeredNamespaces = sRegisteredNamespaces;	// ! XMP_Terminate and XMP_Initialize replace the table.
+	return adapter;
+
+}	// XMP_AcquireExpatAdapter
+
+void XMP_ReleaseExpatAdapter ( ExpatAdapter * adapter )
+{
+	if ( adapter == 0 ) return;
+	XMP_Assert ( adapter->registeredNamespaces == sRegisteredNamespaces );
+
+	if ( (! sAdapterPoolClosed) && (sPooledCount < kMaxPooledAdapters) &&
+		 (adapter->parsedBytes <= kMaxPooledParsedBytes) && adapter->Reset() ) {
+		if ( sPooledCount == 0 ) sAdapterPoolReaper.armed = true;	// Make sure the pool is freed at thread exit.
+		sPooledAdapters[sPooledCount] = adapter;
+		++sPooledCount;
+		return;
+	}
+
+	delete adapter;
+
+}	// XMP_ReleaseExpatAdapter
+
+// =================================================================================================
+
 ExpatAdapter::~ExpatAdapter()
 {
 
@@ -122,6 +234,9 @@ ExpatAdapter::~ExpatAdapter()
 	if ( this->registeredNamespaces != sRegisteredNamespaces ) delete ( this->registeredNamespaces );
 	this->registeredNamespaces = 0;
 
+	this->eventNode.attrs.clear();	// ! The attribute nodes are owned by eventAttrs.
+	for ( size_t i = 0, limit = this->eventAttrs.size(); i < limit; ++i ) delete this->eventAttrs[i];
+
 }	// ExpatAdapter::~ExpatAdapter
 
 // =================================================================================================
@@ -142,6 +257,7 @@ void ExpatAdapter::ParseBuffer ( const void * buffer, size_t length, bool last /
 		length = 1;
 	}
 	
+	this->parsedBytes += length;
 	status = XML_Parse ( this->parser, (const char *)buffer, static_cast< XMP_StringLen >( length ), last );
 	
 	#if BanAllEntityUsage
@@ -197,7 +313,15 @@ void ExpatAdapter::ParseBuffer ( const void * buffer, size_t length, bool last /
 
 // =================================================================================================
 
-static void SetQualName ( ExpatAdapter * thiz, XMP_StringPtr fullName, XML_Node * node )
+static inline XML_Node * NewNode ( ExpatAdapter * thiz, XML_Node * parent, XMP_StringPtr name, XMP_Uns8 kind )
+{
+	if ( thiz->nodeArena == 0 ) return new XML_Node ( parent, name, kind );
+	return thiz->nodeArena->NewNode ( parent, name, kind );
+}
+
+// =================================================================================================
+
+static void SetQualName ( ExpatAdapter * thiz, XMP_StringPtr fullName, XML_Node * node, bool inDescription )
 {
 	// Expat delivers the full name as a catenation of namespace URI, separator, and local name.
 
@@ -230,6 +354,7 @@ static void SetQualName ( ExpatAdapter * thiz, XMP_StringPtr fullName, XML_Node
 		}
 		node->nsPrefixLen = prefixLen;	// ! Includes the ':'.
 		
+		node->name.reserve ( prefixLen + strlen ( localPart ) );
 		node->name = prefix;
 		node->name += localPart;
 
@@ -237,7 +362,7 @@ static void SetQualName ( ExpatAdapter * thiz, XMP_StringPtr fullName, XML_Node
 
 		node->name = fullName;	// The name is not in a namespace.
 	
-		if ( node->parent->name == "rdf:Description" ) {
+		if ( inDescription ) {
 			if ( node->name == "about" ) {
 				node->ns   = kXMP_NS_RDF;
 				node->name = "rdf:about";
@@ -309,6 +434,46 @@ static void EndNamespaceDeclHandler ( void * userData, XMP_StringPtr prefix )
 
 // =================================================================================================
 
+static void StartElementEvent ( ExpatAdapter * thiz, XMP_StringPtr name, XMP_StringPtr* attrs )
+{
+	// Fill in the reused element node and pass it to the event receiver instead of adding to the
+	// tree. The names and values are the same as for a tree node.
+
+	XML_Node * elemNode = &thiz->eventNode;
+	bool inDescription = ( (! thiz->eventNesting.empty()) && thiz->eventNesting.back() );
+
+	elemNode->ns.erase();
+	elemNode->nsPrefixLen = 0;
+	SetQualName ( thiz, name, elemNode, inDescription );
+	
+	elemNode->attrs.clear();
+	
+	for ( XMP_StringPtr* attr = attrs; *attr != 0; attr += 2 ) {
+
+		size_t attrNum = elemNode->attrs.size();
+		if ( attrNum == thiz->eventAttrs.size() ) thiz->eventAttrs.push_back ( new XML_Node ( elemNode, "", kAttrNode ) );
+		XML_Node * attrNode = thiz->eventAttrs[attrNum];
+
+		attrNode->ns.erase();
+		attrNode->nsPrefixLen = 0;
+		SetQualName ( thiz, *attr, attrNode, (elemNode->name == "rdf:Description") );
+		attrNode->value = *(attr+1);
+		if ( attrNode->name == "xml:lang" ) NormalizeLangValue ( &attrNode->value );
+		elemNode->attrs.push_back ( attrNode );
+
+	}
+
+	thiz->eventNesting.push_back ( elemNode->name == "rdf:Description" );
+	#if XMP_DebugBuild
+		++thiz->elemNesting;
+	#endif
+
+	thiz->eventReceiver->StartElement ( *elemNode );
+
+}	// StartElementEvent
+
+// =================================================================================================
+
 static void StartElementHandler ( void * userData, XMP_StringPtr name, XMP_StringPtr* attrs )
 {
 	XMP_Assert ( attrs != 0 );
@@ -335,18 +500,25 @@ static void StartElementHandler ( void * userData, XMP_StringPtr name, XMP_Strin
 		}
 	#endif
 
+	if ( thiz->eventReceiver != 0 ) {
+		StartElementEvent ( thiz, name, attrs );
+		return;
+	}
+
 	XML_Node * parentNode = thiz->parseStack.back();
-	XML_Node * elemNode   = new XML_Node ( parentNode, "", kElemNode );
+	XML_Node * elemNode   = NewNode ( thiz, parentNode, "", kElemNode );
 	
-	SetQualName ( thiz, name, elemNode );
+	SetQualName ( thiz, name, elemNode, (parentNode->name == "rdf:Description") );
 	
+	elemNode->attrs.reserve ( attrCount );
+
 	for ( XMP_StringPtr* attr = attrs; *attr != 0; attr += 2 ) {
 
 		XMP_StringPtr attrName = *attr;
 		XMP_StringPtr attrValue = *(attr+1);
-		XML_Node * attrNode = new XML_Node ( elemNode, "", kAttrNode );
+		XML_Node * attrNode = NewNode ( thiz, elemNode, "", kAttrNode );
 
-		SetQualName ( thiz, attrName, attrNode );
+		SetQualName ( thiz, attrName, attrNode, (elemNode->name == "rdf:Description") );
 		attrNode->value = attrValue;
 		if ( attrNode->name == "xml:lang" ) NormalizeLangValue ( &attrNode->value );
 		elemNode->attrs.push_back ( attrNode );
@@ -377,7 +549,13 @@ static void EndElementHandler ( void * userData, XMP_StringPtr name )
 	#if XMP_DebugBuild
 		--thiz->elemNesting;
 	#endif
-	(void) thiz->parseStack.pop_back();
+
+	if ( thiz->eventReceiver != 0 ) {
+		thiz->eventNesting.pop_back();
+		thiz->eventReceiver->EndElement();
+	} else {
+		(void) thiz->parseStack.pop_back();
+	}
 	
 	#if XMP_DebugBuild & DumpXMLParseEvents
 		if ( thiz->parseLog != 0 ) {
@@ -405,8 +583,13 @@ static void CharacterDataHandler ( void * userData, XMP_StringPtr cData, int len
 		}
 	#endif
 	
+	if ( thiz->eventReceiver != 0 ) {
+		thiz->eventReceiver->CharacterData ( cData, len );
+		return;
+	}
+
 	XML_Node * parentNode = thiz->parseStack.back();
-	XML_Node * cDataNode  = new XML_Node ( parentNode, "", kCDataNode );
+	XML_Node * cDataNode  = NewNode ( thiz, parentNode, "", kCDataNode );
 	
 	cDataNode->value.assign ( cData, len );
 	parentNode->content.push_back ( cDataNode );
@@ -470,8 +653,13 @@ static void ProcessingInstructionHandler ( void * userData, XMP_StringPtr target
 		}
 	#endif
 	
+	if ( thiz->eventReceiver != 0 ) {
+		thiz->eventReceiver->ProcessingInstruction ( target, data );
+		return;
+	}
+
 	XML_Node * parentNode = thiz->parseStack.back();
-	XML_Node * piNode  = new XML_Node ( parentNode, target, kPINode );
+	XML_Node * piNode  = NewNode ( thiz, parentNode, target, kPINode );
 	
 	piNode->value.assign ( data );
 	parentNode->content.push_back ( piNode );
@@ -163,7 +163,7 @@ using namespace std;
 //
 // Each of these is responsible for recognizing an RDF syntax production and adding the appropriate
 // structure to the XMP tree. They simply return for success, failures will throw an exception. The
-// class exists only to provide access to the error notification object.
+// class exists only to provide access to the error notification object and the parse namespaces.
 
 class RDF_Parser {
 public:
@@ -174,37 +174,54 @@ public:
 
 	void NodeElement ( XMP_Node * xmpParent, const XML_Node & xmlNode, bool isTopLevel );
 
+	bool StartNodeElement ( XMP_Node * xmpParent, const XML_Node & xmlNode, bool isTopLevel );
+
 	void NodeElementAttrs ( XMP_Node * xmpParent, const XML_Node & xmlNode, bool isTopLevel );
 
 	void PropertyElementList ( XMP_Node * xmpParent, const XML_Node & xmlParent, bool isTopLevel );
 
 	void PropertyElement ( XMP_Node * xmpParent, const XML_Node & xmlNode, bool isTopLevel );
 
+	XMP_Uns8 PropertyElementForm ( const XML_Node & xmlNode );
+
 	void ResourcePropertyElement ( XMP_Node * xmpParent, const XML_Node & xmlNode, bool isTopLevel );
 
+	XMP_Node * StartResourceProperty ( XMP_Node * xmpParent, const XML_Node & xmlNode, bool isTopLevel );
+
+	bool SetResourceForm ( XMP_Node * newCompound, const XML_Node & nodeElem );
+
+	void EndResourceProperty ( XMP_Node * newCompound );
+
 	void LiteralPropertyElement ( XMP_Node * xmpParent, const XML_Node & xmlNode, bool isTopLevel );
 
 	void ParseTypeLiteralPropertyElement ( XMP_Node * xmpParent, const XML_Node & xmlNode, bool isTopLevel );
 
 	void ParseTypeResourcePropertyElement ( XMP_Node * xmpParent, const XML_Node & xmlNode, bool isTopLevel );
 
+	XMP_Node * StartParseTypeResource ( XMP_Node * xmpParent, const XML_Node & xmlNode, bool isTopLevel );
+
 	void ParseTypeCollectionPropertyElement ( XMP_Node * xmpParent, const XML_Node & xmlNode, bool isTopLevel );
 
 	void ParseTypeOtherPropertyElement ( XMP_Node * xmpParent, const XML_Node & xmlNode, bool isTopLevel );
 
 	void EmptyPropertyElement ( XMP_Node * xmpParent, const XML_Node & xmlNode, bool isTopLevel );
 
-	RDF_Parser ( XMPMeta::ErrorCallbackInfo * ec ) : errorCallback(ec) {};
+	RDF_Parser ( XMPMeta::ErrorCallbackInfo * ec, const std::vector<XMP_VarString> * ns = 0 )
+		: errorCallback(ec), parseNamespaces(ns) {};
 
-private:
+protected:
 
 	RDF_Parser() { 
 
 		errorCallback = NULL;
+		parseNamespaces = NULL;
 
 	};	// Hidden on purpose.
 	
 	XMPMeta::ErrorCallbackInfo * errorCallback;
+	const std::vector<XMP_VarString> * parseNamespaces;	// The schemas to keep, all if null or empty.
+
+	bool IsSkippedProperty ( const XML_Node & xmlNode, bool isTopLevel ) const;
 
 	XMP_Node * AddChildNode ( XMP_Node * xmpParent, const XML_Node & xmlNode, const XMP_StringPtr value, bool isTopLevel );
 
@@ -267,6 +284,17 @@ enum {
 	kRDF_HasValueElem = 0x10000000UL	// ! Contains rdf:value child. Must fit within kXMP_ImplReservedMask!
 };
 
+enum {	// The property element forms, see RDF_Parser::PropertyElementForm.
+	kPropForm_Invalid				= 0,
+	kPropForm_Empty					= 1,
+	kPropForm_Literal				= 2,
+	kPropForm_ParseTypeLiteral		= 3,
+	kPropForm_ParseTypeResource		= 4,
+	kPropForm_ParseTypeCollection	= 5,
+	kPropForm_ParseTypeOther		= 6,
+	kPropForm_FromContent			= 7		// A resource or literal property, or empty if there is no content.
+};
+
 // -------------------------------------------------------------------------------------------------
 // GetRDFTermKind
 // --------------
@@ -394,6 +422,25 @@ IsNumberedArrayItemName ( const std::string & name )
 	return true;
 }
 
+// =================================================================================================
+// RDF_Parser::IsSkippedProperty
+// =============================
+//
+// True for a top level property outside of the parse namespaces. The caller drops it along with all
+// of its content, without checking the RDF of the content.
+
+bool RDF_Parser::IsSkippedProperty ( const XML_Node & xmlNode, bool isTopLevel ) const
+{
+	if ( (! isTopLevel) || (this->parseNamespaces == 0) || this->parseNamespaces->empty() ) return false;
+
+	for ( size_t i = 0, limit = this->parseNamespaces->size(); i < limit; ++i ) {
+		if ( xmlNode.ns == (*this->parseNamespaces)[i] ) return false;
+	}
+
+	return true;
+
+}	// RDF_Parser::IsSkippedProperty
+
 // =================================================================================================
 // RDF_Parser::AddChildNode
 // ========================
@@ -423,7 +470,7 @@ XMP_Node * RDF_Parser::AddChildNode ( XMP_Node * xmpParent, const XML_Node & xml
 		xmpParent = schemaNode;
 		
 		// If this is an alias set the isAlias flag in the node and the hasAliases flag in the tree.
-		if ( sRegisteredAliasMap->find ( xmlNode.name ) != sRegisteredAliasMap->end() ) {
+		if ( IsRegisteredAlias ( xmlNode.name ) ) {
 			childOptions |= kXMP_PropIsAlias;
 			schemaNode->parent->options |= kXMP_PropHasAliases;
 		}
@@ -457,6 +504,7 @@ XMP_Node * RDF_Parser::AddChildNode ( XMP_Node * xmpParent, const XML_Node & xml
 
 	// Make sure that this is not a duplicate of a named node.
 	if ( ! (isArrayItem | isValueNode) ) {
+		xmpParent->children.UpdateIndex();	// The parse owns the tree, index wide schemas and structs.
 		if ( FindChildNode ( xmpParent, childName, kXMP_ExistingOnly ) != 0 ) {
 			XMP_Error error ( kXMPErr_BadXMP, "Duplicate property or field node" );
 			this->errorCallback->NotifyClient ( kXMPErrSev_Recoverable, error );
@@ -736,20 +784,38 @@ void RDF_Parser::NodeElementList ( XMP_Node * xmpParent, const XML_Node & xmlPar
 // A node element URI is rdf:Description or anything else that is not an RDF term.
 
 void RDF_Parser::NodeElement ( XMP_Node * xmpParent, const XML_Node & xmlNode, bool isTopLevel )
+{
+
+	if ( this->StartNodeElement ( xmpParent, xmlNode, isTopLevel ) ) {
+		this->PropertyElementList ( xmpParent, xmlNode, isTopLevel );
+	}
+
+}	// RDF_Parser::NodeElement
+
+// =================================================================================================
+// RDF_Parser::StartNodeElement
+// ============================
+//
+// Check the node element name and process its attributes. Returns false if the element is to be
+// ignored, the error has been reported.
+
+bool RDF_Parser::StartNodeElement ( XMP_Node * xmpParent, const XML_Node & xmlNode, bool isTopLevel )
 {
 	RDFTermKind nodeTerm = GetRDFTermKind ( xmlNode.name );
 	if ( (nodeTerm != kRDFTerm_Description) && (nodeTerm != kRDFTerm_Other) ) {
 		XMP_Error error ( kXMPErr_BadRDF, "Node element must be rdf:Description or typedNode" );
 		this->errorCallback->NotifyClient ( kXMPErrSev_Recoverable, error );
+		return false;
 	} else if ( isTopLevel && (nodeTerm == kRDFTerm_Other) ) {
 		XMP_Error error ( kXMPErr_BadXMP, "Top level typedNode not allowed" );
 		this->errorCallback->NotifyClient ( kXMPErrSev_Recoverable, error );
-	} else {
-		this->NodeElementAttrs ( xmpParent, xmlNode, isTopLevel );
-		this->PropertyElementList ( xmpParent, xmlNode, isTopLevel );
+		return false;
 	}
 
-}	// RDF_Parser::NodeElement
+	this->NodeElementAttrs ( xmpParent, xmlNode, isTopLevel );
+	return true;
+
+}	// RDF_Parser::StartNodeElement
 
 // =================================================================================================
 // RDF_Parser::NodeElementAttrs
@@ -811,6 +877,7 @@ void RDF_Parser::NodeElementAttrs ( XMP_Node * xmpParent, const XML_Node & xmlNo
 				break;
 
 			case kRDFTerm_Other :
+				if ( this->IsSkippedProperty ( **currAttr, isTopLevel ) ) break;
 				this->AddChildNode ( xmpParent, **currAttr, (*currAttr)->value.c_str(), isTopLevel );
 				break;
 
@@ -846,6 +913,7 @@ void RDF_Parser::PropertyElementList ( XMP_Node * xmpParent, const XML_Node & xm
 			this->errorCallback->NotifyClient ( kXMPErrSev_Recoverable, error );
 			continue;
 		}
+		if ( this->IsSkippedProperty ( **currChild, isTopLevel ) ) continue;
 		this->PropertyElement ( xmpParent, **currChild, isTopLevel );
 	}
 
@@ -903,83 +971,123 @@ void RDF_Parser::PropertyElementList ( XMP_Node * xmpParent, const XML_Node & xm
 
 void RDF_Parser::PropertyElement ( XMP_Node * xmpParent, const XML_Node & xmlNode, bool isTopLevel )
 {
-	RDFTermKind nodeTerm = GetRDFTermKind ( xmlNode.name );
-	if ( ! IsPropertyElementName ( nodeTerm ) ) {
-		XMP_Error error ( kXMPErr_BadRDF, "Invalid property element name" );
-		this->errorCallback->NotifyClient ( kXMPErrSev_Recoverable, error );
-		return;
-	}
-	
-	if ( xmlNode.attrs.size() > 3 ) {
 
-		// Only an emptyPropertyElt can have more than 3 attributes.
-		this->EmptyPropertyElement ( xmpParent, xmlNode, isTopLevel );
+	switch ( this->PropertyElementForm ( xmlNode ) ) {
 
-	} else {
+		case kPropForm_Invalid :
+			break;	// The error has been reported.
 
-		// Look through the attributes for one that isn't rdf:ID or xml:lang, it will usually tell
-		// what we should be dealing with. The called routines must verify their specific syntax!
+		case kPropForm_Empty :
+			this->EmptyPropertyElement ( xmpParent, xmlNode, isTopLevel );
+			break;
 
-		XML_cNodePos currAttr = xmlNode.attrs.begin();
-		XML_cNodePos endAttr  = xmlNode.attrs.end();
-		XMP_VarString * attrName = 0;
+		case kPropForm_Literal :
+			this->LiteralPropertyElement ( xmpParent, xmlNode, isTopLevel );
+			break;
 
-		for ( ; currAttr != endAttr; ++currAttr ) {
-			attrName = &((*currAttr)->name);
-			if ( (*attrName != "xml:lang") && (*attrName != "rdf:ID") ) break;
-		}
+		case kPropForm_ParseTypeLiteral :
+			this->ParseTypeLiteralPropertyElement ( xmpParent, xmlNode, isTopLevel );
+			break;
 
-		if ( currAttr != endAttr ) {
-
-			XMP_Assert ( attrName != 0 );
-			XMP_VarString& attrValue = (*currAttr)->value;
-
-			if ( *attrName == "rdf:datatype" ) {
-				this->LiteralPropertyElement ( xmpParent, xmlNode, isTopLevel );
-			} else if ( *attrName != "rdf:parseType" ) {
-				this->EmptyPropertyElement ( xmpParent, xmlNode, isTopLevel );
-			} else if ( attrValue == "Literal" ) {
-				this->ParseTypeLiteralPropertyElement ( xmpParent, xmlNode, isTopLevel );
-			} else if ( attrValue == "Resource" ) {
-				this->ParseTypeResourcePropertyElement ( xmpParent, xmlNode, isTopLevel );
-			} else if ( attrValue == "Collection" ) {
-				this->ParseTypeCollectionPropertyElement ( xmpParent, xmlNode, isTopLevel );
-			} else {
-				this->ParseTypeOtherPropertyElement ( xmpParent, xmlNode, isTopLevel );
-			}
+		case kPropForm_ParseTypeResource :
+			this->ParseTypeResourcePropertyElement ( xmpParent, xmlNode, isTopLevel );
+			break;
 
-		} else {
+		case kPropForm_ParseTypeCollection :
+			this->ParseTypeCollectionPropertyElement ( xmpParent, xmlNode, isTopLevel );
+			break;
 
-			// Only rdf:ID and xml:lang, could be a resourcePropertyElt, a literalPropertyElt, or an.
-			// emptyPropertyElt. Look at the child XML nodes to decide which.
+		case kPropForm_ParseTypeOther :
+			this->ParseTypeOtherPropertyElement ( xmpParent, xmlNode, isTopLevel );
+			break;
 
-			if ( xmlNode.content.empty() ) {
+		case kPropForm_FromContent :
+			{
 
-				this->EmptyPropertyElement ( xmpParent, xmlNode, isTopLevel );
+				// Only rdf:ID and xml:lang, could be a resourcePropertyElt, a literalPropertyElt, or an.
+				// emptyPropertyElt. Look at the child XML nodes to decide which.
 
-			} else {
-			
-				XML_cNodePos currChild = xmlNode.content.begin();
-				XML_cNodePos endChild  = xmlNode.content.end();
+				if ( xmlNode.content.empty() ) {
+
+					this->EmptyPropertyElement ( xmpParent, xmlNode, isTopLevel );
 
-				for ( ; currChild != endChild; ++currChild ) {
-					if ( (*currChild)->kind != kCDataNode ) break;
-				}
-				
-				if ( currChild == endChild ) {
-					this->LiteralPropertyElement ( xmpParent, xmlNode, isTopLevel );
 				} else {
-					this->ResourcePropertyElement ( xmpParent, xmlNode, isTopLevel );
+				
+					XML_cNodePos currChild = xmlNode.content.begin();
+					XML_cNodePos endChild  = xmlNode.content.end();
+
+					for ( ; currChild != endChild; ++currChild ) {
+						if ( (*currChild)->kind != kCDataNode ) break;
+					}
+					
+					if ( currChild == endChild ) {
+						this->LiteralPropertyElement ( xmpParent, xmlNode, isTopLevel );
+					} else {
+						this->ResourcePropertyElement ( xmpParent, xmlNode, isTopLevel );
+					}
+				
 				}
-			
+
 			}
+			break;
 
-		}
-		
 	}
 
 }	// RDF_Parser::PropertyElement
 
+// =================================================================================================
+// RDF_Parser::PropertyElementForm
+// ===============================
+//
+// Decide what form of property element this is from the name and attributes. The resource and
+// literal forms with only rdf:ID and xml:lang attributes are told apart by the content, which is
+// left to the caller.
+
+XMP_Uns8 RDF_Parser::PropertyElementForm ( const XML_Node & xmlNode )
+{
+	RDFTermKind nodeTerm = GetRDFTermKind ( xmlNode.name );
+	if ( ! IsPropertyElementName ( nodeTerm ) ) {
+		XMP_Error error ( kXMPErr_BadRDF, "Invalid property element name" );
+		this->errorCallback->NotifyClient ( kXMPErrSev_Recoverable, error );
+		return kPropForm_Invalid;
+	}
+	
+	// Only an emptyPropertyElt can have more than 3 attributes.
+	if ( xmlNode.attrs.size() > 3 ) return kPropForm_Empty;
+
+	// Look through the attributes for one that isn't rdf:ID or xml:lang, it will usually tell
+	// what we should be dealing with. The called routines must verify their specific syntax!
+
+	XML_cNodePos currAttr = xmlNode.attrs.begin();
+	XML_cNodePos endAttr  = xmlNode.attrs.end();
+	XMP_VarString * attrName = 0;
+
+	for ( ; currAttr != endAttr; ++currAttr ) {
+		attrName = &((*currAttr)->name);
+		if ( (*attrName != "xml:lang") && (*attrName != "rdf:ID") ) break;
+	}
+
+	if ( currAttr == endAttr ) return kPropForm_FromContent;
+
+	XMP_Assert ( attrName != 0 );
+	XMP_VarString& attrValue = (*currAttr)->value;
+
+	if ( *attrName == "rdf:datatype" ) {
+		return kPropForm_Literal;
+	} else if ( *attrName != "rdf:parseType" ) {
+		return kPropForm_Empty;
+	} else if ( attrValue == "Literal" ) {
+		return kPropForm_ParseTypeLiteral;
+	} else if ( attrValue == "Resource" ) {
+		return kPropForm_ParseTypeResource;
+	} else if ( attrValue == "Collection" ) {
+		return kPropForm_ParseTypeCollection;
+	} else {
+		return kPropForm_ParseTypeOther;
+	}
+
+}	// RDF_Parser::PropertyElementForm
+
 // =================================================================================================
 // RDF_Parser::ResourcePropertyElement
 // ===================================
@@ -994,10 +1102,54 @@ void RDF_Parser::PropertyElement ( XMP_Node * xmpParent, const XML_Node & xmlNod
 
 void RDF_Parser::ResourcePropertyElement ( XMP_Node * xmpParent, const XML_Node & xmlNode, bool isTopLevel )
 {
-	if ( isTopLevel && (xmlNode.name == "iX:changes") ) return;	// Strip old "punchcard" chaff.
+	XMP_Node * newCompound = this->StartResourceProperty ( xmpParent, xmlNode, isTopLevel );
+	if ( newCompound == 0 ) return;	// Ignore lower level errors.
+	
+	XML_cNodePos currChild = xmlNode.content.begin();
+	XML_cNodePos endChild  = xmlNode.content.end();
+
+	for ( ; currChild != endChild; ++currChild ) {
+		if ( ! (*currChild)->IsWhitespaceNode() ) break;
+	}
+	if ( currChild == endChild ) {
+		XMP_Error error ( kXMPErr_BadRDF, "Missing child of resource property element" );
+		this->errorCallback->NotifyClient ( kXMPErrSev_Recoverable, error );
+		return;
+	}
+	if ( (*currChild)->kind != kElemNode ) {
+		XMP_Error error ( kXMPErr_BadRDF, "Children of resource property element must be XML elements" );
+		this->errorCallback->NotifyClient ( kXMPErrSev_Recoverable, error );
+		return;
+	}
+
+	if ( ! this->SetResourceForm ( newCompound, **currChild ) ) return;
+
+	this->NodeElement ( newCompound, **currChild, kNotTopLevel );
+	this->EndResourceProperty ( newCompound );
+
+	for ( ++currChild; currChild != endChild; ++currChild ) {
+		if ( ! (*currChild)->IsWhitespaceNode() ) {
+			XMP_Error error ( kXMPErr_BadRDF, "Invalid child of resource property element" );
+			this->errorCallback->NotifyClient ( kXMPErrSev_Recoverable, error );
+			break;	// Don't bother looking for more trailing errors.
+		}
+	}
+
+}	// RDF_Parser::ResourcePropertyElement
+
+// =================================================================================================
+// RDF_Parser::StartResourceProperty
+// =================================
+//
+// Add the compound node for a resource property element and process its attributes. Returns null
+// if the element is to be ignored.
+
+XMP_Node * RDF_Parser::StartResourceProperty ( XMP_Node * xmpParent, const XML_Node & xmlNode, bool isTopLevel )
+{
+	if ( isTopLevel && (xmlNode.name == "iX:changes") ) return 0;	// Strip old "punchcard" chaff.
 	
 	XMP_Node * newCompound = this->AddChildNode ( xmpParent, xmlNode, "", isTopLevel );
-	if ( newCompound == 0 ) return;	// Ignore lower level errors.
+	if ( newCompound == 0 ) return 0;	// Ignore lower level errors.
 	
 	XML_cNodePos currAttr = xmlNode.attrs.begin();
 	XML_cNodePos endAttr  = xmlNode.attrs.end();
@@ -1014,63 +1166,64 @@ void RDF_Parser::ResourcePropertyElement ( XMP_Node * xmpParent, const XML_Node
 			continue;
 		}
 	}
-	
-	XML_cNodePos currChild = xmlNode.content.begin();
-	XML_cNodePos endChild  = xmlNode.content.end();
 
-	for ( ; currChild != endChild; ++currChild ) {
-		if ( ! (*currChild)->IsWhitespaceNode() ) break;
-	}
-	if ( currChild == endChild ) {
-		XMP_Error error ( kXMPErr_BadRDF, "Missing child of resource property element" );
-		this->errorCallback->NotifyClient ( kXMPErrSev_Recoverable, error );
-		return;
-	}
-	if ( (*currChild)->kind != kElemNode ) {
-		XMP_Error error ( kXMPErr_BadRDF, "Children of resource property element must be XML elements" );
-		this->errorCallback->NotifyClient ( kXMPErrSev_Recoverable, error );
-		return;
-	}
+	return newCompound;
+
+}	// RDF_Parser::StartResourceProperty
 
-	if ( (*currChild)->name == "rdf:Bag" ) {
+// =================================================================================================
+// RDF_Parser::SetResourceForm
+// ===========================
+//
+// Make the compound node an array or struct according to the name of the node element inside the
+// resource property element. Returns false if the node element is to be ignored.
+
+bool RDF_Parser::SetResourceForm ( XMP_Node * newCompound, const XML_Node & nodeElem )
+{
+
+	if ( nodeElem.name == "rdf:Bag" ) {
 		newCompound->options |= kXMP_PropValueIsArray;
-	} else if ( (*currChild)->name == "rdf:Seq" ) {
+	} else if ( nodeElem.name == "rdf:Seq" ) {
 		newCompound->options |= kXMP_PropValueIsArray | kXMP_PropArrayIsOrdered;
-	} else if ( (*currChild)->name == "rdf:Alt" ) {
+	} else if ( nodeElem.name == "rdf:Alt" ) {
 		newCompound->options |= kXMP_PropValueIsArray | kXMP_PropArrayIsOrdered | kXMP_PropArrayIsAlternate;
 	} else {
 		// This is the Typed Node case. Add an rdf:type qualifier with a URI value.
-		if ( (*currChild)->name != "rdf:Description" ) {
-			XMP_VarString typeName ( (*currChild)->ns );
-			size_t colonPos = (*currChild)->name.find_first_of(':');
+		if ( nodeElem.name != "rdf:Description" ) {
+			XMP_VarString typeName ( nodeElem.ns );
+			size_t colonPos = nodeElem.name.find_first_of(':');
 			if ( colonPos == XMP_VarString::npos ) {
 				XMP_Error error ( kXMPErr_BadXMP, "All XML elements must be in a namespace" );
 				this->errorCallback->NotifyClient ( kXMPErrSev_Recoverable, error );
-				return;
+				return false;
 			}
-			typeName.append ( (*currChild)->name, colonPos+1, XMP_VarString::npos );	// Append just the local name.
+			typeName.append ( nodeElem.name, colonPos+1, XMP_VarString::npos );	// Append just the local name.
 			XMP_Node * typeQual = this->AddQualifierNode ( newCompound, XMP_VarString("rdf:type"), typeName );
 			if ( typeQual != 0 ) typeQual->options |= kXMP_PropValueIsURI;
 		}
 		newCompound->options |= kXMP_PropValueIsStruct;
 	}
 
-	this->NodeElement ( newCompound, **currChild, kNotTopLevel );
+	return true;
+
+}	// RDF_Parser::SetResourceForm
+
+// =================================================================================================
+// RDF_Parser::EndResourceProperty
+// ===============================
+//
+// Clean up the compound node after its node element has been processed.
+
+void RDF_Parser::EndResourceProperty ( XMP_Node * newCompound )
+{
+
 	if ( newCompound->options & kRDF_HasValueElem ) {
 		this->FixupQualifiedNode ( newCompound );
 	} else if ( newCompound->options & kXMP_PropArrayIsAlternate ) {
 		DetectAltText ( newCompound );
 	}
 
-	for ( ++currChild; currChild != endChild; ++currChild ) {
-		if ( ! (*currChild)->IsWhitespaceNode() ) {
-			XMP_Error error ( kXMPErr_BadRDF, "Invalid child of resource property element" );
-			this->errorCallback->NotifyClient ( kXMPErrSev_Recoverable, error );
-			break;	// Don't bother looking for more trailing errors.
-		}
-	}
-
-}	// RDF_Parser::ResourcePropertyElement
+}	// RDF_Parser::EndResourceProperty
 
 // =================================================================================================
 // RDF_Parser::LiteralPropertyElement
@@ -1156,8 +1309,28 @@ void RDF_Parser::ParseTypeLiteralPropertyElement ( XMP_Node * xmpParent, const X
 
 void RDF_Parser::ParseTypeResourcePropertyElement ( XMP_Node * xmpParent, const XML_Node & xmlNode, bool isTopLevel )
 {
-	XMP_Node * newStruct = this->AddChildNode ( xmpParent, xmlNode, "", isTopLevel );
+	XMP_Node * newStruct = this->StartParseTypeResource ( xmpParent, xmlNode, isTopLevel );
 	if ( newStruct == 0 ) return;	// Ignore lower level errors.
+
+	this->PropertyElementList ( newStruct, xmlNode, kNotTopLevel );
+
+	if ( newStruct->options & kRDF_HasValueElem ) this->FixupQualifiedNode ( newStruct );
+	
+	// *** Need to look for arrays using rdf:Description and rdf:type.
+
+}	// RDF_Parser::ParseTypeResourcePropertyElement
+
+// =================================================================================================
+// RDF_Parser::StartParseTypeResource
+// ==================================
+//
+// Add the struct node for a parseType="Resource" property element and process its attributes.
+// Returns null if the element is to be ignored.
+
+XMP_Node * RDF_Parser::StartParseTypeResource ( XMP_Node * xmpParent, const XML_Node & xmlNode, bool isTopLevel )
+{
+	XMP_Node * newStruct = this->AddChildNode ( xmpParent, xmlNode, "", isTopLevel );
+	if ( newStruct == 0 ) return 0;	// Ignore lower level errors.
 	newStruct->options  |= kXMP_PropValueIsStruct;
 	
 	XML_cNodePos currAttr = xmlNode.attrs.begin();
@@ -1178,13 +1351,9 @@ void RDF_Parser::ParseTypeResourcePropertyElement ( XMP_Node * xmpParent, const
 		}
 	}
 
-	this->PropertyElementList ( newStruct, xmlNode, kNotTopLevel );
+	return newStruct;
 
-	if ( newStruct->options & kRDF_HasValueElem ) this->FixupQualifiedNode ( newStruct );
-	
-	// *** Need to look for arrays using rdf:Description and rdf:type.
-
-}	// RDF_Parser::ParseTypeResourcePropertyElement
+}	// RDF_Parser::StartParseTypeResource
 
 // =================================================================================================
 // RDF_Parser::ParseTypeCollectionPropertyElement
@@ -1398,10 +1567,749 @@ void XMPMeta::ProcessRDF ( const XML_Node & rdfNode, XMP_OptionBits options )
 {
 	IgnoreParam(options);
 	
-	RDF_Parser parser ( &this->errorCallback );
+	RDF_Parser parser ( &this->errorCallback, &this->parseNamespaces );
 	
 	parser.RDF ( &this->tree, rdfNode );
 
 }	// XMPMeta::ProcessRDF
 
 // =================================================================================================
+// =================================================================================================
+// Streaming RDF Parsing
+// =====================
+//
+// With kXMP_ParseStreaming the XML parser does not build an XML tree, the productions above are
+// driven directly by the parse events. Each open XML element inside an rdf:RDF element has a frame
+// telling what it is in the RDF grammar. The property element forms that depend on the content are
+// decided as the content arrives, the frame keeps the element's name, attributes, and text until
+// then. The literal and empty forms are then processed by the same code as for an XML tree.
+//
+// Every rdf:RDF element gets its own XMP tree, the choice among several is made as in PickBestRoot
+// when the parse is done. The recoverable errors are queued for each rdf:RDF element and only those
+// of the chosen one are reported, after all of the XML has been parsed.
+
+enum {	// The grammar state of an open XML element.
+	kStream_Skip			= 0,	// Ignored, along with all of its content.
+	kStream_NodeElementList	= 1,	// The rdf:RDF element.
+	kStream_PropertyList	= 2,	// A node element or parseType="Resource" property element.
+	kStream_Pending			= 3,	// A property element with only rdf:ID and xml:lang, the content decides the form.
+	kStream_Literal			= 4,	// A literal property element with rdf:datatype.
+	kStream_Empty			= 5,	// An empty property element, any content is an error.
+	kStream_ResourceNode	= 6,	// A resource property element, its node element is open.
+	kStream_ResourceTail	= 7		// A resource property element after its node element.
+};
+
+// -------------------------------------------------------------------------------------------------
+
+class RDF_ErrorQueue : public XMPMeta::ErrorCallbackInfo {
+public:
+
+	struct QueuedError {
+		XMP_ErrorSeverity severity;
+		XMP_Int32 cause;
+		XMP_VarString message;
+	};
+
+	mutable std::vector<QueuedError> errors;
+
+	RDF_ErrorQueue() { this->limit = 0; };	// ! Queue everything, the real limit applies when reported.
+
+	bool CanNotify() const { return true; };
+
+	bool ClientCallbackWrapper ( XMP_StringPtr /*filePath*/, XMP_ErrorSeverity severity, XMP_Int32 cause, XMP_StringPtr message ) const
+	{
+		this->errors.push_back ( QueuedError() );
+		this->errors.back().severity = severity;
+		this->errors.back().cause = cause;
+		this->errors.back().message = message;
+		return true;
+	};
+
+	void Report ( const XMPMeta::ErrorCallbackInfo & client ) const
+	{
+		for ( size_t i = 0, errorCount = this->errors.size(); i < errorCount; ++i ) {
+			XMP_Error error ( this->errors[i].cause, this->errors[i].message.c_str() );
+			client.NotifyClient ( this->errors[i].severity, error );
+		}
+	};
+
+};
+
+// -------------------------------------------------------------------------------------------------
+
+class RDF_StreamFrame {
+public:
+
+	XMP_Uns8   state;
+	bool       isTopLevel;
+	XMP_Node * xmpParent;	// The XMP parent of this element's property, or of the contained properties.
+	XMP_Node * xmpNode;		// The compound node of a resource or parseType="Resource" property element.
+	XML_Node   xmlNode;		// The element and content saved for a pending, literal, or empty property.
+	XML_Node   textNode;	// Reused for the first text content of xmlNode.
+
+	void SaveElement ( const XML_Node & elemNode );
+	void AppendContent ( XMP_Uns8 kind, XMP_StringPtr value, size_t len );
+	void ClearContent();
+
+	RDF_StreamFrame() : state(kStream_Skip), isTopLevel(false), xmpParent(0), xmpNode(0),
+	                    xmlNode(0,"",kElemNode), textNode(&xmlNode,"",kCDataNode) {};
+	~RDF_StreamFrame() { this->ClearContent(); };
+
+};
+
+// -------------------------------------------------------------------------------------------------
+
+void RDF_StreamFrame::SaveElement ( const XML_Node & elemNode )
+{
+	this->xmlNode.ns = elemNode.ns;
+	this->xmlNode.name = elemNode.name;
+	this->xmlNode.nsPrefixLen = elemNode.nsPrefixLen;
+
+	size_t attrCount = elemNode.attrs.size();
+	while ( this->xmlNode.attrs.size() > attrCount ) {
+		delete this->xmlNode.attrs.back();
+		this->xmlNode.attrs.pop_back();
+	}
+	while ( this->xmlNode.attrs.size() < attrCount ) {
+		this->xmlNode.attrs.push_back ( new XML_Node ( &this->xmlNode, "", kAttrNode ) );
+	}
+
+	for ( size_t attrNum = 0; attrNum < attrCount; ++attrNum ) {
+		const XML_Node * srcAttr = elemNode.attrs[attrNum];
+		XML_Node * savedAttr = this->xmlNode.attrs[attrNum];
+		savedAttr->ns = srcAttr->ns;
+		savedAttr->name = srcAttr->name;
+		savedAttr->value = srcAttr->value;
+		savedAttr->nsPrefixLen = srcAttr->nsPrefixLen;
+	}
+
+	this->ClearContent();
+
+}	// RDF_StreamFrame::SaveElement
+
+// -------------------------------------------------------------------------------------------------
+//
+// Adjacent text is merged into one node, that does not matter to the productions that look at the
+// content of a saved element.
+
+void RDF_StreamFrame::AppendContent ( XMP_Uns8 kind, XMP_StringPtr value, size_t len )
+{
+	XML_NodeVector & content = this->xmlNode.content;
+
+	if ( kind == kCDataNode ) {
+		if ( (! content.empty()) && (content.back()->kind == kCDataNode) ) {
+			content.back()->value.append ( value, len );
+			return;
+		}
+		if ( content.empty() ) {
+			this->textNode.value.assign ( value, len );
+			content.push_back ( &this->textNode );
+			return;
+		}
+	}
+
+	XML_Node * newNode = new XML_Node ( &this->xmlNode, "", kind );
+	newNode->value.assign ( value, len );
+	content.push_back ( newNode );
+
+}	// RDF_StreamFrame::AppendContent
+
+// -------------------------------------------------------------------------------------------------
+
+void RDF_StreamFrame::ClearContent()
+{
+	XML_NodeVector & content = this->xmlNode.content;
+
+	for ( size_t i = 0, limit = content.size(); i < limit; ++i ) {
+		if ( content[i] != &this->textNode ) delete content[i];
+	}
+	content.clear();
+
+}	// RDF_StreamFrame::ClearContent
+
+// =================================================================================================
+// RDF_StreamRoot
+// ==============
+//
+// The streaming recognizer for one rdf:RDF element and its XMP tree. The frames are kept for reuse,
+// depth is the number of open elements including the rdf:RDF element.
+
+class RDF_StreamRoot : public RDF_Parser {
+public:
+
+	RDF_ErrorQueue errorQueue;
+	XMP_Node tree;
+
+	void StartElement ( const XML_Node & elemNode );
+	void EndElement();
+	void Content ( XMP_Uns8 kind, XMP_StringPtr value, size_t len );
+
+	bool IsOpen() const { return (this->depth > 0); };
+
+	RDF_StreamRoot ( const XML_Node & rdfNode, const std::vector<XMP_VarString> * ns );
+	~RDF_StreamRoot();
+
+private:
+
+	std::vector<RDF_StreamFrame*> frames;
+	size_t depth;
+
+	RDF_StreamFrame * PushFrame ( XMP_Uns8 state, bool isTopLevel, XMP_Node * xmpParent );
+	void StartPropertyElement ( const RDF_StreamFrame & parent, const XML_Node & elemNode );
+	void StartResourceNode ( RDF_StreamFrame * frame, const XML_Node * nodeElem );
+	void ContentError ( XMP_StringPtr message );
+
+	RDF_StreamRoot ( const RDF_StreamRoot & );	// ! Hidden on purpose.
+	void operator= ( const RDF_StreamRoot & );
+
+};
+
+// -------------------------------------------------------------------------------------------------
+
+RDF_StreamRoot::RDF_StreamRoot ( const XML_Node & rdfNode, const std::vector<XMP_VarString> * ns )
+	: RDF_Parser(&errorQueue,ns), tree(0,"",0), depth(0)
+{
+
+	this->RDF ( &this->tree, rdfNode );	// ! Checks the attributes, the content is still empty.
+	this->PushFrame ( kStream_NodeElementList, kIsTopLevel, &this->tree );
+
+}	// RDF_StreamRoot::RDF_StreamRoot
+
+// -------------------------------------------------------------------------------------------------
+
+RDF_StreamRoot::~RDF_StreamRoot()
+{
+
+	for ( size_t i = 0, limit = this->frames.size(); i < limit; ++i ) delete this->frames[i];
+
+}	// RDF_StreamRoot::~RDF_StreamRoot
+
+// -------------------------------------------------------------------------------------------------
+
+RDF_StreamFrame * RDF_StreamRoot::PushFrame ( XMP_Uns8 state, bool isTopLevel, XMP_Node * xmpParent )
+{
+	if ( this->depth == this->frames.size() ) this->frames.push_back ( new RDF_StreamFrame() );
+	RDF_StreamFrame * frame = this->frames[this->depth];
+	++this->depth;
+
+	frame->state = state;
+	frame->isTopLevel = isTopLevel;
+	frame->xmpParent = xmpParent;
+	frame->xmpNode = 0;
+
+	return frame;
+
+}	// RDF_StreamRoot::PushFrame
+
+// -------------------------------------------------------------------------------------------------
+
+void RDF_StreamRoot::ContentError ( XMP_StringPtr message )
+{
+	XMP_Error error ( kXMPErr_BadRDF, message );
+	this->errorCallback->NotifyClient ( kXMPErrSev_Recoverable, error );
+}
+
+// -------------------------------------------------------------------------------------------------
+// RDF_StreamRoot::StartElement
+// ----------------------------
+
+void RDF_StreamRoot::StartElement ( const XML_Node & elemNode )
+{
+	XMP_Assert ( this->depth > 0 );
+	RDF_StreamFrame * parent = this->frames[this->depth-1];
+
+	switch ( parent->state ) {
+
+		case kStream_NodeElementList :
+			if ( this->StartNodeElement ( parent->xmpParent, elemNode, kIsTopLevel ) ) {
+				this->PushFrame ( kStream_PropertyList, kIsTopLevel, parent->xmpParent );
+			} else {
+				this->PushFrame ( kStream_Skip, kNotTopLevel, 0 );
+			}
+			break;
+
+		case kStream_PropertyList :
+			this->StartPropertyElement ( *parent, elemNode );
+			break;
+
+		case kStream_Pending :
+			this->StartResourceNode ( parent, &elemNode );	// ! An element child makes it a resource property.
+			break;
+
+		case kStream_Literal :
+		case kStream_Empty :
+			parent->AppendContent ( kElemNode, "", 0 );	// The production reports the error.
+			this->PushFrame ( kStream_Skip, kNotTopLevel, 0 );
+			break;
+
+		case kStream_ResourceTail :
+			this->ContentError ( "Invalid child of resource property element" );
+			parent->state = kStream_Skip;
+			this->PushFrame ( kStream_Skip, kNotTopLevel, 0 );
+			break;
+
+		default :
+			XMP_Assert ( parent->state == kStream_Skip );
+			this->PushFrame ( kStream_Skip, kNotTopLevel, 0 );
+			break;
+
+	}
+
+}	// RDF_StreamRoot::StartElement
+
+// -------------------------------------------------------------------------------------------------
+// RDF_StreamRoot::StartPropertyElement
+// ------------------------------------
+
+void RDF_StreamRoot::StartPropertyElement ( const RDF_StreamFrame & parent, const XML_Node & elemNode )
+{
+	RDF_StreamFrame * frame = 0;
+	XMP_Node * newStruct = 0;
+
+	if ( this->IsSkippedProperty ( elemNode, parent.isTopLevel ) ) {
+		this->PushFrame ( kStream_Skip, kNotTopLevel, 0 );	// ! Nothing inside is saved or checked.
+		return;
+	}
+
+	switch ( this->PropertyElementForm ( elemNode ) ) {
+
+		case kPropForm_Empty :
+			frame = this->PushFrame ( kStream_Empty, parent.isTopLevel, parent.xmpParent );
+			frame->SaveElement ( elemNode );
+			break;
+
+		case kPropForm_Literal :
+			frame = this->PushFrame ( kStream_Literal, parent.isTopLevel, parent.xmpParent );
+			frame->SaveElement ( elemNode );
+			break;
+
+		case kPropForm_FromContent :
+			frame = this->PushFrame ( kStream_Pending, parent.isTopLevel, parent.xmpParent );
+			frame->SaveElement ( elemNode );
+			break;
+
+		case kPropForm_ParseTypeResource :
+			newStruct = this->StartParseTypeResource ( parent.xmpParent, elemNode, parent.isTopLevel );
+			if ( newStruct == 0 ) {
+				this->PushFrame ( kStream_Skip, kNotTopLevel, 0 );
+			} else {
+				frame = this->PushFrame ( kStream_PropertyList, kNotTopLevel, newStruct );
+				frame->xmpNode = newStruct;
+			}
+			break;
+
+		case kPropForm_ParseTypeLiteral :
+			this->ParseTypeLiteralPropertyElement ( parent.xmpParent, elemNode, parent.isTopLevel );
+			this->PushFrame ( kStream_Skip, kNotTopLevel, 0 );
+			break;
+
+		case kPropForm_ParseTypeCollection :
+			this->ParseTypeCollectionPropertyElement ( parent.xmpParent, elemNode, parent.isTopLevel );
+			this->PushFrame ( kStream_Skip, kNotTopLevel, 0 );
+			break;
+
+		case kPropForm_ParseTypeOther :
+			this->ParseTypeOtherPropertyElement ( parent.xmpParent, elemNode, parent.isTopLevel );
+			this->PushFrame ( kStream_Skip, kNotTopLevel, 0 );
+			break;
+
+		default :	// The invalid name has been reported.
+			this->PushFrame ( kStream_Skip, kNotTopLevel, 0 );
+			break;
+
+	}
+
+}	// RDF_StreamRoot::StartPropertyElement
+
+// -------------------------------------------------------------------------------------------------
+// RDF_StreamRoot::StartResourceNode
+// ---------------------------------
+//
+// A pending property element is a resource property element, the first element or PI in its content
+// tells. The node element is null for a PI, which is an error as is any text other than whitespace.
+
+void RDF_StreamRoot::StartResourceNode ( RDF_StreamFrame * frame, const XML_Node * nodeElem )
+{
+	XMP_Assert ( frame->state == kStream_Pending );
+	const XML_NodeVector & content = frame->xmlNode.content;
+
+	bool isElement = (nodeElem != 0);
+	for ( size_t i = 0, limit = content.size(); i < limit; ++i ) {
+		if ( ! content[i]->IsWhitespaceNode() ) isElement = false;
+	}
+
+	frame->state = kStream_Skip;	// Until all of the checks pass.
+	XMP_Node * newCompound = this->StartResourceProperty ( frame->xmpParent, frame->xmlNode, frame->isTopLevel );
+	frame->ClearContent();
+
+	if ( newCompound != 0 ) {
+		if ( ! isElement ) {
+			this->ContentError ( "Children of resource property element must be XML elements" );
+		} else if ( this->SetResourceForm ( newCompound, *nodeElem ) ) {
+			frame->xmpNode = newCompound;
+			frame->state = kStream_ResourceNode;
+			if ( this->StartNodeElement ( newCompound, *nodeElem, kNotTopLevel ) ) {
+				this->PushFrame ( kStream_PropertyList, kNotTopLevel, newCompound );
+				return;
+			}
+		}
+	}
+
+	if ( nodeElem != 0 ) this->PushFrame ( kStream_Skip, kNotTopLevel, 0 );
+
+}	// RDF_StreamRoot::StartResourceNode
+
+// -------------------------------------------------------------------------------------------------
+// RDF_StreamRoot::EndElement
+// --------------------------
+
+void RDF_StreamRoot::EndElement()
+{
+	XMP_Assert ( this->depth > 0 );
+	RDF_StreamFrame * frame = this->frames[this->depth-1];
+
+	switch ( frame->state ) {
+
+		case kStream_PropertyList :
+			if ( (frame->xmpNode != 0) && (frame->xmpNode->options & kRDF_HasValueElem) ) {
+				this->FixupQualifiedNode ( frame->xmpNode );	// The end of a parseType="Resource" property.
+			}
+			break;
+
+		case kStream_Pending :
+			if ( frame->xmlNode.content.empty() ) {
+				this->EmptyPropertyElement ( frame->xmpParent, frame->xmlNode, frame->isTopLevel );
+			} else {
+				this->LiteralPropertyElement ( frame->xmpParent, frame->xmlNode, frame->isTopLevel );
+			}
+			break;
+
+		case kStream_Literal :
+			this->LiteralPropertyElement ( frame->xmpParent, frame->xmlNode, frame->isTopLevel );
+			break;
+
+		case kStream_Empty :
+			this->EmptyPropertyElement ( frame->xmpParent, frame->xmlNode, frame->isTopLevel );
+			break;
+
+		default :
+			break;
+
+	}
+
+	frame->ClearContent();
+	--this->depth;
+
+	if ( this->depth > 0 ) {
+		RDF_StreamFrame * parent = this->frames[this->depth-1];
+		if ( parent->state == kStream_ResourceNode ) {
+			this->EndResourceProperty ( parent->xmpNode );
+			parent->state = kStream_ResourceTail;
+		}
+	}
+
+}	// RDF_StreamRoot::EndElement
+
+// -------------------------------------------------------------------------------------------------
+// RDF_StreamRoot::Content
+// -----------------------
+//
+// Text or an XMP packet PI within the open element.
+
+void RDF_StreamRoot::Content ( XMP_Uns8 kind, XMP_StringPtr value, size_t len )
+{
+	XMP_Assert ( this->depth > 0 );
+	RDF_StreamFrame * frame = this->frames[this->depth-1];
+
+	bool isWhitespace = (kind == kCDataNode);
+	for ( size_t i = 0; isWhitespace && (i < len); ++i ) isWhitespace = IsWhitespaceChar ( value[i] );
+
+	switch ( frame->state ) {
+
+		case kStream_NodeElementList :
+			if ( ! isWhitespace ) {
+				XML_Node badNode ( 0, ((kind == kPINode) ? "xpacket" : ""), kind );
+				(void) this->StartNodeElement ( frame->xmpParent, badNode, kIsTopLevel );	// Reports the error.
+			}
+			break;
+
+		case kStream_PropertyList :
+			if ( ! isWhitespace ) this->ContentError ( "Expected property element node not found" );
+			break;
+
+		case kStream_Pending :
+			frame->AppendContent ( kind, value, len );
+			if ( kind == kPINode ) this->StartResourceNode ( frame, 0 );
+			break;
+
+		case kStream_Literal :
+		case kStream_Empty :
+			frame->AppendContent ( kind, value, len );
+			break;
+
+		case kStream_ResourceTail :
+			if ( ! isWhitespace ) {
+				this->ContentError ( "Invalid child of resource property element" );
+				frame->state = kStream_Skip;
+			}
+			break;
+
+		default :
+			break;
+
+	}
+
+}	// RDF_StreamRoot::Content
+
+// =================================================================================================
+// RDF_StreamParser
+// ================
+//
+// The event receiver given to the XML parser. It passes the events to the open rdf:RDF elements, and
+// keeps a skeleton of the root candidates and the elements containing them for choosing the root.
+
+class RDF_StreamParser : public XML_EventReceiver {
+public:
+
+	void StartElement ( const XML_Node & elemNode );
+	void EndElement();
+	void CharacterData ( XMP_StringPtr cData, size_t len );
+	void ProcessingInstruction ( XMP_StringPtr target, XMP_StringPtr data );
+
+	RDF_StreamRoot * FindRoot ( XMP_OptionBits options );
+
+	RDF_StreamParser ( const std::vector<XMP_VarString> * ns );
+	virtual ~RDF_StreamParser();
+
+private:
+
+	enum { kOtherCandidate = 0, kXMPMetaCandidate = 1, kRDFCandidate = 2 };
+
+	struct RootCandidate {
+		XMP_Uns8 kind;
+		size_t parent;
+		RDF_StreamRoot * root;
+		std::vector<size_t> children;
+	};
+
+	static const size_t kNoCandidate = size_t(-1);
+
+	const std::vector<XMP_VarString> * parseNamespaces;
+	std::vector<RDF_StreamRoot*> roots;
+	std::vector<RDF_StreamRoot*> openRoots;
+	std::vector<RootCandidate> candidates;	// The document root is the first.
+	std::vector<size_t> openElements;		// The candidate for each open element, if it has one.
+
+	size_t AddCandidate ( XMP_Uns8 kind, size_t parent );
+	size_t PickBestRoot ( size_t parent, XMP_OptionBits options ) const;
+
+};
+
+// -------------------------------------------------------------------------------------------------
+
+RDF_StreamParser::RDF_StreamParser ( const std::vector<XMP_VarString> * ns )
+	: parseNamespaces(ns)
+{
+
+	this->AddCandidate ( kOtherCandidate, kNoCandidate );
+
+}	// RDF_StreamParser::RDF_StreamParser
+
+// -------------------------------------------------------------------------------------------------
+
+RDF_StreamParser::~RDF_StreamParser()
+{
+
+	for ( size_t i = 0, limit = this->roots.size(); i < limit; ++i ) delete this->roots[i];
+
+}	// RDF_StreamParser::~RDF_StreamParser
+
+// -------------------------------------------------------------------------------------------------
+
+size_t RDF_StreamParser::AddCandidate ( XMP_Uns8 kind, size_t parent )
+{
+	size_t index = this->candidates.size();
+
+	this->candidates.push_back ( RootCandidate() );
+	this->candidates.back().kind = kind;
+	this->candidates.back().parent = parent;
+	this->candidates.back().root = 0;
+	if ( parent != kNoCandidate ) this->candidates[parent].children.push_back ( index );
+
+	return index;
+
+}	// RDF_StreamParser::AddCandidate
+
+// -------------------------------------------------------------------------------------------------
+
+void RDF_StreamParser::StartElement ( const XML_Node & elemNode )
+{
+	XMP_Uns8 kind = kOtherCandidate;
+	if ( (elemNode.name == "x:xmpmeta") || (elemNode.name == "x:xapmeta") ) {
+		kind = kXMPMetaCandidate;
+	} else if ( elemNode.name == "rdf:RDF" ) {
+		kind = kRDFCandidate;
+	}
+
+	for ( size_t i = 0, limit = this->openRoots.size(); i < limit; ++i ) {
+		this->openRoots[i]->StartElement ( elemNode );
+	}
+
+	size_t candidate = kNoCandidate;
+
+	if ( kind != kOtherCandidate ) {
+
+		// Make candidate skeleton entries for the open elements that contain this one.
+		size_t parent = 0;
+		for ( size_t i = 0, limit = this->openElements.size(); i < limit; ++i ) {
+			if ( this->openElements[i] == kNoCandidate ) this->openElements[i] = this->AddCandidate ( kOtherCandidate, parent );
+			parent = this->openElements[i];
+		}
+
+		candidate = this->AddCandidate ( kind, parent );
+
+		if ( kind == kRDFCandidate ) {
+			RDF_StreamRoot * newRoot = new RDF_StreamRoot ( elemNode, this->parseNamespaces );
+			this->roots.push_back ( newRoot );
+			this->openRoots.push_back ( newRoot );
+			this->candidates[candidate].root = newRoot;
+		}
+
+	}
+
+	this->openElements.push_back ( candidate );
+
+}	// RDF_StreamParser::StartElement
+
+// -------------------------------------------------------------------------------------------------
+
+void RDF_StreamParser::EndElement()
+{
+
+	for ( size_t i = 0, limit = this->openRoots.size(); i < limit; ++i ) {
+		this->openRoots[i]->EndElement();
+	}
+
+	if ( (! this->openRoots.empty()) && (! this->openRoots.back()->IsOpen()) ) this->openRoots.pop_back();
+	this->openElements.pop_back();
+
+}	// RDF_StreamParser::EndElement
+
+// -------------------------------------------------------------------------------------------------
+
+void RDF_StreamParser::CharacterData ( XMP_StringPtr cData, size_t len )
+{
+
+	for ( size_t i = 0, limit = this->openRoots.size(); i < limit; ++i ) {
+		this->openRoots[i]->Content ( kCDataNode, cData, len );
+	}
+
+}	// RDF_StreamParser::CharacterData
+
+// -------------------------------------------------------------------------------------------------
+
+void RDF_StreamParser::ProcessingInstruction ( XMP_StringPtr /*target*/, XMP_StringPtr data )
+{
+
+	for ( size_t i = 0, limit = this->openRoots.size(); i < limit; ++i ) {
+		this->openRoots[i]->Content ( kPINode, data, strlen ( data ) );
+	}
+
+}	// RDF_StreamParser::ProcessingInstruction
+
+// -------------------------------------------------------------------------------------------------
+//
+// The same choice as PickBestRoot in XMPMeta-Parse.cpp. The skeleton has only the candidates and
+// the elements containing them, the other elements can't change the outcome.
+
+size_t RDF_StreamParser::PickBestRoot ( size_t parent, XMP_OptionBits options ) const
+{
+	const std::vector<size_t> & children = this->candidates[parent].children;
+
+	for ( size_t i = 0, limit = children.size(); i < limit; ++i ) {
+		if ( this->candidates[children[i]].kind == kXMPMetaCandidate ) return this->PickBestRoot ( children[i], 0 );
+	}
+
+	if ( ! (options & kXMP_RequireXMPMeta) ) {
+		for ( size_t i = 0, limit = children.size(); i < limit; ++i ) {
+			if ( this->candidates[children[i]].kind == kRDFCandidate ) return children[i];
+		}
+	}
+
+	for ( size_t i = 0, limit = children.size(); i < limit; ++i ) {
+		size_t found = this->PickBestRoot ( children[i], options );
+		if ( found != kNoCandidate ) return found;
+	}
+
+	return kNoCandidate;
+
+}	// RDF_StreamParser::PickBestRoot
+
+// -------------------------------------------------------------------------------------------------
+//
+// Close whatever is still open after an XML parsing error, then choose the root as FindRootNode in
+// XMPMeta-Parse.cpp does.
+
+RDF_StreamRoot * RDF_StreamParser::FindRoot ( XMP_OptionBits options )
+{
+
+	while ( ! this->openElements.empty() ) this->EndElement();
+	if ( this->roots.empty() ) return 0;
+
+	size_t found = kNoCandidate;
+	if ( this->roots.size() == 1 ) {
+		for ( found = 0; this->candidates[found].root == 0; ++found ) {}
+	} else {
+		found = this->PickBestRoot ( 0, options );
+		if ( found == kNoCandidate ) return 0;
+	}
+
+	if ( options & kXMP_RequireXMPMeta ) {
+		if ( this->candidates[this->candidates[found].parent].kind != kXMPMetaCandidate ) return 0;
+	}
+
+	return this->candidates[found].root;
+
+}	// RDF_StreamParser::FindRoot
+
+// =================================================================================================
+// XMPMeta::StartRDFStream
+// =======================
+//
+// Have the XML parser pass its events to the streaming RDF recognizer instead of building a tree.
+
+void XMPMeta::StartRDFStream()
+{
+
+	XMP_Assert ( (this->xmlParser != 0) && (this->xmlParser->eventReceiver == 0) );
+	this->xmlParser->eventReceiver = new RDF_StreamParser ( &this->parseNamespaces );
+
+}	// XMPMeta::StartRDFStream
+
+// =================================================================================================
+// XMPMeta::ProcessRDFStream
+// =========================
+//
+// Move the XMP tree of the chosen rdf:RDF element into this object and report its errors. Returns
+// false if there is no acceptable rdf:RDF element.
+
+bool XMPMeta::ProcessRDFStream ( XMP_OptionBits options )
+{
+	RDF_StreamParser * stream = static_cast<RDF_StreamParser*> ( this->xmlParser->eventReceiver );
+
+	RDF_StreamRoot * root = stream->FindRoot ( options );
+	if ( root == 0 ) return false;
+
+	this->tree.name.swap ( root->tree.name );
+	this->tree.options |= root->tree.options;
+	this->tree.children.swap ( root->tree.children );
+	for ( size_t schemaNum = 0, schemaLim = this->tree.children.size(); schemaNum < schemaLim; ++schemaNum ) {
+		this->tree.children[schemaNum]->parent = &this->tree;
+	}
+
+	root->errorQueue.Report ( this->errorCallback );
+	return true;
+
+}	// XMPMeta::ProcessRDFStream
+
+// =================================================================================================
@@ -1175,6 +1175,44 @@ WXMPMeta_ParseFromBuffer_1 ( XMPMetaRef		xmpObjRef,
 
 // -------------------------------------------------------------------------------------------------
 
+void
+WXMPMeta_SetParseNamespaces_1 ( XMPMetaRef			  xmpObjRef,
+								const XMP_StringPtr * namespaceURIs,
+								XMP_Index			  uriCount,
+								WXMP_Result *		  wResult )
+{
+	XMP_ENTER_ObjWrite ( XMPMeta, "WXMPMeta_SetParseNamespaces_1" )
+
+		thiz->SetParseNamespaces ( namespaceURIs, uriCount );
+		
+	XMP_EXIT
+}
+
+// -------------------------------------------------------------------------------------------------
+
+/* class static */ void
+WXMPMeta_ParseBatch_1 ( XMP_Index			  count,
+						const XMP_StringPtr * buffers,
+						const XMP_StringLen * sizes,
+						XMP_OptionBits		  options,
+						XMPMetaRef *		  xmpRefs,
+						XMP_Int32 *			  errorIDs,
+						WXMP_Result *		  wResult )
+{
+	XMP_ENTER_Static ( "WXMPMeta_ParseBatch_1" )
+
+		if ( (xmpRefs == 0) && (count > 0) ) XMP_Throw ( "Null batch array", kXMPErr_BadParam );
+
+		std::vector<XMPMeta*> xmpObjs;
+		for ( XMP_Index i = 0; i < count; ++i ) xmpObjs.push_back ( WtoXMPMeta_Ptr ( xmpRefs[i] ) );
+
+		XMPMeta::ParseBatch ( count, buffers, sizes, options, (count > 0 ? &xmpObjs[0] : 0), errorIDs );
+
+	XMP_EXIT
+}
+
+// -------------------------------------------------------------------------------------------------
+
 void
 WXMPMeta_SerializeToBuffer_1 ( XMPMetaRef	  xmpObjRef,
 							   void *         pktString,
@@ -121,6 +121,207 @@ WXMP_Result 		void_wResult;
 	
 #endif
 
+// =================================================================================================
+// XMP_Node allocation
+// ===================
+//
+// Deleted XMP_Node objects are kept on a per-thread free list and reused by the next new. Short lived
+// XMPMeta objects, the common case when parsing many files, then mostly recycle the node storage of
+// the previous ones instead of going through the heap for every node. The list is capped, and a
+// thread's list is freed when the thread exits.
+
+static const size_t kMaxCachedNodes = 4096;
+
+// ! The list state is trivially destructible, so it stays readable while other thread_local objects
+// ! are destroyed during thread exit. Only the reaper has a destructor, it is touched when the list
+// ! becomes non-empty and never after it ran.
+
+static thread_local void * sNodeFreeList = 0;	// The first word of a free node links to the next one.
+static thread_local size_t sNodeFreeCount = 0;
+static thread_local bool   sNodeCacheClosed = false;
+
+class XMP_NodeCacheReaper {
+public:
+
+	bool armed;
+
+	XMP_NodeCacheReaper() : armed(false) {};
+
+	~XMP_NodeCacheReaper()
+	{
+		while ( sNodeFreeList != 0 ) {
+			void * next = *((void**)sNodeFreeList);
+			::operator delete ( sNodeFreeList );
+			sNodeFreeList = next;
+		}
+		sNodeFreeCount = 0;
+		sNodeCacheClosed = true;	// ! Nodes deleted later during thread exit go straight to the heap.
+	};
+
+};
+
+static thread_local XMP_NodeCacheReaper sNodeCacheReaper;
+
+void * XMP_Node::operator new ( size_t len )
+{
+	if ( (len == sizeof(XMP_Node)) && (sNodeFreeList != 0) ) {
+		void * node = sNodeFreeList;
+		sNodeFreeList = *((void**)node);
+		--sNodeFreeCount;
+		return node;
+	}
+
+	return ::operator new ( len );
+
+}	// XMP_Node::operator new
+
+void XMP_Node::operator delete ( void * ptr, size_t len )
+{
+	if ( ptr == 0 ) return;
+
+	if ( (len == sizeof(XMP_Node)) && (sNodeFreeCount < kMaxCachedNodes) && (! sNodeCacheClosed) ) {
+		if ( sNodeFreeList == 0 ) sNodeCacheReaper.armed = true;	// Make sure the list is freed at thread exit.
+		*((void**)ptr) = sNodeFreeList;
+		sNodeFreeList = ptr;
+		++sNodeFreeCount;
+		return;
+	}
+
+	::operator delete ( ptr );
+
+}	// XMP_Node::operator delete
+
+// =================================================================================================
+// XMP_NodeOffspring name index
+// ============================
+
+static inline XMP_Uns32 HashNodeName ( XMP_StringPtr name, size_t nameLen )
+{
+	XMP_Uns32 hash = 2166136261UL;	// FNV-1a
+	for ( size_t i = 0; i < nameLen; ++i ) hash = (hash ^ (XMP_Uns8)name[i]) * 16777619UL;
+	return hash;
+}
+
+XMP_Index XMP_NodeOffspring::Lookup ( XMP_StringPtr name, size_t nameLen ) const
+{
+	XMP_Index found = -1;
+
+	if ( this->indexCurrent ) {
+
+		const std::vector<XMP_Uns32> & slots = *this->nameIndex;
+		const size_t mask = slots.size() - 1;
+		for ( size_t slot = HashNodeName ( name, nameLen ) & mask; slots[slot] != 0; slot = (slot + 1) & mask ) {
+			size_t pos = slots[slot] - 1;
+			if ( XMP_NameMatch ( (*this)[pos]->name, name, nameLen ) ) {
+				found = (XMP_Index)pos;
+				break;
+			}
+		}
+
+		#if XMP_DebugBuild	// Make sure the index has not missed a change.
+			XMP_Index checkPos = -1;
+			for ( size_t pos = 0, posLim = this->size(); pos != posLim; ++pos ) {
+				if ( XMP_NameMatch ( (*this)[pos]->name, name, nameLen ) ) { checkPos = (XMP_Index)pos; break; }
+			}
+			XMP_Assert ( found == checkPos );
+		#endif
+
+	} else {
+
+		for ( size_t pos = 0, posLim = this->size(); pos != posLim; ++pos ) {
+			if ( XMP_NameMatch ( (*this)[pos]->name, name, nameLen ) ) {
+				found = (XMP_Index)pos;
+				break;
+			}
+		}
+
+	}
+
+	return found;
+
+}	// XMP_NodeOffspring::Lookup
+
+// -------------------------------------------------------------------------------------------------
+
+void XMP_NodeOffspring::UpdateIndex()
+{
+	if ( this->indexCurrent || (this->size() < kMinIndexedSize) ) return;
+
+	size_t slotCount = 64;
+	while ( slotCount < (4 * this->size()) ) slotCount *= 2;	// Rebuild at half full, see AddToIndex.
+
+	if ( this->nameIndex == 0 ) this->nameIndex = new std::vector<XMP_Uns32>;
+	this->nameIndex->assign ( slotCount, 0 );
+	this->indexCurrent = true;
+
+	for ( size_t pos = 0, posLim = this->size(); pos != posLim; ++pos ) this->AddToIndex ( pos );
+
+}	// XMP_NodeOffspring::UpdateIndex
+
+// -------------------------------------------------------------------------------------------------
+
+void XMP_NodeOffspring::AddToIndex ( size_t pos )
+{
+	std::vector<XMP_Uns32> & slots = *this->nameIndex;
+
+	if ( (2 * (pos + 1)) > slots.size() ) {
+		this->indexCurrent = false;	// Too full, UpdateIndex will make a bigger one.
+		return;
+	}
+
+	const XMP_VarString & name = (*this)[pos]->name;
+	const size_t mask = slots.size() - 1;
+	size_t slot = HashNodeName ( name.c_str(), name.size() ) & mask;
+	while ( slots[slot] != 0 ) slot = (slot + 1) & mask;
+	slots[slot] = (XMP_Uns32)(pos + 1);
+
+}	// XMP_NodeOffspring::AddToIndex
+
+// -------------------------------------------------------------------------------------------------
+
+void XMP_NodeOffspring::swap ( XMP_NodeOffspring & other )
+{
+	NodeVector::swap ( other );
+	std::swap ( this->nameIndex, other.nameIndex );
+	std::swap ( this->indexCurrent, other.indexCurrent );
+
+}	// XMP_NodeOffspring::swap
+
+// =================================================================================================
+// Alias name filter
+// =================
+//
+// One bit per hash of a registered alias name. Nearly all names looked up during a parse or XPath
+// expansion are not aliases, a clear bit lets those skip the alias map search.
+
+static const size_t kAliasFilterBits = 1024;
+
+static XMP_Uns32 sAliasNameFilter [kAliasFilterBits/32];
+
+void ClearAliasNameFilter()
+{
+	memset ( sAliasNameFilter, 0, sizeof(sAliasNameFilter) );
+
+}	// ClearAliasNameFilter
+
+// -------------------------------------------------------------------------------------------------
+
+void AddAliasNameToFilter ( const XMP_VarString & aliasName )
+{
+	XMP_Uns32 bit = HashNodeName ( aliasName.c_str(), aliasName.size() ) & (kAliasFilterBits - 1);
+	sAliasNameFilter[bit >> 5] |= (1U << (bit & 31));
+
+}	// AddAliasNameToFilter
+
+// -------------------------------------------------------------------------------------------------
+
+bool IsRegisteredAlias ( const XMP_VarString & qualName )
+{
+	XMP_Uns32 bit = HashNodeName ( qualName.c_str(), qualName.size() ) & (kAliasFilterBits - 1);
+	if ( (sAliasNameFilter[bit >> 5] & (1U << (bit & 31))) == 0 ) return false;
+	return (sRegisteredAliasMap->find ( qualName ) != sRegisteredAliasMap->end());
+
+}	// IsRegisteredAlias
 
 // =================================================================================================
 // Local Utilities
@@ -667,7 +868,7 @@ ExpandXPath	( XMP_StringPtr			schemaNS,
 	VerifyXPathRoot ( schemaNS, currStep.c_str(), expandedXPath );
 
 	XMP_OptionBits stepFlags = kXMP_StructFieldStep;	
-	if ( sRegisteredAliasMap->find ( (*expandedXPath)[kRootPropStep].step ) != sRegisteredAliasMap->end() ) {
+	if ( IsRegisteredAlias ( (*expandedXPath)[kRootPropStep].step ) ) {
 		stepFlags |= kXMP_StepIsAlias;
 	}
 	(*expandedXPath)[kRootPropStep].options |= stepFlags;
@@ -811,14 +1012,12 @@ FindSchemaNode	( XMP_Node *		xmpTree,
 	
 	XMP_Assert ( xmpTree->parent == 0 );
 	
-	for ( size_t schemaNum = 0, schemaLim = xmpTree->children.size(); schemaNum != schemaLim; ++schemaNum ) {
-		XMP_Node * currSchema = xmpTree->children[schemaNum];
-		XMP_Assert ( currSchema->parent == xmpTree );
-		if ( currSchema->name == nsURI ) {
-			schemaNode = currSchema;
-			if ( ptrPos != 0 ) *ptrPos = xmpTree->children.begin() + schemaNum;
-			break;
-		}
+	if ( createNodes ) xmpTree->children.UpdateIndex();
+	XMP_Index schemaNum = xmpTree->children.Lookup ( nsURI, strlen ( nsURI ) );
+	if ( schemaNum >= 0 ) {
+		schemaNode = xmpTree->children[schemaNum];
+		XMP_Assert ( schemaNode->parent == xmpTree );
+		if ( ptrPos != 0 ) *ptrPos = xmpTree->children.begin() + schemaNum;
 	}
 	
 	if ( (schemaNode == 0) && createNodes ) {
@@ -894,14 +1093,12 @@ FindChildNode	( XMP_Node *		parent,
 		parent->options |= kXMP_PropValueIsStruct;
 	}
 	
-	for ( size_t childNum = 0, childLim = parent->children.size(); childNum != childLim; ++childNum ) {
-		XMP_Node * currChild = parent->children[childNum];
-		XMP_Assert ( currChild->parent == parent );
-		if ( currChild->name == childName ) {
-			childNode = currChild;
-			if ( ptrPos != 0 ) *ptrPos = parent->children.begin() + childNum;
-			break;
-		}
+	if ( createNodes ) parent->children.UpdateIndex();
+	XMP_Index childNum = parent->children.Lookup ( childName, strlen ( childName ) );
+	if ( childNum >= 0 ) {
+		childNode = parent->children[childNum];
+		XMP_Assert ( childNode->parent == parent );
+		if ( ptrPos != 0 ) *ptrPos = parent->children.begin() + childNum;
 	}
 	
 	if ( (childNode == 0) && createNodes ) {
@@ -936,10 +1133,11 @@ FindQualifierNode	( XMP_Node *		parent,
 	
 	XMP_Assert ( *qualName != '?' );
 	
+	const size_t nameLen = strlen ( qualName );
 	for ( size_t qualNum = 0, qualLim = parent->qualifiers.size(); qualNum != qualLim; ++qualNum ) {
 		XMP_Node * currQual = parent->qualifiers[qualNum];
 		XMP_Assert ( currQual->parent == parent );
-		if ( currQual->name == qualName ) {
+		if ( XMP_NameMatch ( currQual->name, qualName, nameLen ) ) {
 			qualNode = currQual;
 			if ( ptrPos != 0 ) *ptrPos = parent->qualifiers.begin() + qualNum;
 			break;
@@ -1480,6 +1678,7 @@ void
 SortNamedNodes ( XMP_NodeOffspring & nodeVector )
 {
 	sort ( nodeVector.begin(), nodeVector.end(), Compare );
+	nodeVector.ResetIndex();
 }	// SortNamedNodes
 
 // =================================================================================================
@@ -39,7 +39,76 @@ class XPathStepInfo;
 
 typedef XMP_Node *	XMP_NodePtr;
 
-typedef std::vector<XMP_Node*>		XMP_NodeOffspring;
+// -------------------------------------------------------------------------------------------------
+// A node's children or qualifiers. A wide vector can also have a hashed index of the node names, used
+// by FindChildNode and FindSchemaNode. The index is only built by UpdateIndex, in code that has the
+// XMP object locked for writing, and Lookup uses it only while it is current. The vector is a private
+// base, so only the modifying functions declared here can change it: push_back keeps the index
+// current, the others make it stale. Writes through iterators or element references are not seen,
+// code that reorders or replaces nodes that way must call ResetIndex. Renaming a node in place is not
+// seen either, nodes are only renamed while being moved to a new parent.
+
+class XMP_NodeOffspring : private std::vector<XMP_Node*> {
+public:
+
+	typedef std::vector<XMP_Node*> NodeVector;
+
+	using NodeVector::value_type;
+	using NodeVector::size_type;
+	using NodeVector::reference;
+	using NodeVector::const_reference;
+	using NodeVector::iterator;
+	using NodeVector::const_iterator;
+	using NodeVector::reverse_iterator;
+	using NodeVector::const_reverse_iterator;
+
+	using NodeVector::begin;
+	using NodeVector::end;
+	using NodeVector::rbegin;
+	using NodeVector::rend;
+	using NodeVector::size;
+	using NodeVector::empty;
+	using NodeVector::operator[];
+	using NodeVector::at;
+	using NodeVector::front;
+	using NodeVector::back;
+	using NodeVector::reserve;
+	using NodeVector::capacity;
+
+	enum { kMinIndexedSize = 32 };
+
+	XMP_Index Lookup ( XMP_StringPtr name, size_t nameLen ) const;	// Position of the first match, or -1.
+	void UpdateIndex();
+	void ResetIndex() { this->indexCurrent = false; };
+
+	void push_back ( XMP_Node * const & node )
+		{ NodeVector::push_back ( node ); if ( this->indexCurrent ) this->AddToIndex ( this->size() - 1 ); };
+	void pop_back() { NodeVector::pop_back(); this->indexCurrent = false; };
+	iterator insert ( iterator pos, XMP_Node * const & node )
+		{ this->indexCurrent = false; return NodeVector::insert ( pos, node ); };
+	iterator erase ( iterator pos ) { this->indexCurrent = false; return NodeVector::erase ( pos ); };
+	iterator erase ( iterator first, iterator last )
+		{ this->indexCurrent = false; return NodeVector::erase ( first, last ); };
+	void clear() { NodeVector::clear(); this->indexCurrent = false; };
+	void resize ( size_type count ) { NodeVector::resize ( count ); this->indexCurrent = false; };
+	void swap ( XMP_NodeOffspring & other );
+
+	XMP_NodeOffspring() : nameIndex(0), indexCurrent(false) {};
+	XMP_NodeOffspring ( const XMP_NodeOffspring & other ) : NodeVector ( other ), nameIndex(0), indexCurrent(false) {};
+	XMP_NodeOffspring & operator= ( const XMP_NodeOffspring & other )
+		{ NodeVector::operator= ( other ); this->indexCurrent = false; return *this; };
+
+	~XMP_NodeOffspring() { delete this->nameIndex; };
+
+private:
+
+	void AddToIndex ( size_t pos );
+
+	std::vector<XMP_Uns32> * nameIndex;	// Open addressed hash table of position+1, 0 for an empty slot.
+	bool indexCurrent;
+
+};
+
 typedef XMP_NodeOffspring::iterator	XMP_NodePtrPos;
 
 typedef XMP_VarString::iterator			XMP_VarStringPos;
@@ -78,6 +147,10 @@ extern XMP_NamespaceTable * sRegisteredNamespaces;
 
 extern XMP_AliasMap * sRegisteredAliasMap;
 
+extern void ClearAliasNameFilter();
+extern void AddAliasNameToFilter ( const XMP_VarString & aliasName );
+extern bool IsRegisteredAlias ( const XMP_VarString & qualName );	// Filtered sRegisteredAliasMap lookup.
+
 extern XMP_ReadWriteLock * sDefaultNamespacePrefixMapLock;
 
 #define WtoXMPMeta_Ref(xmpRef)	(const XMPMeta &) (*((XMPMeta*)(xmpRef)))
@@ -103,6 +176,12 @@ extern WXMP_Result		void_wResult;
 #define XMP_LitNMatch(s,l,n)	(strncmp((s),(l),(n)) == 0)
 	// *** Use the above macros!
 
+static inline bool XMP_NameMatch ( const XMP_VarString & name, XMP_StringPtr str, size_t len )
+{
+	// Faster than name == str in search loops, the caller finds the length of str once.
+	return (name.size() == len) && (memcmp ( name.data(), str, len ) == 0);
+}
+
 #if XMP_WinBuild
 	#define snprintf _snprintf
 #endif
@@ -385,6 +464,9 @@ public:
 
 	void SetValue( XMP_StringPtr value );
 
+	static void * operator new ( size_t len );	// Recycles node storage, see XMPCore_Impl.cpp.
+	static void operator delete ( void * ptr, size_t len );
+
 	virtual ~XMP_Node() { RemoveChildren(); RemoveQualifiers(); };
 
 private:
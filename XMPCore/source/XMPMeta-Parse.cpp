@@ -20,6 +20,10 @@
 #include "source/ExpatAdapter.hpp"
 #define  STATIC_SAFE_API
 #include "source/SafeStringAPIs.h"
+#include "source/XMP_VectorScan.hpp"
+
+#include <atomic>
+#include <thread>
 
 #if XMP_DebugBuild
 	#include <iostream>
@@ -577,9 +581,8 @@ MigrateAudioCopyright ( XMPMeta * xmp, XMP_Node * dmCopyright )
 // qualifier. If repairs are needed, keep simple non-empty items by adding the xml:lang.
 
 static void
-RepairAltText ( XMP_Node & tree, XMP_StringPtr schemaNS, XMP_StringPtr arrayName )
+RepairAltText ( XMP_Node * schemaNode, XMP_StringPtr arrayName )
 {
-	XMP_Node * schemaNode = FindSchemaNode ( &tree, schemaNS, kXMP_ExistingOnly );
 	if ( schemaNode == 0 ) return;
 	
 	XMP_Node * arrayNode = FindChildNode ( schemaNode, arrayName, kXMP_ExistingOnly );
@@ -637,11 +640,29 @@ TouchUpDataModel ( XMPMeta * xmp, XMPMeta::ErrorCallbackInfo & /*errorCallback*/
 {
 	XMP_Node & tree = xmp->tree;
 	
-	// Do special case touch ups for certain schema.
-
-	XMP_Node * currSchema = 0;
+	// Do special case touch ups for certain schema. Find them all in one pass over the top level,
+	// most packets have none of them and the URI compares are the bulk of the work.
+
+	XMP_Node * exifSchema = 0;
+	XMP_Node * dmSchema = 0;
+	XMP_Node * dcSchema = 0;
+	XMP_Node * rightsSchema = 0;
+
+	for ( size_t schemaNum = 0, schemaLim = tree.children.size(); schemaNum < schemaLim; ++schemaNum ) {
+		XMP_Node * schemaNode = tree.children[schemaNum];
+		const XMP_VarString & schemaURI = schemaNode->name;
+		if ( schemaURI == kXMP_NS_EXIF ) {
+			exifSchema = schemaNode;
+		} else if ( schemaURI == kXMP_NS_DM ) {
+			dmSchema = schemaNode;
+		} else if ( schemaURI == kXMP_NS_DC ) {
+			dcSchema = schemaNode;
+		} else if ( schemaURI == kXMP_NS_XMP_Rights ) {
+			rightsSchema = schemaNode;
+		}
+	}
 
-	currSchema = FindSchemaNode ( &tree, kXMP_NS_EXIF, kXMP_ExistingOnly );
+	XMP_Node * currSchema = exifSchema;
 	if ( currSchema != 0 ) {
 
 		// Do a special case fix for exif:GPSTimeStamp.
@@ -667,15 +688,18 @@ TouchUpDataModel ( XMPMeta * xmp, XMPMeta::ErrorCallbackInfo & /*errorCallback*/
 
 	}
 
-	currSchema = FindSchemaNode ( &tree, kXMP_NS_DM, kXMP_ExistingOnly );
+	currSchema = dmSchema;
 	if ( currSchema != 0 ) {
 		// Do a special case migration of xmpDM:copyright to dc:rights['x-default']. Do this before
 		// the dc: touch up since it can affect the dc: schema.
 		XMP_Node * dmCopyright = FindChildNode ( currSchema, "xmpDM:copyright", kXMP_ExistingOnly );
-		if ( dmCopyright != 0 ) MigrateAudioCopyright ( xmp, dmCopyright );
+		if ( dmCopyright != 0 ) {
+			MigrateAudioCopyright ( xmp, dmCopyright );
+			dcSchema = FindSchemaNode ( &tree, kXMP_NS_DC, kXMP_ExistingOnly );	// The migration can create it.
+		}
 	}
 
-	currSchema = FindSchemaNode ( &tree, kXMP_NS_DC, kXMP_ExistingOnly );
+	currSchema = dcSchema;
 	if ( currSchema != 0 ) {
 		// Do a special case fix for dc:subject, make sure it is an unordered array.
 		XMP_Node * dcSubject = FindChildNode ( currSchema, "dc:subject", kXMP_ExistingOnly );
@@ -687,11 +711,11 @@ TouchUpDataModel ( XMPMeta * xmp, XMPMeta::ErrorCallbackInfo & /*errorCallback*/
 	
 	// Fix any broken AltText arrays that we know about.
 	
-	RepairAltText ( tree, kXMP_NS_DC, "dc:description" );	// ! Note inclusion of prefixes for direct node lookup!
-	RepairAltText ( tree, kXMP_NS_DC, "dc:rights" );
-	RepairAltText ( tree, kXMP_NS_DC, "dc:title" );
-	RepairAltText ( tree, kXMP_NS_XMP_Rights, "xmpRights:UsageTerms" );
-	RepairAltText ( tree, kXMP_NS_EXIF, "exif:UserComment" );
+	RepairAltText ( dcSchema, "dc:description" );	// ! Note inclusion of prefixes for direct node lookup!
+	RepairAltText ( dcSchema, "dc:rights" );
+	RepairAltText ( dcSchema, "dc:title" );
+	RepairAltText ( rightsSchema, "xmpRights:UsageTerms" );
+	RepairAltText ( exifSchema, "exif:UserComment" );
 	
 	// Tweak old XMP: Move an instance ID from rdf:about to the xmpMM:InstanceID property. An old
 	// instance ID usually looks like "uuid:bac965c4-9d87-11d9-9a30-000d936b79c4", plus InDesign
@@ -914,6 +938,164 @@ CountControlEscape ( const XMP_Uns8 * escStart, const XMP_Uns8 * bufEnd )
 }	// CountControlEscape
 
 
+// -------------------------------------------------------------------------------------------------
+// SkipValidUTF8
+// -------------
+//
+// Skip whole blocks of input that ProcessUTF8Portion would pass to Expat unchanged, returning the
+// start of the first character that needs the byte at a time checks. The blocks must be regular
+// ASCII, tab, LF, CR, or complete multi-byte UTF-8 sequences of 2 to 4 bytes. Anything else, a
+// control, '&', a bad or longer UTF-8 sequence, or one split by the end of the block, stops the skip.
+// The bytes before the start of a block are never looked at, so the input must be at the start of
+// a character. Each block is summarized as bit masks, one bit per byte:
+//   cont  - A UTF-8 continuation byte, 0x80..0xBF.
+//   need  - A byte that must be a continuation, following a lead byte of 0xC0, 0xE0, or 0xF0 and up.
+//   stop  - A control other than tab/LF/CR, 0x7F, '&', or 0xF8 and up.
+// The block is fine if there are no stops and cont equals need, else the skip stops at the start of
+// the character holding the first bad byte.
+
+static inline size_t
+CheckUTF8Block ( XMP_Uns32 stop, XMP_Uns32 cont, XMP_Uns32 geC0, XMP_Uns32 geE0, XMP_Uns32 geF0, size_t blockSize )
+{
+	// Return the number of bytes at the front of the block that can be skipped.
+
+	const XMP_Uns64 blockMask = (blockSize == 32) ? 0xFFFFFFFFULL : 0xFFFFULL;
+
+	XMP_Uns64 need = ((XMP_Uns64)geC0 << 1) | ((XMP_Uns64)geE0 << 2) | ((XMP_Uns64)geF0 << 3);
+	XMP_Uns32 bad = stop | (XMP_Uns32) ((need & blockMask) ^ cont);
+
+	if ( (need >> blockSize) != 0 ) {	// Mark the leads of sequences that run past the block.
+		const XMP_Uns32 top = (XMP_Uns32) (blockMask >> 1) + 1;
+		bad |= (geC0 & top) | (geE0 & (top | (top >> 1))) | (geF0 & (top | (top >> 1) | (top >> 2)));
+	}
+
+	if ( bad == 0 ) return blockSize;
+
+	const int badIndex = LowBitIndex ( bad );
+	const XMP_Uns32 badBit = 1UL << badIndex;
+	if ( ((cont | (XMP_Uns32)need) & badBit) == 0 ) return badIndex;	// The bad byte starts a character.
+
+	XMP_Uns32 starts = ~cont & (badBit - 1);
+	if ( starts == 0 ) return 0;
+	return HighBitIndex ( starts );	// ! Recheck the character that the bad byte is part of.
+
+}	// CheckUTF8Block
+
+#if ScanWithSSE2
+
+static inline XMP_Uns32 AtLeastSSE2 ( __m128i bytes, XMP_Uns8 low )
+{
+	__m128i lowBytes = _mm_set1_epi8 ( (char)low );
+	return (XMP_Uns32) _mm_movemask_epi8 ( _mm_cmpeq_epi8 ( _mm_max_epu8 ( bytes, lowBytes ), bytes ) );
+}
+
+static const XMP_Uns8 *
+SkipValidUTF8SSE2 ( const XMP_Uns8 * ptr, const XMP_Uns8 * bufEnd )
+{
+	const __m128i space = _mm_set1_epi8 ( ' ' );
+	const __m128i amp = _mm_set1_epi8 ( '&' );
+	const __m128i del = _mm_set1_epi8 ( 0x7F );
+	const __m128i tab = _mm_set1_epi8 ( kTab );
+	const __m128i lf = _mm_set1_epi8 ( kLF );
+	const __m128i cr = _mm_set1_epi8 ( kCR );
+	const __m128i contBits = _mm_set1_epi8 ( (char)0xC0 );
+	const __m128i contValue = _mm_set1_epi8 ( (char)0x80 );
+
+	while ( (bufEnd - ptr) >= 16 ) {
+
+		__m128i bytes = _mm_loadu_si128 ( (const __m128i*) ptr );
+
+		// ! The signed compare also counts 0x80 and up as less than a space.
+		__m128i white = _mm_or_si128 ( _mm_cmpeq_epi8 ( bytes, tab ), _mm_or_si128 ( _mm_cmpeq_epi8 ( bytes, lf ), _mm_cmpeq_epi8 ( bytes, cr ) ) );
+		__m128i odd = _mm_andnot_si128 ( white, _mm_cmplt_epi8 ( bytes, space ) );
+		odd = _mm_or_si128 ( odd, _mm_or_si128 ( _mm_cmpeq_epi8 ( bytes, amp ), _mm_cmpeq_epi8 ( bytes, del ) ) );
+
+		XMP_Uns32 oddMask = (XMP_Uns32) _mm_movemask_epi8 ( odd );
+		if ( oddMask == 0 ) { ptr += 16; continue; }	// All ASCII, the usual case.
+
+		XMP_Uns32 high = (XMP_Uns32) _mm_movemask_epi8 ( bytes );
+		XMP_Uns32 cont = (XMP_Uns32) _mm_movemask_epi8 ( _mm_cmpeq_epi8 ( _mm_and_si128 ( bytes, contBits ), contValue ) );
+		XMP_Uns32 stop = (oddMask & ~high) | AtLeastSSE2 ( bytes, 0xF8 );
+
+		size_t skip = CheckUTF8Block ( stop, cont, AtLeastSSE2 ( bytes, 0xC0 ), AtLeastSSE2 ( bytes, 0xE0 ), AtLeastSSE2 ( bytes, 0xF0 ), 16 );
+		ptr += skip;
+		if ( skip < 16 ) break;
+
+	}
+
+	return ptr;	// ! The caller finishes the tail.
+
+}	// SkipValidUTF8SSE2
+
+#endif
+
+#if ScanWithAVX2
+
+__attribute__ (( target ( "avx2" ) ))
+static inline XMP_Uns32 AtLeastAVX2 ( __m256i bytes, XMP_Uns8 low )
+{
+	__m256i lowBytes = _mm256_set1_epi8 ( (char)low );
+	return (XMP_Uns32) _mm256_movemask_epi8 ( _mm256_cmpeq_epi8 ( _mm256_max_epu8 ( bytes, lowBytes ), bytes ) );
+}
+
+__attribute__ (( target ( "avx2" ) ))
+static const XMP_Uns8 *
+SkipValidUTF8AVX2 ( const XMP_Uns8 * ptr, const XMP_Uns8 * bufEnd )
+{
+	const __m256i space = _mm256_set1_epi8 ( ' ' );
+	const __m256i amp = _mm256_set1_epi8 ( '&' );
+	const __m256i del = _mm256_set1_epi8 ( 0x7F );
+	const __m256i tab = _mm256_set1_epi8 ( kTab );
+	const __m256i lf = _mm256_set1_epi8 ( kLF );
+	const __m256i cr = _mm256_set1_epi8 ( kCR );
+	const __m256i contBits = _mm256_set1_epi8 ( (char)0xC0 );
+	const __m256i contValue = _mm256_set1_epi8 ( (char)0x80 );
+
+	while ( (bufEnd - ptr) >= 32 ) {
+
+		__m256i bytes = _mm256_loadu_si256 ( (const __m256i*) ptr );
+
+		// ! The signed compare also counts 0x80 and up as less than a space.
+		__m256i white = _mm256_or_si256 ( _mm256_cmpeq_epi8 ( bytes, tab ), _mm256_or_si256 ( _mm256_cmpeq_epi8 ( bytes, lf ), _mm256_cmpeq_epi8 ( bytes, cr ) ) );
+		__m256i odd = _mm256_andnot_si256 ( white, _mm256_cmpgt_epi8 ( space, bytes ) );
+		odd = _mm256_or_si256 ( odd, _mm256_or_si256 ( _mm256_cmpeq_epi8 ( bytes, amp ), _mm256_cmpeq_epi8 ( bytes, del ) ) );
+
+		XMP_Uns32 oddMask = (XMP_Uns32) _mm256_movemask_epi8 ( odd );
+		if ( oddMask == 0 ) { ptr += 32; continue; }	// All ASCII, the usual case.
+
+		XMP_Uns32 high = (XMP_Uns32) _mm256_movemask_epi8 ( bytes );
+		XMP_Uns32 cont = (XMP_Uns32) _mm256_movemask_epi8 ( _mm256_cmpeq_epi8 ( _mm256_and_si256 ( bytes, contBits ), contValue ) );
+		XMP_Uns32 stop = (oddMask & ~high) | AtLeastAVX2 ( bytes, 0xF8 );
+
+		size_t skip = CheckUTF8Block ( stop, cont, AtLeastAVX2 ( bytes, 0xC0 ), AtLeastAVX2 ( bytes, 0xE0 ), AtLeastAVX2 ( bytes, 0xF0 ), 32 );
+		ptr += skip;
+		if ( skip < 32 ) break;
+
+	}
+
+	return ptr;	// ! The caller finishes the tail.
+
+}	// SkipValidUTF8AVX2
+
+#endif
+
+static inline const XMP_Uns8 *
+SkipValidUTF8 ( const XMP_Uns8 * ptr, const XMP_Uns8 * bufEnd )
+{
+
+	#if ScanWithAVX2
+		if ( HaveAVX2() ) ptr = SkipValidUTF8AVX2 ( ptr, bufEnd );
+	#endif
+
+	#if ScanWithSSE2
+		ptr = SkipValidUTF8SSE2 ( ptr, bufEnd );
+	#endif
+
+	return ptr;
+
+}	// SkipValidUTF8
+
+
 // -------------------------------------------------------------------------------------------------
 // ProcessUTF8Portion
 // ------------------
@@ -939,6 +1121,9 @@ CountControlEscape ( const XMP_Uns8 * escStart, const XMP_Uns8 * bufEnd )
 //
 // We check for 1 or 2 hex digits ("&#x9;" or "&#x09;") and upper or lower case ("&#xA;" or "&#xa;").
 // The full escape sequence is 5 or 6 bytes.
+//
+// Runs of input that need no changes, the bulk of most packets, are skipped a block at a time by
+// SkipValidUTF8. The byte at a time checks are only used from the first character it rejects.
 
 static size_t
 ProcessUTF8Portion ( XMLParserAdapter * xmlParser,
@@ -953,6 +1138,9 @@ ProcessUTF8Portion ( XMLParserAdapter * xmlParser,
 		
 	for ( spanEnd = spanStart; spanEnd < bufEnd; ++spanEnd ) {
 
+		spanEnd = SkipValidUTF8 ( spanEnd, bufEnd );	// ! Always at the start of a character here.
+		if ( spanEnd == bufEnd ) break;
+
 		if ( (0x20 <= *spanEnd) && (*spanEnd <= 0x7E) && (*spanEnd != '&') ) continue;	// A regular ASCII character.
 
 		if ( *spanEnd >= 0x80 ) {
@@ -1135,22 +1323,17 @@ bool XMPMeta::ProcessXMLBuffer ( XMP_StringPtr buffer, XMP_StringLen xmpSize, bo
 				xmpSize += bytesLeft;
 				parser.pendingCount = 0;
 
-			} else if ( xmpSize > 0 ) {
-
-				// Pull more of the current buffer into the pending input and try again.
-				// Backup by this pass's overlap so the loop entry code runs OK.
-				parser.pendingCount -= pendingOverlap;
-				buffer -= pendingOverlap;
-				xmpSize += pendingOverlap;
-
 			} else {
 
-				// There is no more of the current buffer. Wait for more. Partial sequences at
-				// the end of the last buffer should be treated as Latin-1 by ProcessUTF8Portion.
+				// Keep the partial sequence at the end as the pending input, then pull in more of
+				// the current buffer or wait for the next one. The pending input is full here, so
+				// ProcessUTF8Portion always made progress. Partial sequences at the end of the
+				// last buffer should be treated as Latin-1 by ProcessUTF8Portion.
 				XMP_Assert ( ! lastClientCall );
+				XMP_Assert ( bytesLeft < bytesDone );
 				parser.pendingCount = bytesLeft;
 				memcpy ( &parser.pendingInput[0], &parser.pendingInput[bytesDone], bytesLeft );	// AUDIT: Count is safe.
-				return false;	// Wait for the next buffer.
+				if ( xmpSize == 0 ) return false;	// Wait for the next buffer.
 
 			}
 		
@@ -1195,11 +1378,19 @@ void XMPMeta::ProcessXMLTree ( XMP_OptionBits options )
 		DumpXMLTree ( this->xmlParser->parseLog, this->xmlParser->tree, 0 );
 	#endif
 
-	const XML_Node * xmlRoot = FindRootNode ( *this->xmlParser, options );
+	bool haveRoot = false;
 
-	if ( xmlRoot != 0 ) {
+	if ( this->xmlParser->eventReceiver != 0 ) {
+		haveRoot = this->ProcessRDFStream ( options );	// The XMP tree was built during the XML parse.
+	} else {
+		const XML_Node * xmlRoot = FindRootNode ( *this->xmlParser, options );
+		if ( xmlRoot != 0 ) {
+			this->ProcessRDF ( *xmlRoot, options );
+			haveRoot = true;
+		}
+	}
 
-		this->ProcessRDF ( *xmlRoot, options );
+	if ( haveRoot ) {
 
 		NormalizeDCArrays ( &this->tree );
 		if ( this->tree.options & kXMP_PropHasAliases ) MoveExplicitAliases ( &this->tree, options, this->errorCallback );
@@ -1251,8 +1442,13 @@ XMPMeta::ParseFromBuffer ( XMP_StringPtr  buffer,
 	if ( this->xmlParser == 0 ) {
 		this->tree.ClearNode();	// Make sure the target XMP object is totally empty.
 		if ( (xmpSize == 0) && lastClientCall ) return;	// Tolerate empty parse. Expat complains if there are no XML elements.
-		this->xmlParser = XMP_NewExpatAdapter ( ExpatAdapter::kUseGlobalNamespaces );
+		this->xmlParser = XMP_AcquireExpatAdapter();
 		this->xmlParser->SetErrorCallback ( &this->errorCallback );
+		if ( options & kXMP_ParseStreaming ) {
+			this->StartRDFStream();
+		} else if ( this->xmlParser->nodeArena == 0 ) {
+			this->xmlParser->nodeArena = new XML_NodeArena();	// The XML tree is discarded as a whole after ProcessXMLTree.
+		}
 	}
 	
 	try {	// Cleanup the tree and xmlParser if anything fails.
@@ -1262,13 +1458,13 @@ XMPMeta::ParseFromBuffer ( XMP_StringPtr  buffer,
 		
 		if ( lastClientCall ) {
 			this->ProcessXMLTree ( options );
-			delete this->xmlParser;
+			XMP_ReleaseExpatAdapter ( static_cast<ExpatAdapter*> ( this->xmlParser ) );
 			this->xmlParser = 0;
 		}
 		
 	} catch ( ... ) {
 
-		delete this->xmlParser;
+		XMP_ReleaseExpatAdapter ( static_cast<ExpatAdapter*> ( this->xmlParser ) );
 		this->xmlParser = 0;
 		throw;
 
@@ -1276,4 +1472,124 @@ XMPMeta::ParseFromBuffer ( XMP_StringPtr  buffer,
 	
 }	// ParseFromBuffer
 
+
+// -------------------------------------------------------------------------------------------------
+// SetParseNamespaces
+// ------------------
+//
+// Top level properties in other schemas are dropped by the RDF parser, along with everything inside
+// them. An empty list parses all schemas.
+
+void
+XMPMeta::SetParseNamespaces ( const XMP_StringPtr * namespaceURIs,
+							  XMP_Index				uriCount )
+{
+	if ( (namespaceURIs == 0) && (uriCount != 0) ) XMP_Throw ( "Null namespace list", kXMPErr_BadParam );
+	if ( uriCount < 0 ) XMP_Throw ( "Negative namespace count", kXMPErr_BadParam );
+	if ( this->xmlParser != 0 ) XMP_Throw ( "Can't change the parse namespaces during a parse", kXMPErr_BadParam );
+
+	std::vector<XMP_VarString> newNamespaces ( uriCount );
+	for ( XMP_Index i = 0; i < uriCount; ++i ) {
+		if ( (namespaceURIs[i] == 0) || (*namespaceURIs[i] == 0) ) XMP_Throw ( "Empty namespace URI", kXMPErr_BadSchema );
+		newNamespaces[i] = namespaceURIs[i];
+	}
+
+	this->parseNamespaces.swap ( newNamespaces );
+
+}	// SetParseNamespaces
+
+// -------------------------------------------------------------------------------------------------
+// ParseBatch
+// ----------
+//
+// Each packet is parsed into its own XMP object, on up to one thread per core. The Expat adapter
+// pool and XMP node cache are per thread, so a worker reuses its parser and node storage from one
+// packet to the next. That reuse only lasts for one call, the workers exit when the batch is done.
+// A failed parse leaves its error ID in errorIDs and does not stop the others.
+//
+// With UseGlobalLibraryLock the calling thread holds the library lock, the workers would parse
+// outside of it. The batch is parsed on the calling thread in that case.
+
+static const size_t kMaxBatchThreads = 16;
+
+struct ParseBatchInfo {
+	const XMP_StringPtr * buffers;
+	const XMP_StringLen * sizes;
+	XMP_OptionBits options;
+	XMPMeta ** xmpObjs;
+	XMP_Int32 * errorIDs;
+	size_t count;
+	std::atomic<size_t> nextItem;
+};
+
+static void ParseBatchItems ( ParseBatchInfo * batch )
+{
+	for ( size_t item = batch->nextItem++; item < batch->count; item = batch->nextItem++ ) {
+
+		XMPMeta * xmpObj = batch->xmpObjs[item];
+		XMP_AutoLock objLock ( &xmpObj->lock, kXMP_WriteLock );
+		XMP_Int32 errorID = kXMPErr_NoError;
+
+		try {
+			xmpObj->ParseFromBuffer ( batch->buffers[item], batch->sizes[item], batch->options );
+		} catch ( XMP_Error & xmpErr ) {
+			errorID = xmpErr.GetID();
+		} catch ( std::bad_alloc & ) {
+			errorID = kXMPErr_NoMemory;
+		} catch ( ... ) {
+			errorID = kXMPErr_Unknown;
+		}
+
+		if ( errorID != kXMPErr_NoError ) xmpObj->Erase();	// Don't leave part of a bad packet.
+		batch->errorIDs[item] = errorID;
+
+	}
+
+}	// ParseBatchItems
+
+// -------------------------------------------------------------------------------------------------
+
+/* class static */ void
+XMPMeta::ParseBatch ( XMP_Index				count,
+					  const XMP_StringPtr * buffers,
+					  const XMP_StringLen * sizes,
+					  XMP_OptionBits		options,
+					  XMPMeta **			xmpObjs,
+					  XMP_Int32 *			errorIDs )
+{
+	if ( count < 0 ) XMP_Throw ( "Negative batch count", kXMPErr_BadParam );
+	if ( count == 0 ) return;
+	if ( (buffers == 0) || (sizes == 0) || (xmpObjs == 0) || (errorIDs == 0) ) XMP_Throw ( "Null batch array", kXMPErr_BadParam );
+	if ( options & kXMP_ParseMoreBuffers ) XMP_Throw ( "Batch packets must be complete", kXMPErr_BadOptions );
+	for ( XMP_Index i = 0; i < count; ++i ) {
+		if ( xmpObjs[i] == 0 ) XMP_Throw ( "Null batch XMP object", kXMPErr_BadParam );
+	}
+
+	ParseBatchInfo batch;
+	batch.buffers = buffers;
+	batch.sizes = sizes;
+	batch.options = options;
+	batch.xmpObjs = xmpObjs;
+	batch.errorIDs = errorIDs;
+	batch.count = (size_t)count;
+	batch.nextItem = 0;
+
+	size_t threadCount = std::thread::hardware_concurrency();
+	if ( threadCount > batch.count ) threadCount = batch.count;
+	if ( threadCount > kMaxBatchThreads ) threadCount = kMaxBatchThreads;
+	#if UseGlobalLibraryLock
+		threadCount = 1;
+	#endif
+
+	std::vector<std::thread> workers;
+	try {
+		for ( size_t t = 1; t < threadCount; ++t ) workers.push_back ( std::thread ( ParseBatchItems, &batch ) );
+	} catch ( ... ) {
+		// Could not start all of the threads, the ones that did start and this one do the rest.
+	}
+	ParseBatchItems ( &batch );
+	for ( size_t t = 0; t < workers.size(); ++t ) workers[t].join();
+
+}	// ParseBatch
+
 // =================================================================================================
@@ -85,49 +85,22 @@ static const char * kRDF_ValueStart   = "<rdf:value>";
 
 
 // -------------------------------------------------------------------------------------------------
-// EstimateRDFSize
-// ---------------
-
-//  *** Pull the strlen(kXyz) calls into constants.
+// IsDeclaredNamespace
+// -------------------
+//
+// The usedNS string is a catenation of the prefixes with colons, ":xml:rdf:dc:". Look for ":prefix"
+// without making a string for it.
 
-static size_t
-EstimateRDFSize ( const XMP_Node * currNode, XMP_Index indent, size_t indentLen )
+static bool
+IsDeclaredNamespace ( const XMP_VarString & usedNS, XMP_StringPtr nsPrefix, size_t prefixLen )
 {
-	size_t outputLen = 2 * (indent*indentLen + currNode->name.size() + 4);	// The property element tags.
-	
-	if ( ! currNode->qualifiers.empty() ) {
-		// This node has qualifiers, assume it is written using rdf:value and estimate the qualifiers.
-
-		indent += 2;	// Everything else is indented inside the rdf:Description element.
-		outputLen += 2 * ((indent-1)*indentLen + strlen(kRDF_StructStart) + 2);	// The rdf:Description tags.
-		outputLen += 2 * (indent*indentLen + strlen(kRDF_ValueStart) + 2);		// The rdf:value tags.
-
-		for ( size_t qualNum = 0, qualLim = currNode->qualifiers.size(); qualNum < qualLim; ++qualNum ) {
-			const XMP_Node * currQual = currNode->qualifiers[qualNum];
-			outputLen += EstimateRDFSize ( currQual, indent, indentLen );
-		}
-
-	}
-	
-	if ( currNode->options & kXMP_PropValueIsStruct ) {
-		indent += 1;
-		outputLen += 2 * (indent*indentLen + strlen(kRDF_StructStart) + 2);	// The rdf:Description tags.
-	} else if ( currNode->options & kXMP_PropValueIsArray ) {
-		indent += 2;
-		outputLen += 2 * ((indent-1)*indentLen + strlen(kRDF_BagStart) + 2);		// The rdf:Bag/Seq/Alt tags.
-		outputLen += 2 * currNode->children.size() * (strlen(kRDF_ItemStart) + 2);	// The rdf:li tags, indent counted in children.
-	} else if ( ! (currNode->options & kXMP_SchemaNode) ) {
-		outputLen += currNode->value.size();	// This is a leaf value node.
-	}
-
-	for ( size_t childNum = 0, childLim = currNode->children.size(); childNum < childLim; ++childNum ) {
-		const XMP_Node * currChild = currNode->children[childNum];
-		outputLen += EstimateRDFSize ( currChild, indent+1, indentLen );
+	for ( size_t nsPos = usedNS.find ( nsPrefix, 1, prefixLen ); nsPos != XMP_VarString::npos;
+		  nsPos = usedNS.find ( nsPrefix, nsPos+1, prefixLen ) ) {
+		if ( usedNS[nsPos-1] == ':' ) return true;
 	}
+	return false;
 
-	return outputLen;
-	
-}	// EstimateRDFSize
+}	// IsDeclaredNamespace
 
 
 // -------------------------------------------------------------------------------------------------
@@ -143,11 +116,7 @@ DeclareOneNamespace	( XMP_StringPtr   nsPrefix,
 					  XMP_StringPtr   indentStr,
 					  XMP_Index       indent )
 {
-	XMP_VarString boundedPrefix = ":";
-	boundedPrefix += nsPrefix;
-	size_t nsPos = usedNS.find ( boundedPrefix );
-
-	if ( nsPos == XMP_VarString::npos ) {
+	if ( ! IsDeclaredNamespace ( usedNS, nsPrefix, strlen ( nsPrefix ) ) ) {
 		
 		outputStr += newline;
 		for ( ; indent > 0; --indent ) outputStr += indentStr;
@@ -182,7 +151,7 @@ DeclareElemNamespace ( const XMP_VarString & elemName,
 {
 	size_t colonPos = elemName.find ( ':' );
 
-	if ( colonPos != XMP_VarString::npos ) {
+	if ( (colonPos != XMP_VarString::npos) && (! IsDeclaredNamespace ( usedNS, elemName.c_str(), colonPos+1 )) ) {
 		XMP_VarString nsPrefix ( elemName.substr ( 0, colonPos+1 ) );
 		XMP_StringPtr nsURI;
 		bool nsFound = sRegisteredNamespaces->GetURI ( nsPrefix.c_str(), &nsURI, 0 );
@@ -194,40 +163,74 @@ DeclareElemNamespace ( const XMP_VarString & elemName,
 
 
 // -------------------------------------------------------------------------------------------------
-// DeclareUsedNamespaces
-// ---------------------
+// GatherRDFInfo
+// -------------
+//
+// Walk the tree once before writing anything. Returns a worst case estimate of the RDF size, and
+// builds the xmlns attributes of the outer rdf:Description in the order the namespaces are used.
+// The estimate does not look at the values for character entities, the caller adds a fudge factor.
 
-static void
-DeclareUsedNamespaces ( const XMP_Node * currNode,
-						XMP_VarString &  usedNS,
-						XMP_VarString &	 outputStr,
-						XMP_StringPtr	 newline,
-						XMP_StringPtr	 indentStr,
-						XMP_Index		 indent )
-{
+//  *** Pull the strlen(kXyz) calls into constants.
 
+struct RDFNamespaceInfo {
+	XMP_VarString usedNS;	// ! A catenation of the prefixes with colons.
+	XMP_VarString nsDecls;	// The xmlns attributes, each with its newline and indent.
+	XMP_StringPtr newline;
+	XMP_StringPtr indentStr;
+	XMP_Index	  nsIndent;
+};
+
+static size_t
+GatherRDFInfo ( const XMP_Node * currNode, XMP_Index indent, size_t indentLen, RDFNamespaceInfo & nsInfo )
+{
+	size_t outputLen = 2 * (indent*indentLen + currNode->name.size() + 4);	// The property element tags.
+	XMP_Index childIndent = indent;
+	
 	if ( currNode->options & kXMP_SchemaNode ) {
 		// The schema node name is the URI, the value is the prefix.
-		DeclareOneNamespace ( currNode->value.c_str(), currNode->name.c_str(), usedNS, outputStr, newline, indentStr, indent );
+		DeclareOneNamespace ( currNode->value.c_str(), currNode->name.c_str(), nsInfo.usedNS, nsInfo.nsDecls,
+							  nsInfo.newline, nsInfo.indentStr, nsInfo.nsIndent );
 	} else if ( currNode->options & kXMP_PropValueIsStruct ) {
 		for ( size_t fieldNum = 0, fieldLim = currNode->children.size(); fieldNum < fieldLim; ++fieldNum ) {
 			const XMP_Node * currField = currNode->children[fieldNum];
-			DeclareElemNamespace ( currField->name, usedNS, outputStr, newline, indentStr, indent );
+			DeclareElemNamespace ( currField->name, nsInfo.usedNS, nsInfo.nsDecls,
+								   nsInfo.newline, nsInfo.indentStr, nsInfo.nsIndent );
 		}
 	}
 
+	if ( ! currNode->qualifiers.empty() ) {
+		// This node has qualifiers, assume it is written using rdf:value and estimate the qualifiers.
+		childIndent += 2;	// Everything else is indented inside the rdf:Description element.
+		outputLen += 2 * ((childIndent-1)*indentLen + strlen(kRDF_StructStart) + 2);	// The rdf:Description tags.
+		outputLen += 2 * (childIndent*indentLen + strlen(kRDF_ValueStart) + 2);		// The rdf:value tags.
+	}
+	
+	if ( currNode->options & kXMP_PropValueIsStruct ) {
+		childIndent += 1;
+		outputLen += 2 * (childIndent*indentLen + strlen(kRDF_StructStart) + 2);	// The rdf:Description tags.
+	} else if ( currNode->options & kXMP_PropValueIsArray ) {
+		childIndent += 2;
+		outputLen += 2 * ((childIndent-1)*indentLen + strlen(kRDF_BagStart) + 2);		// The rdf:Bag/Seq/Alt tags.
+		outputLen += 2 * currNode->children.size() * (strlen(kRDF_ItemStart) + 2);	// The rdf:li tags, indent counted in children.
+	} else if ( ! (currNode->options & kXMP_SchemaNode) ) {
+		outputLen += currNode->value.size();	// This is a leaf value node.
+	}
+
 	for ( size_t childNum = 0, childLim = currNode->children.size(); childNum < childLim; ++childNum ) {
 		const XMP_Node * currChild = currNode->children[childNum];
-		DeclareUsedNamespaces ( currChild, usedNS, outputStr, newline, indentStr, indent );
+		outputLen += GatherRDFInfo ( currChild, childIndent+1, indentLen, nsInfo );
 	}
 
 	for ( size_t qualNum = 0, qualLim = currNode->qualifiers.size(); qualNum < qualLim; ++qualNum ) {
 		const XMP_Node * currQual = currNode->qualifiers[qualNum];
-		DeclareElemNamespace ( currQual->name, usedNS, outputStr, newline, indentStr, indent );
-		DeclareUsedNamespaces ( currQual, usedNS, outputStr, newline, indentStr, indent );
+		DeclareElemNamespace ( currQual->name, nsInfo.usedNS, nsInfo.nsDecls,
+							   nsInfo.newline, nsInfo.indentStr, nsInfo.nsIndent );
+		outputLen += GatherRDFInfo ( currQual, indent+2, indentLen, nsInfo );
 	}
+
+	return outputLen;
 	
-}	// DeclareUsedNamespaces
+}	// GatherRDFInfo
 
 // -------------------------------------------------------------------------------------------------
 // EmitRDFArrayTag
@@ -391,11 +394,11 @@ IsRDFAttrQualifier ( XMP_VarString qualName )
 // open so that the compact form can add proprtty attributes.
 
 static void
-StartOuterRDFDescription ( const XMP_Node & xmpTree,
-						   XMP_VarString &  outputStr,
-						   XMP_StringPtr	newline,
-						   XMP_StringPtr	indentStr,
-						   XMP_Index		baseIndent )
+StartOuterRDFDescription ( const XMP_Node &		 xmpTree,
+						   const XMP_VarString & nsDecls,
+						   XMP_VarString &		 outputStr,
+						   XMP_StringPtr		 indentStr,
+						   XMP_Index			 baseIndent )
 {
 	
 	// Begin the outer rdf:Description start tag.
@@ -406,16 +409,9 @@ StartOuterRDFDescription ( const XMP_Node & xmpTree,
 	outputStr += xmpTree.name;
 	outputStr += '"';
 	
-	// Write all necessary xmlns attributes.
-
-	XMP_VarString usedNS;
-	usedNS.reserve ( 400 );	// The predefined prefixes add up to about 320 bytes.
-	usedNS = ":xml:rdf:";
+	// Write all necessary xmlns attributes, gathered by GatherRDFInfo.
 
-	for ( size_t schema = 0, schemaLim = xmpTree.children.size(); schema != schemaLim; ++schema ) {
-		const XMP_Node * currSchema = xmpTree.children[schema];
-		DeclareUsedNamespaces ( currSchema, usedNS, outputStr, newline, indentStr, baseIndent+4 );
-	}
+	outputStr += nsDecls;
 
 }	// StartOuterRDFDescription
 
@@ -687,15 +683,16 @@ SerializeCanonicalRDFProperty ( const XMP_Node * propNode,
 //	</rdf:Description>
 
 static void
-SerializeCanonicalRDFSchemas ( const XMP_Node & xmpTree,
-							   XMP_VarString &	outputStr,
-							   XMP_StringPtr	newline,
-							   XMP_StringPtr	indentStr,
-							   XMP_Index		baseIndent,
-							   bool				useCanonicalRDF )
+SerializeCanonicalRDFSchemas ( const XMP_Node &		 xmpTree,
+							   const XMP_VarString & nsDecls,
+							   XMP_VarString &		 outputStr,
+							   XMP_StringPtr		 newline,
+							   XMP_StringPtr		 indentStr,
+							   XMP_Index			 baseIndent,
+							   bool					 useCanonicalRDF )
 {
 
-	StartOuterRDFDescription ( xmpTree, outputStr, newline, indentStr, baseIndent );
+	StartOuterRDFDescription ( xmpTree, nsDecls, outputStr, indentStr, baseIndent );
 	
 	if ( xmpTree.children.size() > 0 ) {
 		outputStr += ">";
@@ -1023,16 +1020,17 @@ SerializeCompactRDFElemProps ( const XMP_Node *	parentNode,
 //	</rdf:Description>
 
 static void
-SerializeCompactRDFSchemas ( const XMP_Node & xmpTree,
-							 XMP_VarString &  outputStr,
-							 XMP_StringPtr	  newline,
-							 XMP_StringPtr	  indentStr,
-							 XMP_Index		  baseIndent )
+SerializeCompactRDFSchemas ( const XMP_Node &	   xmpTree,
+							 const XMP_VarString & nsDecls,
+							 XMP_VarString &	   outputStr,
+							 XMP_StringPtr		   newline,
+							 XMP_StringPtr		   indentStr,
+							 XMP_Index			   baseIndent )
 {
 	XMP_Index level;
 	size_t schema, schemaLim;
 	
-	StartOuterRDFDescription ( xmpTree, outputStr, newline, indentStr, baseIndent );
+	StartOuterRDFDescription ( xmpTree, nsDecls, outputStr, indentStr, baseIndent );
 	
 	// Write the top level "attrProps" and close the rdf:Description start tag.
 	bool allAreAttrs = true;
@@ -1089,7 +1087,8 @@ SerializeAsRDF ( const XMPMeta & xmpObj,
 				 XMP_OptionBits	 options,
 				 XMP_StringPtr	 newline,
 				 XMP_StringPtr	 indentStr,
-				 XMP_Index		 baseIndent )
+				 XMP_Index		 baseIndent,
+				 size_t			 paddingLen )	// Only used to size headStr, the caller appends the padding.
 {
 	const size_t treeNameLen = xmpObj.tree.name.size();
 	const size_t indentLen   = strlen ( indentStr );
@@ -1098,43 +1097,39 @@ SerializeAsRDF ( const XMPMeta & xmpObj,
 	// avoids reallocating and copying the output as it grows. The initial count does not look at
 	// the values of properties, so it does not account for character entities, e.g. &#xA; for newline.
 	// Since there can be a lot of these in things like the base 64 encoding of a large thumbnail,
-	// inflate the count by 1/4 (easy to do) to accommodate.
+	// inflate the count by 1/4 (easy to do) to accommodate. The same walk of the tree gathers the
+	// namespace declarations for the outer rdf:Description.
 	
 	// *** Need to include estimate for alias comments.
 	
+	RDFNamespaceInfo nsInfo;
+	nsInfo.usedNS.reserve ( 400 );	// The predefined prefixes add up to about 320 bytes.
+	nsInfo.usedNS = ":xml:rdf:";
+	nsInfo.newline = newline;
+	nsInfo.indentStr = indentStr;
+	nsInfo.nsIndent = baseIndent+4;
+
 	size_t outputLen = 2 * (strlen(kPacketHeader) + strlen(kRDF_XMPMetaStart) + strlen(kRDF_RDFStart) + 3*baseIndent*indentLen);
 
 	for ( size_t schemaNum = 0, schemaLim = xmpObj.tree.children.size(); schemaNum < schemaLim; ++schemaNum ) {
 		const XMP_Node * currSchema = xmpObj.tree.children[schemaNum];
 		outputLen += 2*(baseIndent+2)*indentLen + strlen(kRDF_SchemaStart) + treeNameLen + strlen(kRDF_SchemaEnd) + 2;
-		outputLen += EstimateRDFSize ( currSchema, baseIndent+2, indentLen );
+		outputLen += GatherRDFInfo ( currSchema, baseIndent+2, indentLen, nsInfo );
 	}
 	
 	outputLen += (outputLen >> 2);	// Inflate by 1/4, an empirical fudge factor.
+	outputLen += nsInfo.nsDecls.size() + paddingLen;
 	
-	// Now generate the RDF into the head string as UTF-8.
+	// Now generate everything up to the padding into the head string as UTF-8, in one pass. The RDF
+	// hash is computed from the finished rdf:RDF element, it is then inserted into the x:xmpmeta
+	// start tag.
 	
 	XMP_Index level;
+	size_t hashPos = XMP_VarString::npos;
 	
-	std::string rdfstring;
 	headStr.erase();
-	rdfstring.reserve ( outputLen );
-
-	// Write the rdf:RDF start tag.
-	rdfstring += kRDF_RDFStart;
-	rdfstring += newline;
-	
-	// Write all of the properties.
-	if ( options & kXMP_UseCompactFormat ) {
-		SerializeCompactRDFSchemas ( xmpObj.tree, rdfstring, newline, indentStr, baseIndent );
-	} else {
-		bool useCanonicalRDF = XMP_OptionIsSet ( options, kXMP_UseCanonicalFormat );
-		SerializeCanonicalRDFSchemas ( xmpObj.tree, rdfstring, newline, indentStr, baseIndent, useCanonicalRDF );
-	}
+	headStr.reserve ( outputLen );
 
-	// Write the rdf:RDF end tag.
-	for ( level = baseIndent+1; level > 0; --level ) rdfstring += indentStr;
-	rdfstring += kRDF_RDFEnd;
 	// Write the packet header PI.
 	if ( ! (options & kXMP_OmitPacketWrapper) ) {
 		for ( level = baseIndent; level > 0; --level ) headStr += indentStr;
@@ -1147,33 +1142,46 @@ SerializeAsRDF ( const XMPMeta & xmpObj,
 		for ( level = baseIndent; level > 0; --level ) headStr += indentStr;
 		headStr += kRDF_XMPMetaStart;
 		headStr += kXMPCore_VersionMessage  "\"";
-		std::string digestStr;
-		unsigned char digestBin [16];
-		if (options & kXMP_IncludeRDFHash)
-		{
-			std::string hashrdf;	
-			MD5_CTX    context;
-			MD5Init ( &context );
-			MD5Update ( &context, (XMP_Uns8*)rdfstring.c_str(), (unsigned int)rdfstring.size() );
-			MD5Final ( digestBin, &context );
-			char buffer [40];
-			for ( int in = 0, out = 0; in < 16; in += 1, out += 2 ) {
-				XMP_Uns8 byte = digestBin[in];
-				buffer[out]   = kHexDigits [ byte >> 4 ];
-				buffer[out+1] = kHexDigits [ byte & 0xF ];
-			}
-			buffer[32] = 0;
-			digestStr.append ( buffer );
-			headStr += " rdfhash=\"";
-			headStr += digestStr + "\"";
-			headStr += " merged=\"0\"";
-		}
+		hashPos = headStr.size();
 		headStr += ">";
 		headStr += newline;
 	}
 
+	// Write the rdf:RDF start tag.
+	for ( level = baseIndent+1; level > 0; --level ) headStr += indentStr;
+	const size_t rdfStart = headStr.size();
+	headStr += kRDF_RDFStart;
+	headStr += newline;
+	
+	// Write all of the properties.
+	if ( options & kXMP_UseCompactFormat ) {
+		SerializeCompactRDFSchemas ( xmpObj.tree, nsInfo.nsDecls, headStr, newline, indentStr, baseIndent );
+	} else {
+		bool useCanonicalRDF = XMP_OptionIsSet ( options, kXMP_UseCanonicalFormat );
+		SerializeCanonicalRDFSchemas ( xmpObj.tree, nsInfo.nsDecls, headStr, newline, indentStr, baseIndent, useCanonicalRDF );
+	}
+
+	// Write the rdf:RDF end tag.
 	for ( level = baseIndent+1; level > 0; --level ) headStr += indentStr;
-	headStr+= rdfstring ;
+	headStr += kRDF_RDFEnd;
+
+	if ( (options & kXMP_IncludeRDFHash) && (hashPos != XMP_VarString::npos) ) {
+		unsigned char digestBin [16];
+		MD5_CTX    context;
+		MD5Init ( &context );
+		MD5Update ( &context, (XMP_Uns8*)headStr.c_str() + rdfStart, (unsigned int)(headStr.size() - rdfStart) );
+		MD5Final ( digestBin, &context );
+		char buffer [80];
+		memcpy ( buffer, " rdfhash=\"", 10 );
+		for ( int in = 0, out = 10; in < 16; in += 1, out += 2 ) {
+			XMP_Uns8 byte = digestBin[in];
+			buffer[out]   = kHexDigits [ byte >> 4 ];
+			buffer[out+1] = kHexDigits [ byte & 0xF ];
+		}
+		memcpy ( &buffer[42], "\" merged=\"0\"", 13 );	// ! Includes the terminating nul.
+		headStr.insert ( hashPos, buffer );
+	}
+
 	headStr += newline;
 
 	// Write the xmpmeta end tag.
@@ -1275,8 +1283,12 @@ XMPMeta::SerializeToBuffer ( XMP_VarString * rdfString,
 	// Serialize as UTF-8, then convert to UTF-16 or UTF-32 if necessary, and assemble with the padding and tail.
 	
 	std::string tailStr;
+	size_t paddingLen = 0;	// The UTF-8 padding is appended to rdfString, leave room for it.
+	if ( charEncoding == kXMP_EncodeUTF8 ) {
+		paddingLen = padding + ((padding / 100) + 1) * strlen ( newline ) + strlen ( kPacketTrailer ) + (strlen ( indentStr ) * baseIndent);
+	}
 
-	SerializeAsRDF ( *this, *rdfString, tailStr, options, newline, indentStr, baseIndent );
+	SerializeAsRDF ( *this, *rdfString, tailStr, options, newline, indentStr, baseIndent, paddingLen );
 
 	if ( charEncoding == kXMP_EncodeUTF8 ) {
 
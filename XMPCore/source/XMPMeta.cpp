@@ -486,6 +486,7 @@ SortWithinOffspring ( XMP_NodeOffspring & nodeVec )
 					sort ( currPos->children.begin(), currPos->children.end(), CompareNodeLangs );
 				}
 			}
+			currPos->children.ResetIndex();
 
 			SortWithinOffspring ( currPos->children );
 
@@ -621,6 +622,7 @@ RegisterAlias ( XMP_StringPtr  aliasNS,
 	// Finally, all is OK to register the new alias.
 
 	(void) sRegisteredAliasMap->insert ( XMP_AliasMap::value_type ( expAlias[kRootPropStep].step, expActual ) );
+	AddAliasNameToFilter ( expAlias[kRootPropStep].step );
 
 }	// RegisterAlias
 
@@ -792,6 +794,7 @@ XMPMeta::Initialize()
 
 	sRegisteredNamespaces = new XMP_NamespaceTable;
 	sRegisteredAliasMap   = new XMP_AliasMap;
+	ClearAliasNameFilter();
 	InitializeUnicodeConversions();
 
 
@@ -1296,6 +1299,7 @@ XMPMeta::Sort()
 	if ( ! this->tree.children.empty() ) {
 		// The schema prefixes are the node's value, the name is the URI, so we sort schemas by value.
 		sort ( this->tree.children.begin(), this->tree.children.end(), CompareNodeValues );
+		this->tree.children.ResetIndex();
 		SortWithinOffspring ( this->tree.children );
 	}
 
@@ -1338,6 +1342,7 @@ XMPMeta::Clone ( XMPMeta * clone, XMP_OptionBits options ) const
 	clone->tree.name    = this->tree.name;
 	clone->tree.value   = this->tree.value;
 	clone->errorCallback = this->errorCallback;
+	clone->parseNamespaces = this->parseNamespaces;
 
 	#if 0	// *** XMP_DebugBuild
 		clone->tree._namePtr = clone->tree.name.c_str();
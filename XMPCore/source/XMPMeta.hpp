@@ -327,6 +327,18 @@ public:
 	ParseFromBuffer ( XMP_StringPtr	 buffer,
 					  XMP_StringLen	 bufferSize,
 					  XMP_OptionBits options );
+
+	virtual void
+	SetParseNamespaces ( const XMP_StringPtr * namespaceURIs,
+						 XMP_Index			   uriCount );
+
+	static void
+	ParseBatch ( XMP_Index			   count,
+				 const XMP_StringPtr * buffers,
+				 const XMP_StringLen * sizes,
+				 XMP_OptionBits		   options,
+				 XMPMeta **			   xmpObjs,
+				 XMP_Int32 *		   errorIDs );
 	
 	virtual void
 	SerializeToBuffer ( XMP_VarString * rdfString,
@@ -404,6 +416,7 @@ public:
 	XMP_Node tree;
 	XMLParserAdapter * xmlParser;
 	ErrorCallbackInfo errorCallback;
+	std::vector<XMP_VarString> parseNamespaces;	// The schemas kept by ParseFromBuffer, all if empty.
 	
 	friend class XMPIterator;
 	friend class XMPUtils;
@@ -420,6 +433,8 @@ private:
 	void ProcessXMLTree ( XMP_OptionBits options );
 	bool ProcessXMLBuffer ( XMP_StringPtr buffer, XMP_StringLen xmpSize, bool lastClientCall );
 	void ProcessRDF ( const XML_Node & xmlTree, XMP_OptionBits options );
+	void StartRDFStream();
+	bool ProcessRDFStream ( XMP_OptionBits options );
 
 };	// class XMPMeta
 
@@ -103,11 +103,15 @@ void GIF_MetaHandler::CacheFileData()
 	if ( this->ParseGIFBlocks( fileRef ) )
 	{
 		// XMP packet present
-		this->xmpPacket.assign( XMPPacketLength, ' ' );
+		if ( ! this->ViewMappedPacket ( XMPPacketOffset, XMPPacketLength ) ) {
 
-		// 13 bytes for the block size and 2 bytes for Extension ID and Label
-		this->SeekFile( fileRef, XMPPacketOffset, kXMP_SeekFromStart );
-		fileRef->ReadAll( ( void* )this->xmpPacket.data(), XMPPacketLength );
+			this->xmpPacket.assign( XMPPacketLength, ' ' );
+
+			// 13 bytes for the block size and 2 bytes for Extension ID and Label
+			this->SeekFile( fileRef, XMPPacketOffset, kXMP_SeekFromStart );
+			fileRef->ReadAll( ( void* )this->xmpPacket.data(), XMPPacketLength );
+
+		}
 
 		this->packetInfo.offset = XMPPacketOffset;
 		this->packetInfo.length = XMPPacketLength;
@@ -129,11 +133,11 @@ void GIF_MetaHandler::ProcessXMP()
 
 	// Process the XMP packet.
 
-	if ( ! this->xmpPacket.empty() ) {
+	if ( this->PacketLen() != 0 ) {
 
 		XMP_Assert ( this->containsXMP );
-		XMP_StringPtr packetStr = this->xmpPacket.c_str();
-		XMP_StringLen packetLen = (XMP_StringLen) this->xmpPacket.size();
+		XMP_StringPtr packetStr = this->PacketPtr();
+		XMP_StringLen packetLen = this->PacketLen();
 
 		this->xmpObj.ParseFromBuffer ( packetStr, packetLen );
 
@@ -124,7 +124,8 @@ bool JPEG_CheckFormat ( XMP_FileFormat format,
 // ==================================
 
 JPEG_MetaHandler::JPEG_MetaHandler ( XMPFiles * _parent )
-	: exifMgr(0), psirMgr(0), iptcMgr(0), skipReconcile(false)
+	: exifView(0), exifViewLen(0), psirView(0), psirViewLen(0),
+	  exifMgr(0), psirMgr(0), iptcMgr(0), skipReconcile(false)
 {
 	this->parent = _parent;
 	this->handlerFlags = kJPEG_HandlerFlags;
@@ -149,7 +150,7 @@ JPEG_MetaHandler::~JPEG_MetaHandler()
 // CacheExtendedXMP
 // ================
 
-static void CacheExtendedXMP ( ExtendedXMPInfo * extXMP, XMP_Uns8 * buffer, size_t bufferLen )
+static void CacheExtendedXMP ( ExtendedXMPInfo * extXMP, const XMP_Uns8 * buffer, size_t bufferLen )
 {
 
 	// Have a portion of the extended XMP, cache the contents. This is complicated by the need to
@@ -169,7 +170,7 @@ static void CacheExtendedXMP ( ExtendedXMPInfo * extXMP, XMP_Uns8 * buffer, size
 	if ( bufferLen < kExtXMPPrefixLength ) return;	// Ignore bad input.
 	XMP_Assert ( CheckBytes ( &buffer[0], kExtXMPSignatureString, kExtXMPSignatureLength ) );
 
-	XMP_Uns8 * bufferPtr = buffer + kExtXMPSignatureLength;	// Start at the GUID.
+	const XMP_Uns8 * bufferPtr = buffer + kExtXMPSignatureLength;	// Start at the GUID.
 	
 	JPEG_MetaHandler::GUID_32 guid;
 	XMP_Assert ( sizeof(guid.data) == 32 );
@@ -226,6 +227,58 @@ static void CacheExtendedXMP ( ExtendedXMPInfo * extXMP, XMP_Uns8 * buffer, size
 
 }	// CacheExtendedXMP
 
+// =================================================================================================
+// GetSegmentData
+// ==============
+//
+// Return a pointer to some segment content and leave the file positioned just past it. The content
+// comes straight from the memory mapping if there is one, else it is read into the caller's buffer.
+
+static XMP_Uns8 * GetSegmentData ( XMP_IO* fileRef, XMP_Uns8 * mapData,
+								   XMP_Int64 offset, size_t length, XMP_Uns8 * buffer )
+{
+
+	if ( mapData == 0 ) {
+		fileRef->Seek ( offset, kXMP_SeekFromStart );
+		fileRef->ReadAll ( buffer, (XMP_Uns32)length );
+		return buffer;
+	}
+
+	if ( (XMP_Int64)length > (fileRef->Length() - offset) ) {
+		XMP_Throw ( "JPEG segment extends beyond EOF", kXMPErr_EnforceFailure );	// ! Same as ReadAll.
+	}
+	fileRef->Seek ( (offset + length), kXMP_SeekFromStart );
+	return (mapData + offset);
+
+}	// GetSegmentData
+
+// =================================================================================================
+// AppendSegmentData
+// =================
+//
+// Add another segment's worth of Exif or PSIR content. The first one is just remembered as a view
+// if it is in the memory mapping, a second one forces both into the string.
+
+static void AppendSegmentData ( std::string * contents, XMP_Uns8 ** view, size_t * viewLen,
+								XMP_Uns8 * data, size_t length, bool inMapping )
+{
+
+	if ( inMapping && contents->empty() && (*view == 0) ) {
+		*view = data;
+		*viewLen = length;
+		return;
+	}
+
+	if ( *view != 0 ) {
+		contents->assign ( (char*)(*view), *viewLen );
+		*view = 0;
+		*viewLen = 0;
+	}
+
+	contents->append ( (char*)data, length );
+
+}	// AppendSegmentData
+
 // =================================================================================================
 // JPEG_MetaHandler::CacheFileData
 // ===============================
@@ -279,6 +332,15 @@ void JPEG_MetaHandler::CacheFileData()
 
 	psirContents.clear();
 	exifContents.clear();
+	this->exifView = this->psirView = 0;
+	this->exifViewLen = this->psirViewLen = 0;
+
+	XMP_Uns8 * mapData = 0;
+	if ( this->parent->UsesLocalIO() ) {
+		this->fileMapping = ((XMPFiles_IO*)fileRef)->GetMapping();
+		mapData = this->fileMapping.get();
+	}
+	const bool inMapping = (mapData != 0);
 
 	XMP_AbortProc abortProc  = this->parent->abortProc;
 	void *        abortArg   = this->parent->abortArg;
@@ -335,9 +397,8 @@ void JPEG_MetaHandler::CacheFileData()
 				 CheckBytes ( &buffer[0], kPSIRSignatureString, kPSIRSignatureLength ) ) {
 
 				size_t psirLen = contentLen - kPSIRSignatureLength;
-				fileRef->Seek ( (contentOrigin + kPSIRSignatureLength), kXMP_SeekFromStart );
-				fileRef->ReadAll ( buffer, psirLen );
-				this->psirContents.append( (char *) buffer, psirLen );
+				XMP_Uns8 * psirPtr = GetSegmentData ( fileRef, mapData, (contentOrigin + kPSIRSignatureLength), psirLen, buffer );
+				AppendSegmentData ( &this->psirContents, &this->psirView, &this->psirViewLen, psirPtr, psirLen, inMapping );
 				continue;	// Move on to the next marker.
 
 			}
@@ -356,9 +417,8 @@ void JPEG_MetaHandler::CacheFileData()
 				  CheckBytes ( &buffer[0], kExifSignatureAltStr, kExifSignatureLength )) ) {
 
 				size_t exifLen = contentLen - kExifSignatureLength;
-				fileRef->Seek ( (contentOrigin + kExifSignatureLength), kXMP_SeekFromStart );
-				fileRef->ReadAll ( buffer, exifLen );
-				this->exifContents.append ( (char*)buffer, exifLen );
+				XMP_Uns8 * exifPtr = GetSegmentData ( fileRef, mapData, (contentOrigin + kExifSignatureLength), exifLen, buffer );
+				AppendSegmentData ( &this->exifContents, &this->exifView, &this->exifViewLen, exifPtr, exifLen, inMapping );
 				continue;	// Move on to the next marker.
 
 			}
@@ -368,9 +428,12 @@ void JPEG_MetaHandler::CacheFileData()
 
 				this->containsXMP = true;	// Found the standard XMP packet.
 				size_t xmpLen = contentLen - kMainXMPSignatureLength;
-				fileRef->Seek ( (contentOrigin + kMainXMPSignatureLength), kXMP_SeekFromStart );
-				fileRef->ReadAll ( buffer, xmpLen );
-				this->xmpPacket.assign ( (char*)buffer, xmpLen );
+				XMP_Uns8 * xmpPtr = GetSegmentData ( fileRef, mapData, (contentOrigin + kMainXMPSignatureLength), xmpLen, buffer );
+				if ( inMapping ) {
+					this->SetPacketView ( xmpPtr, (XMP_StringLen)xmpLen, this->fileMapping );
+				} else {
+					this->xmpPacket.assign ( (char*)xmpPtr, xmpLen );
+				}
 				this->packetInfo.offset = contentOrigin + kMainXMPSignatureLength;
 				this->packetInfo.length = (XMP_Int32)xmpLen;
 				this->packetInfo.padSize   = 0;	// Assume the rest for now, set later in ProcessXMP.
@@ -383,9 +446,8 @@ void JPEG_MetaHandler::CacheFileData()
 			if ( (signatureLen >= kExtXMPSignatureLength) &&
 				 CheckBytes ( &buffer[0], kExtXMPSignatureString, kExtXMPSignatureLength ) ) {
 
-				fileRef->Seek ( contentOrigin, kXMP_SeekFromStart );
-				fileRef->ReadAll ( buffer, contentLen );
-				CacheExtendedXMP ( &extXMP, buffer, contentLen );
+				XMP_Uns8 * extPtr = GetSegmentData ( fileRef, mapData, contentOrigin, contentLen, buffer );
+				CacheExtendedXMP ( &extXMP, extPtr, contentLen );
 				continue;	// Move on to the next marker.
 
 			}
@@ -548,6 +610,7 @@ void JPEG_MetaHandler::ProcessXMP()
 		this->psirMgr = new PSIR_MemoryReader();
 		this->iptcMgr = new IPTC_Reader();	// ! Parse it later.
 	} else {
+		XMP_Assert ( (this->exifView == 0) && (this->psirView == 0) );	// Only mapped for read-only.
 		if ( this->exifContents.size() == (65534 - 2 - 6) ) TrimFullExifAPP1 ( &this->exifContents );
 		if ( this->exifMgr == 0 ) this->exifMgr = new TIFF_FileWriter();
 		this->psirMgr = new PSIR_FileWriter();
@@ -563,14 +626,31 @@ void JPEG_MetaHandler::ProcessXMP()
 	PSIR_Manager & psir = *this->psirMgr;
 	IPTC_Manager & iptc = *this->iptcMgr;
 
-	bool haveExif = (! this->exifContents.empty());
+	// The read-only managers can use the cached contents in place, the contents and the mapping
+	// live as long as this handler. The TIFF reader byte swaps in place, the mapping is private.
+
+	XMP_Uns8 * exifData = this->exifView;
+	size_t exifLen = this->exifViewLen;
+	if ( (exifData == 0) && (! this->exifContents.empty()) ) {
+		exifData = (XMP_Uns8*) &this->exifContents[0];
+		exifLen = this->exifContents.size();
+	}
+
+	XMP_Uns8 * psirData = this->psirView;
+	size_t psirLen = this->psirViewLen;
+	if ( (psirData == 0) && (! this->psirContents.empty()) ) {
+		psirData = (XMP_Uns8*) &this->psirContents[0];
+		psirLen = this->psirContents.size();
+	}
+
+	bool haveExif = (exifLen != 0);
 	if ( haveExif ) {
-		exif.ParseMemoryStream ( this->exifContents.c_str(), (XMP_Uns32)this->exifContents.size() );
+		exif.ParseMemoryStream ( exifData, (XMP_Uns32)exifLen, (! readOnly) /* copyData */ );
 	}
 
-	bool havePSIR = (! this->psirContents.empty());
+	bool havePSIR = (psirLen != 0);
 	if ( havePSIR ) {
-		psir.ParseMemoryResources ( this->psirContents.c_str(), (XMP_Uns32)this->psirContents.size() );
+		psir.ParseMemoryResources ( psirData, (XMP_Uns32)psirLen, (! readOnly) /* copyData */ );
 	}
 
 	PSIR_Manager::ImgRsrcInfo iptcInfo;
@@ -604,11 +684,11 @@ void JPEG_MetaHandler::ProcessXMP()
 
 	bool haveXMP = false;
 
-	if ( ! this->xmpPacket.empty() ) {
+	if ( this->PacketLen() != 0 ) {
 		XMP_Assert ( this->containsXMP );
 		// Common code takes care of packetInfo.charForm, .padSize, and .writeable.
-		XMP_StringPtr packetStr = this->xmpPacket.c_str();
-		XMP_StringLen packetLen = (XMP_StringLen)this->xmpPacket.size();
+		XMP_StringPtr packetStr = this->PacketPtr();
+		XMP_StringLen packetLen = this->PacketLen();
 		try {
 			this->xmpObj.ParseFromBuffer ( packetStr, packetLen );
 		} catch ( ... ) { /* Ignore parsing failures, someday we hope to get partial XMP back. */ }
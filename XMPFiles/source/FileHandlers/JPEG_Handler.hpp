@@ -15,6 +15,8 @@
 #include "public/include/XMP_Const.h"
 #include "public/include/XMP_IO.hpp"
 
+#include "source/XMPFiles_IO.hpp"
+
 #include "XMPFiles/source/FormatSupport/TIFF_Support.hpp"
 #include "XMPFiles/source/FormatSupport/PSIR_Support.hpp"
 #include "XMPFiles/source/FormatSupport/IPTC_Support.hpp"
@@ -76,11 +78,20 @@ public:
 
 private:
 
-	JPEG_MetaHandler() : exifMgr(0), psirMgr(0), iptcMgr(0), skipReconcile(false) {};	// Hidden on purpose.
+	JPEG_MetaHandler() : exifView(0), exifViewLen(0), psirView(0), psirViewLen(0),
+						 exifMgr(0), psirMgr(0), iptcMgr(0), skipReconcile(false) {};	// Hidden on purpose.
 
 	std::string exifContents;
 	std::string psirContents;
 
+	// In a read-only session on a memory mapped file, a lone Exif or PSIR segment is left in the
+	// mapping instead of being copied to the strings above. The views are null otherwise.
+	XMPFiles_IO::MappedData fileMapping;
+	XMP_Uns8 * exifView;
+	size_t     exifViewLen;
+	XMP_Uns8 * psirView;
+	size_t     psirViewLen;
+
 	TIFF_Manager * exifMgr;	// The Exif manager will be created by ProcessTNail or ProcessXMP.
 	PSIR_Manager * psirMgr;	// Need to use pointers so we can properly select between read-only and
 	IPTC_Manager * iptcMgr;	//	read-write modes of usage.
@@ -2104,8 +2104,10 @@ void MPEG4_MetaHandler::CacheFileData()
 			this->packetInfo.offset = boxPos + currBox.headerSize ;
 			this->packetInfo.length = (XMP_Int32) (currBox.contentSize);
 
-			this->xmpPacket.assign ( this->packetInfo.length, ' ' );
-			fileRef->ReadAll ( (void*)this->xmpPacket.data(), this->packetInfo.length );
+			if ( ! this->ViewMappedPacket ( this->packetInfo.offset, this->packetInfo.length ) ) {
+				this->xmpPacket.assign ( this->packetInfo.length, ' ' );
+				fileRef->ReadAll ( (void*)this->xmpPacket.data(), this->packetInfo.length );
+			}
 
 			this->xmpBoxPos = boxPos;
 			this->xmpBoxSize = (XMP_Uns32)fullUuidSize;
@@ -2145,8 +2147,8 @@ void MPEG4_MetaHandler::ProcessXMP()
 		this->containsXMP = this->havePreferredXMP = (this->packetInfo.length != 0);
 
 		if ( this->containsXMP ) {
-			FillPacketInfo ( this->xmpPacket, &this->packetInfo );
-			this->xmpObj.ParseFromBuffer ( this->xmpPacket.c_str(), (XMP_StringLen)this->xmpPacket.size() );
+			FillPacketInfo ( this->PacketPtr(), this->PacketLen(), &this->packetInfo );
+			this->xmpObj.ParseFromBuffer ( this->PacketPtr(), this->PacketLen() );
 			this->xmpObj.DeleteProperty ( kXMP_NS_XMP, "NativeDigests" );	// No longer used.
 		}
 
@@ -2175,7 +2177,11 @@ void MPEG4_MetaHandler::ProcessXMP()
 			this->packetInfo.offset = this->xmpBoxPos + this->moovMgr.GetHeaderSize ( xmpRef );
 			this->packetInfo.length = xmpInfo.contentSize;
 
-			this->xmpPacket.assign ( (char*)xmpInfo.content, this->packetInfo.length );
+			if ( openFlags & kXMPFiles_OpenForUpdate ) {
+				this->xmpPacket.assign ( (char*)xmpInfo.content, this->packetInfo.length );
+			} else {
+				this->SetPacketView ( xmpInfo.content, this->packetInfo.length );	// ! The moovMgr keeps the box content.
+			}
 			this->havePreferredXMP = (! haveISOFile);
 
 		}
@@ -2184,8 +2190,8 @@ void MPEG4_MetaHandler::ProcessXMP()
 
 	if ( this->xmpBoxPos != 0 ) {
 		this->containsXMP = true;
-		FillPacketInfo ( this->xmpPacket, &this->packetInfo );
-		this->xmpObj.ParseFromBuffer ( this->xmpPacket.c_str(), (XMP_StringLen)this->xmpPacket.size() );
+		FillPacketInfo ( this->PacketPtr(), this->PacketLen(), &this->packetInfo );
+		this->xmpObj.ParseFromBuffer ( this->PacketPtr(), this->PacketLen() );
 		this->xmpObj.DeleteProperty ( kXMP_NS_XMP, "NativeDigests" );	// No longer used.
 	}
 
@@ -3036,7 +3042,8 @@ void MPEG4_MetaHandler::UpdateFile ( bool doSafeUpdate )
 //
 // Since the XMP and legacy is probably a miniscule part of the entire file, and since we can't
 // change the offset of most of the boxes, just copy the entire original file to the temp file, then
-// do an in-place update to the temp file.
+// do an in-place update to the temp file. For a local file the copy is a reflink clone when the
+// file system allows, then only the patched blocks of the temp get new storage.
 
 void MPEG4_MetaHandler::WriteTempFile ( XMP_IO* tempRef )
 {
@@ -3045,11 +3052,18 @@ void MPEG4_MetaHandler::WriteTempFile ( XMP_IO* tempRef )
 	XMP_IO* originalRef = this->parent->ioRef;
 	XMP_ProgressTracker* progressTracker = this->parent->progressTracker;
 
+	bool cloned = false;
+	if ( this->parent->UsesLocalIO() && ((XMPFiles_IO*)originalRef)->IsDerivedTemp ( tempRef ) ) {
+		cloned = ((XMPFiles_IO*)originalRef)->CloneToTemp();
+	}
+
 	tempRef->Rewind();
 	originalRef->Rewind();
 	if ( progressTracker != 0 ) progressTracker->BeginWork ( (float) originalRef->Length() );
-	XIO::Copy ( originalRef, tempRef, originalRef->Length(),
-			    this->parent->abortProc, this->parent->abortArg );
+	if ( ! cloned ) {
+		XIO::Copy ( originalRef, tempRef, originalRef->Length(),
+				    this->parent->abortProc, this->parent->abortArg );
+	}
 
 	try {
 		this->parent->ioRef = tempRef;	// ! Fool UpdateFile into using the temp file.
@@ -163,7 +163,11 @@ void PSD_MetaHandler::CacheFileData()
 		this->packetInfo.charForm  = kXMP_CharUnknown;
 		this->packetInfo.writeable = true;
 
-		this->xmpPacket.assign ( (XMP_StringPtr)xmpInfo.dataPtr, xmpInfo.dataLen );
+		if ( this->parent->openFlags & kXMPFiles_OpenForUpdate ) {
+			this->xmpPacket.assign ( (XMP_StringPtr)xmpInfo.dataPtr, xmpInfo.dataLen );
+		} else {
+			this->SetPacketView ( xmpInfo.dataPtr, xmpInfo.dataLen );	// ! The psirMgr keeps the resource data.
+		}
 
 		this->containsXMP = true;
 
@@ -236,11 +240,11 @@ void PSD_MetaHandler::ProcessXMP()
 
 	bool haveXMP = false;
 
-	if ( ! this->xmpPacket.empty() ) {
+	if ( this->PacketLen() != 0 ) {
 		XMP_Assert ( this->containsXMP );
 		// Common code takes care of packetInfo.charForm, .padSize, and .writeable.
-		XMP_StringPtr packetStr = this->xmpPacket.c_str();
-		XMP_StringLen packetLen = (XMP_StringLen)this->xmpPacket.size();
+		XMP_StringPtr packetStr = this->PacketPtr();
+		XMP_StringLen packetLen = this->PacketLen();
 		try {
 			this->xmpObj.ParseFromBuffer ( packetStr, packetLen );
 		} catch ( ... ) { /* Ignore parsing failures, someday we hope to get partial XMP back. */ }
@@ -63,7 +63,7 @@ bool PostScript_CheckFormat ( XMP_FileFormat format,
 // ==============================================
 
 PostScript_MetaHandler::PostScript_MetaHandler ( XMPFiles * _parent ):dscFlags(0),docInfoFlags(0)
-	,containsXMPHint(false),fileformat(kXMP_UnknownFile)
+	,containsXMPHint(false),fileformat(kXMP_UnknownFile),firstPacketPending(false)
 {
 	this->parent = _parent;
 	this->handlerFlags = kPostScript_HandlerFlags;
@@ -301,9 +301,32 @@ bool PostScript_MetaHandler::FindFirstPacket()
 // PostScript_MetaHandler::FindLastPacket
 // ======================================
 //
-// Run the packet scanner backwards until we find the start of a packet, or a valid packet. If we
-// found a packet start, resume forward scanning to see if it is a valid packet. For simplicity, all
-// of the snips are checked on each pass, for much the same reasons as in FindFirstPacket.
+// Scan a window at the end of the file for valid packets, doubling the window toward the start of
+// the file until one is found. The last packet is almost always near the end, so a large file is
+// not read in full. The window scan starts outside of any packet, which is what a full scan sees
+// unless a header before the window has no trailer of its own. A full scan runs such a packet up to
+// the first trailer in the window, swallowing the packet that ends there, where the window scan
+// reports that inner packet. Packets after that first trailer are found the same either way. So the
+// last packet differs only if it is the first one in the window, and then the window picks the well
+// formed inner packet over the span from the stray header. Telling the two apart would need a scan
+// of everything before the window. The first packet is only known if the window grew to cover the
+// whole file, otherwise it is found later if it is needed.
+//
+// A bigger window only reads the part in front of the previous one, the previous part held no valid
+// packet. The scan goes on into the previous part just while a packet from the new part is open,
+// a packet that crosses the old window start. So a file without a valid packet is read once.
+
+static bool PacketIsOpenAt ( XMPScanner & scanner, XMP_Int64 scanEnd, XMPScanner::SnipInfoVector & snips )
+{
+	// True if the snip that ends at scanEnd holds the start of an unfinished packet.
+
+	scanner.Report ( snips );
+	for ( size_t i = 0, limit = snips.size(); i < limit; ++i ) {
+		if ( (snips[i].fOffset + snips[i].fLength) == scanEnd ) return (snips[i].fState == XMPScanner::ePartialPacketSnip);
+	}
+	return false;
+
+}	// PacketIsOpenAt
 
 bool PostScript_MetaHandler::FindLastPacket()
 {
@@ -313,66 +336,86 @@ bool PostScript_MetaHandler::FindLastPacket()
 	XMP_Int64   fileLen = fileRef->Length();
 	XMP_PacketInfo & packetInfo = this->packetInfo;
 
-	// ------------------------------------------------------
-	// Scan the entire file to find all of the valid packets.
-
-	XMPScanner	scanner ( fileLen );
-
 	enum { kBufferSize = 64*1024 };
 	XMP_Uns8	buffer [kBufferSize];
 
+	enum { kTailWindowSize = 1024*1024 };
+	XMP_Int64 windowSize = kTailWindowSize;
+	XMP_Int64 scannedStart = fileLen;	// The start of the part scanned by the previous windows.
+
 	XMP_AbortProc abortProc  = this->parent->abortProc;
 	void *        abortArg   = this->parent->abortArg;
 	const bool    checkAbort = (abortProc != 0);
 
-	fileRef->Rewind();	// Seek back to the beginning of the file.
+	XMPScanner::SnipInfoVector snips;
 
-	for ( bufPos = 0; bufPos < (size_t)fileLen; bufPos += bufLen )
-	{
-		if ( checkAbort && abortProc(abortArg) ) 
-		{
-			XMP_Throw ( "PostScript_MetaHandler::FindLastPacket - User abort", kXMPErr_UserAbort );
-		}
-		bufLen = fileRef->Read ( buffer, kBufferSize );
-		if ( bufLen == 0 ) XMP_Throw ( "PostScript_MetaHandler::FindLastPacket: Read failure", kXMPErr_ExternalFailure );
-		scanner.Scan ( buffer, bufPos, bufLen );
-	}
+	while ( true ) {
 
-	// -------------------------------
-	// Pick the last the valid packet.
+		// -------------------------------------------------------
+		// Scan the window to find all of its valid packets.
 
-	int snipCount = scanner.GetSnipCount();
+		XMP_Int64 windowStart = 0;
+		if ( windowSize < fileLen ) windowStart = fileLen - windowSize;
 
-	XMPScanner::SnipInfoVector snips ( snipCount );
-	scanner.Report ( snips );
+		XMPScanner	scanner ( fileLen );
+		fileRef->Seek ( windowStart, kXMP_SeekFromStart );
 
-	bool lastfound=false;
-	for ( int i = 0; i < snipCount; ++i ) 
-	{
-		if ( snips[i].fState == XMPScanner::eValidPacketSnip ) 
+		for ( bufPos = (size_t)windowStart; bufPos < (size_t)fileLen; bufPos += bufLen )
 		{
-			if (!lastfound)
+			if ( checkAbort && abortProc(abortArg) ) 
 			{
-				if ( snips[i].fLength > 0x7FFFFFFF ) XMP_Throw ( "PostScript_MetaHandler::FindLastPacket: Oversize packet", kXMPErr_BadXMP );
-				packetInfo.offset = snips[i].fOffset;
-				packetInfo.length = (XMP_Int32)snips[i].fLength;
-				packetInfo.charForm  = snips[i].fCharForm;
-				packetInfo.writeable = (snips[i].fAccess == 'w');
-				firstPacketInfo=packetInfo;
-				lastPacketInfo=packetInfo;
-				lastfound=true;
+				XMP_Throw ( "PostScript_MetaHandler::FindLastPacket - User abort", kXMPErr_UserAbort );
 			}
-			else
-			{					
-				lastPacketInfo.offset = snips[i].fOffset;
-				lastPacketInfo.length = (XMP_Int32)snips[i].fLength;
-				lastPacketInfo.charForm  = snips[i].fCharForm;
-				lastPacketInfo.writeable = (snips[i].fAccess == 'w');
-				packetInfo=lastPacketInfo;
+			if ( ((XMP_Int64)bufPos >= scannedStart) && (! PacketIsOpenAt ( scanner, bufPos, snips )) ) break;
+			size_t readLen = kBufferSize;
+			if ( ((XMP_Int64)bufPos < scannedStart) && ((scannedStart - (XMP_Int64)bufPos) < kBufferSize) ) readLen = (size_t)(scannedStart - bufPos);
+			bufLen = fileRef->Read ( buffer, (XMP_Uns32)readLen );
+			if ( bufLen == 0 ) XMP_Throw ( "PostScript_MetaHandler::FindLastPacket: Read failure", kXMPErr_ExternalFailure );
+			scanner.Scan ( buffer, bufPos, bufLen );
+		}
+		scannedStart = windowStart;
+
+		// -------------------------------
+		// Pick the last the valid packet.
+
+		int snipCount = scanner.GetSnipCount();
+		scanner.Report ( snips );
+
+		bool lastfound=false;
+		for ( int i = 0; i < snipCount; ++i ) 
+		{
+			if ( snips[i].fState == XMPScanner::eValidPacketSnip ) 
+			{
+				if (!lastfound)
+				{
+					if ( snips[i].fLength > 0x7FFFFFFF ) XMP_Throw ( "PostScript_MetaHandler::FindLastPacket: Oversize packet", kXMPErr_BadXMP );
+					packetInfo.offset = snips[i].fOffset;
+					packetInfo.length = (XMP_Int32)snips[i].fLength;
+					packetInfo.charForm  = snips[i].fCharForm;
+					packetInfo.writeable = (snips[i].fAccess == 'w');
+					firstPacketInfo=packetInfo;
+					lastPacketInfo=packetInfo;
+					lastfound=true;
+				}
+				else
+				{					
+					lastPacketInfo.offset = snips[i].fOffset;
+					lastPacketInfo.length = (XMP_Int32)snips[i].fLength;
+					lastPacketInfo.charForm  = snips[i].fCharForm;
+					lastPacketInfo.writeable = (snips[i].fAccess == 'w');
+					packetInfo=lastPacketInfo;
+				}
 			}
 		}
+
+		if ( windowStart == 0 ) return lastfound;
+		if ( lastfound ) {
+			this->firstPacketPending = true;	// There might be earlier packets before the window.
+			return true;
+		}
+		windowSize *= 2;
+
 	}
-	return lastfound;
 
 }	// PostScript_MetaHandler::FindLastPacket
 
@@ -1533,6 +1576,15 @@ void PostScript_MetaHandler::DetermineInsertionOffsets(XMP_Int64& ADOhintOffset,
 	}
 	else
 	{
+		if ( this->firstPacketPending ) {
+			// FindLastPacket only scanned the end of the file, find the first packet now.
+			XMP_PacketInfo savedPacketInfo = this->packetInfo;
+			XMP_PacketInfo savedLastPacketInfo = this->lastPacketInfo;
+			FindFirstPacket();
+			this->packetInfo = savedPacketInfo;
+			this->lastPacketInfo = savedLastPacketInfo;
+			this->firstPacketPending = false;
+		}
 		xpacketLoc = (XMP_Uns64)firstPacketInfo.offset;
 		TokenLocation& endPagsetuploc = getTokenInfo(kPS_EndPageSetup);
 		if ( (endPagsetuploc.offsetStart > -1) && (xpacketLoc > (XMP_Uns64)endPagsetuploc.offsetStart) )
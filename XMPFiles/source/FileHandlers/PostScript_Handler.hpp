@@ -139,6 +139,8 @@ private:
 	XMP_PacketInfo firstPacketInfo;	
 	//keep the last packet info
 	XMP_PacketInfo lastPacketInfo;	
+	//the first packet info is not known yet, FindLastPacket only scanned the end of the file
+	bool firstPacketPending;
 
 };	// PostScript_MetaHandler
 
@@ -20,6 +20,8 @@
 #include "XMPFiles/source/FileHandlers/Scanner_Handler.hpp"
 
 #include <vector>
+#include <atomic>
+#include <thread>
 
 using namespace std;
 
@@ -39,6 +41,196 @@ struct CandidateInfo {
 	SXMPMeta *     xmpObj;
 };
 
+// =================================================================================================
+// Parallel scanning
+// =================
+//
+// With kXMPFiles_OpenParallelScan a large local file is split into ranges that are scanned on
+// separate threads, using positional reads of the shared XMPFiles_IO. A range's scan continues past
+// its end while a possible packet that started inside the range is unfinished, so a packet crossing
+// a boundary is found whole by the range it starts in. The packets are merged in file order, a
+// packet that starts inside one already taken is dropped, as a sequential scan would never see it.
+// Likewise a packet header without its own trailer runs to the next one, hiding what it swallows.
+//
+// The number of ranges is limited by the number of hardware threads. The tests override that count
+// with Scanner_SetParallelScanThreads, so the parallel path can be tested anywhere.
+
+enum {
+	kScanBufferSize       = 64*1024,
+	kMinParallelScanRange = 16*1024*1024,	// Smaller files are scanned sequentially.
+	kMaxParallelScanRanges = 16
+};
+
+struct ScanRangeInfo {
+	const XMPFiles_IO *         fileRef;
+	XMP_Int64                   fileLen;
+	XMP_Int64                   rangeStart;
+	XMP_Int64                   rangeEnd;
+	std::atomic<bool> *         stop;
+	XMP_AbortProc               abortProc;	// Only for the range scanned by the calling thread.
+	void *                      abortArg;
+	XMPScanner::SnipInfoVector  packets;
+	XMP_Int64                   openPacket;	// Start of a packet in the range that is open at EOF, or -1.
+	XMP_Error *                 error;
+	ScanRangeInfo() : fileRef(0), fileLen(0), rangeStart(0), rangeEnd(0), stop(0), abortProc(0), abortArg(0),
+					  openPacket(-1), error(0) {};
+};
+
+// =================================================================================================
+// ScanRange
+// =========
+
+static void ScanRange ( ScanRangeInfo * info )
+{
+	try {
+
+		XMPScanner scanner ( info->fileLen );
+		std::vector<XMP_Uns8> buffer ( kScanBufferSize );
+		XMPScanner::SnipInfoVector snips;
+
+		XMP_Int64 bufPos = info->rangeStart;
+		XMP_Int64 scanEnd = info->rangeEnd;
+
+		while ( bufPos < scanEnd ) {
+
+			if ( info->stop->load() ) return;
+			if ( (info->abortProc != 0) && info->abortProc ( info->abortArg ) ) {
+				info->stop->store ( true );
+				XMP_Throw ( "Scanner_MetaHandler::LocateXMP - User abort", kXMPErr_UserAbort );
+			}
+
+			XMP_Uns32 bufLen = kScanBufferSize;
+			if ( (scanEnd - bufPos) < bufLen ) bufLen = (XMP_Uns32) (scanEnd - bufPos);
+			bufLen = info->fileRef->ReadAt ( bufPos, &buffer[0], bufLen );
+			if ( bufLen == 0 ) XMP_Throw ( "Scanner_MetaHandler::LocateXMP: Read failure", kXMPErr_ExternalFailure );
+			scanner.Scan ( &buffer[0], bufPos, bufLen );
+			bufPos += bufLen;
+
+			if ( (bufPos == scanEnd) && (scanEnd < info->fileLen) ) {
+				// Keep going one buffer at a time while a packet started inside the range is open.
+				scanner.Report ( snips );
+				for ( size_t i = 0; i < snips.size(); ++i ) {
+					if ( snips[i].fState != XMPScanner::ePartialPacketSnip ) continue;
+					if ( snips[i].fOffset >= info->rangeEnd ) continue;
+					scanEnd += kScanBufferSize;
+					if ( scanEnd > info->fileLen ) scanEnd = info->fileLen;
+					break;
+				}
+			}
+
+		}
+
+		scanner.Report ( snips );
+		for ( size_t i = 0; i < snips.size(); ++i ) {
+			if ( snips[i].fOffset >= info->rangeEnd ) continue;
+			if ( snips[i].fState == XMPScanner::ePartialPacketSnip ) info->openPacket = snips[i].fOffset;
+			if ( (snips[i].fState != XMPScanner::eValidPacketSnip) && (snips[i].fState != XMPScanner::eBadPacketSnip) ) continue;
+			info->packets.push_back ( snips[i] );
+			info->packets.back().fEncodingAttr = "";	// ! Owned by this scanner.
+		}
+
+	} catch ( XMP_Error & excep ) {
+		info->stop->store ( true );
+		info->error = new XMP_Error ( excep );
+	} catch ( ... ) {
+		info->stop->store ( true );
+		info->error = new XMP_Error ( kXMPErr_InternalFailure, "Scanner_MetaHandler::LocateXMP: Scan failure" );
+	}
+
+}	// ScanRange
+
+// =================================================================================================
+// ParallelScanThreads
+// ===================
+
+static std::atomic<XMP_Int64> sForcedScanThreads ( 0 );
+
+void Scanner_SetParallelScanThreads ( XMP_Int64 threadCount )
+{
+	sForcedScanThreads.store ( (threadCount > 0) ? threadCount : 0 );
+}
+
+static XMP_Int64 ParallelScanThreads()
+{
+	XMP_Int64 threadCount = sForcedScanThreads.load();
+	if ( threadCount > 0 ) return threadCount;
+	return std::thread::hardware_concurrency();
+
+}	// ParallelScanThreads
+
+// =================================================================================================
+// ParallelScan
+// ============
+//
+// Returns false if the file should be scanned sequentially.
+
+static bool ParallelScan ( XMPFiles * parent, XMP_Int64 fileLen, XMPScanner::SnipInfoVector * snips )
+{
+	if ( XMP_OptionIsClear ( parent->openFlags, kXMPFiles_OpenParallelScan ) ) return false;
+	if ( ! parent->UsesLocalIO() ) return false;	// ! Need the thread safe XMPFiles_IO::ReadAt.
+
+	XMP_Int64 rangeCount = fileLen / kMinParallelScanRange;
+	XMP_Int64 threadCount = ParallelScanThreads();
+	if ( rangeCount > threadCount ) rangeCount = threadCount;
+	if ( rangeCount > kMaxParallelScanRanges ) rangeCount = kMaxParallelScanRanges;
+	if ( rangeCount < 2 ) return false;
+
+	std::atomic<bool> stop ( false );
+	std::vector<ScanRangeInfo> ranges ( (size_t)rangeCount );
+	XMP_Int64 rangeSize = ((fileLen / rangeCount) + kScanBufferSize - 1) & ~((XMP_Int64)kScanBufferSize - 1);
+
+	for ( size_t r = 0; r < ranges.size(); ++r ) {
+		ScanRangeInfo & range = ranges[r];
+		range.fileRef = (const XMPFiles_IO*) parent->ioRef;
+		range.fileLen = fileLen;
+		range.rangeStart = r * rangeSize;
+		range.rangeEnd = (r == (ranges.size() - 1)) ? fileLen : (range.rangeStart + rangeSize);
+		if ( range.rangeEnd > fileLen ) range.rangeEnd = fileLen;
+		if ( range.rangeStart > range.rangeEnd ) range.rangeStart = range.rangeEnd;
+		range.stop = &stop;
+	}
+	ranges[0].abortProc = parent->abortProc;
+	ranges[0].abortArg = parent->abortArg;
+
+	std::vector<std::thread> workers;
+	try {
+		for ( size_t r = 1; r < ranges.size(); ++r ) workers.push_back ( std::thread ( ScanRange, &ranges[r] ) );
+	} catch ( ... ) {
+		stop.store ( true );	// Could not start all of the threads, give up on the parallel scan.
+		for ( size_t t = 0; t < workers.size(); ++t ) workers[t].join();
+		for ( size_t r = 0; r < ranges.size(); ++r ) delete ranges[r].error;
+		return false;
+	}
+	ScanRange ( &ranges[0] );
+	for ( size_t t = 0; t < workers.size(); ++t ) workers[t].join();
+
+	XMP_Error * firstError = 0;
+	for ( size_t r = 0; r < ranges.size(); ++r ) {
+		if ( ranges[r].error == 0 ) continue;
+		if ( (firstError == 0) || (ranges[r].error->GetID() == kXMPErr_UserAbort) ) firstError = ranges[r].error;
+	}
+	if ( firstError != 0 ) {
+		XMP_Error error ( *firstError );
+		for ( size_t r = 0; r < ranges.size(); ++r ) delete ranges[r].error;
+		throw error;
+	}
+
+	XMP_Int64 coveredEnd = 0;
+	snips->clear();
+	for ( size_t r = 0; r < ranges.size(); ++r ) {
+		const XMPScanner::SnipInfoVector & packets = ranges[r].packets;
+		for ( size_t i = 0; i < packets.size(); ++i ) {
+			if ( packets[i].fOffset < coveredEnd ) continue;
+			snips->push_back ( packets[i] );
+			coveredEnd = packets[i].fOffset + packets[i].fLength;
+		}
+		if ( (ranges[r].openPacket >= 0) && (ranges[r].openPacket >= coveredEnd) ) break;	// It swallows the rest.
+	}
+
+	return true;
+
+}	// ParallelScan
+
 // =================================================================================================
 // Scanner_MetaHandlerCTor
 // =======================
@@ -247,29 +439,35 @@ void Scanner_MetaHandler::CacheFileData()
 		// Scan the entire file to find all of the valid packets.
 
 		XMP_Int64  fileLen = fileRef->Length();
-		XMPScanner scanner ( fileLen );
 
-		enum { kBufferSize = 64*1024 };
+		enum { kBufferSize = kScanBufferSize };
 		XMP_Uns8	buffer [kBufferSize];
 
-		fileRef->Rewind();
+		XMPScanner::SnipInfoVector snips;
 
-		for ( bufPos = 0; bufPos < fileLen; bufPos += bufLen ) {
-			if ( checkAbort && abortProc(abortArg) ) {
-				XMP_Throw ( "Scanner_MetaHandler::LocateXMP - User abort", kXMPErr_UserAbort );
+		if ( ! ParallelScan ( this->parent, fileLen, &snips ) ) {
+
+			XMPScanner scanner ( fileLen );
+
+			fileRef->Rewind();
+
+			for ( bufPos = 0; bufPos < fileLen; bufPos += bufLen ) {
+				if ( checkAbort && abortProc(abortArg) ) {
+					XMP_Throw ( "Scanner_MetaHandler::LocateXMP - User abort", kXMPErr_UserAbort );
+				}
+				bufLen = fileRef->Read ( buffer, kBufferSize );
+				if ( bufLen == 0 ) XMP_Throw ( "Scanner_MetaHandler::LocateXMP: Read failure", kXMPErr_ExternalFailure );
+				scanner.Scan ( buffer, bufPos, bufLen );
 			}
-			bufLen = fileRef->Read ( buffer, kBufferSize );
-			if ( bufLen == 0 ) XMP_Throw ( "Scanner_MetaHandler::LocateXMP: Read failure", kXMPErr_ExternalFailure );
-			scanner.Scan ( buffer, bufPos, bufLen );
+
+			scanner.Report ( snips );
+
 		}
 
 		// --------------------------------------------------------------
 		// Parse the valid packet snips, building a vector of candidates.
 
-		long snipCount = scanner.GetSnipCount();
-
-		XMPScanner::SnipInfoVector snips ( snipCount );
-		scanner.Report ( snips );
+		long snipCount = (long) snips.size();
 
 		for ( pkt = 0; pkt < snipCount; ++pkt ) {
 
@@ -24,6 +24,9 @@ extern XMPFileHandler * Scanner_MetaHandlerCTor ( XMPFiles * parent );
 
 static const XMP_OptionBits kScanner_HandlerFlags = kTrivial_HandlerFlags;
 
+// Only for testing, overrides the hardware thread count for parallel scans. Zero restores it.
+extern void Scanner_SetParallelScanThreads ( XMP_Int64 threadCount );
+
 class Scanner_MetaHandler : public Trivial_MetaHandler
 {
 public:
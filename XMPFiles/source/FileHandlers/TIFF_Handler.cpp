@@ -156,7 +156,11 @@ void TIFF_MetaHandler::CacheFileData()
 		this->packetInfo.charForm  = kXMP_CharUnknown;
 		this->packetInfo.writeable = true;
 
-		this->xmpPacket.assign ( (XMP_StringPtr)xmpInfo.dataPtr, xmpInfo.dataLen );
+		if ( this->parent->openFlags & kXMPFiles_OpenForUpdate ) {
+			this->xmpPacket.assign ( (XMP_StringPtr)xmpInfo.dataPtr, xmpInfo.dataLen );
+		} else {
+			this->SetPacketView ( xmpInfo.dataPtr, xmpInfo.dataLen );	// ! The tiffMgr keeps the tag data.
+		}
 
 		this->containsXMP = true;
 
@@ -205,7 +209,7 @@ void TIFF_MetaHandler::ProcessXMP()
 	bool havePSIR = tiff.GetTag ( kTIFF_PrimaryIFD, kTIFF_PSIR, &psirInfo );
 
 	if ( havePSIR ) {	// ! Do the Photoshop 6 integration before other legacy analysis.
-		psir.ParseMemoryResources ( psirInfo.dataPtr, psirInfo.dataLen );
+		psir.ParseMemoryResources ( psirInfo.dataPtr, psirInfo.dataLen, (! readOnly) /* copyData */ );	// ! The TIFF manager owns the data.
 		PSIR_Manager::ImgRsrcInfo buriedExif;
 		found = psir.GetImgRsrc ( kPSIR_Exif, &buriedExif );
 		if ( found ) {
@@ -258,11 +262,11 @@ void TIFF_MetaHandler::ProcessXMP()
 
 	bool haveXMP = false;
 
-	if ( ! this->xmpPacket.empty() ) {
+	if ( this->PacketLen() != 0 ) {
 		XMP_Assert ( this->containsXMP );
 		// Common code takes care of packetInfo.charForm, .padSize, and .writeable.
-		XMP_StringPtr packetStr = this->xmpPacket.c_str();
-		XMP_StringLen packetLen = (XMP_StringLen)this->xmpPacket.size();
+		XMP_StringPtr packetStr = this->PacketPtr();
+		XMP_StringLen packetLen = this->PacketLen();
 		try {
 			this->xmpObj.ParseFromBuffer ( packetStr, packetLen );
 		} catch ( ... ) { /* Ignore parsing failures, someday we hope to get partial XMP back. */ }
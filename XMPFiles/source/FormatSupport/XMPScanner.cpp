@@ -23,6 +23,7 @@
 
 
 #include "XMPFiles/source/FormatSupport/XMPScanner.hpp"
+#include "source/XMP_VectorScan.hpp"
 
 #include <cassert>
 #include <string>
@@ -63,7 +64,7 @@ using namespace std;
 // The state functions are responsible for consuming input to recognize their particular state.
 // This includes intervening nulls for 16 and 32 bit character forms.  For the simplicity, things
 // are treated as essentially little endian and the nulls are not actually checked.  The opening
-// '<' is found with a byte-by-byte search, then the number of bytes per character is determined
+// '<' is found with a (vectorized) byte search, then the number of bytes per character is determined
 // by counting the following nulls.  From then on, consuming a character means incrementing the
 // buffer pointer by the number of bytes per character.  Thus the buffer pointer only points to
 // the "real" bytes.  This also means that the pointer can go off the end of the buffer by a
@@ -169,6 +170,138 @@ XMPScanner::PacketMachine::ResetMachine ()
 
 }	// ResetMachine
 
+// =================================================================================================
+// RestartMachine
+// ==============
+//
+// Put a pooled machine back in the state of a newly constructed one. The strings keep their
+// storage, which is the point of reusing the machines.
+
+void
+XMPScanner::PacketMachine::RestartMachine ( XMP_Int64 bufferOffset, const void * bufferOrigin, XMP_Int64 bufferLength )
+{
+
+	assert ( bufferOrigin != NULL );
+	assert ( bufferLength != 0 );
+
+	this->ResetMachine();
+	fPacketStart = 0;
+	fPacketLength = 0;
+	fQuoteChar = ' ';
+	this->AssociateBuffer ( bufferOffset, bufferOrigin, bufferLength );
+
+}	// RestartMachine
+
+// =================================================================================================
+// FindPacketLessThan
+// ==================
+//
+// Find the next '<' that might open a packet header or trailer, the byte-by-byte search is a hot
+// spot when scanning large files. Only the '<' characters at a multiple of bytesPerChar from the
+// start are considered, and one is skipped if the next character is definitely wrong: the header
+// and trailer both continue with '?', and for the header a nul means a 16 or 32 bit form. Skipping
+// is safe because the following MatchString would fail on that character anyway. A '<' too close
+// to the limit to look at the next character is returned. If nothing is found this returns the
+// first character position at or past the limit.
+
+static const char *
+FindPacketLessThanBytes ( const char * ptr, const char * limit, int bytesPerChar, bool allowNull )
+{
+
+	for ( ; ptr < limit; ptr += bytesPerChar ) {
+		if ( *ptr != '<' ) continue;
+		if ( (limit - ptr) <= bytesPerChar ) return ptr;
+		const char next = ptr[bytesPerChar];
+		if ( (next == '?') || (allowNull && (next == 0)) ) return ptr;
+	}
+
+	return ptr;	// ! Can be past the limit for 16 and 32 bit characters.
+
+}	// FindPacketLessThanBytes
+
+static inline XMP_Uns32 CharStartMask ( int bytesPerChar )
+{
+	if ( bytesPerChar == 1 ) return 0xFFFFFFFFUL;
+	if ( bytesPerChar == 2 ) return 0x55555555UL;
+	return 0x11111111UL;
+}
+
+#if ScanWithSSE2
+
+static const char *
+FindPacketLessThanSSE2 ( const char * ptr, const char * limit, int bytesPerChar, bool allowNull )
+{
+	const __m128i lessThan = _mm_set1_epi8 ( '<' );
+	const __m128i question = _mm_set1_epi8 ( '?' );
+	const __m128i nulls = allowNull ? _mm_setzero_si128() : question;
+	const XMP_Uns32 charMask = CharStartMask ( bytesPerChar ) & 0xFFFF;
+
+	for ( ; (limit - ptr) >= (16 + bytesPerChar); ptr += 16 ) {
+		__m128i curr = _mm_loadu_si128 ( (const __m128i*) ptr );
+		__m128i next = _mm_loadu_si128 ( (const __m128i*) (ptr + bytesPerChar) );
+		__m128i follow = _mm_or_si128 ( _mm_cmpeq_epi8 ( next, question ), _mm_cmpeq_epi8 ( next, nulls ) );
+		XMP_Uns32 found = (XMP_Uns32) _mm_movemask_epi8 ( _mm_and_si128 ( _mm_cmpeq_epi8 ( curr, lessThan ), follow ) );
+		found &= charMask;
+		if ( found != 0 ) return ptr + LowBitIndex ( found );
+	}
+
+	return ptr;	// ! The caller finishes the tail.
+
+}	// FindPacketLessThanSSE2
+
+#endif
+
+#if ScanWithAVX2
+
+__attribute__ (( target ( "avx2" ) ))
+static const char *
+FindPacketLessThanAVX2 ( const char * ptr, const char * limit, int bytesPerChar, bool allowNull )
+{
+	const __m256i lessThan = _mm256_set1_epi8 ( '<' );
+	const __m256i question = _mm256_set1_epi8 ( '?' );
+	const __m256i nulls = allowNull ? _mm256_setzero_si256() : question;
+	const XMP_Uns32 charMask = CharStartMask ( bytesPerChar );
+
+	for ( ; (limit - ptr) >= (32 + bytesPerChar); ptr += 32 ) {
+		__m256i curr = _mm256_loadu_si256 ( (const __m256i*) ptr );
+		__m256i next = _mm256_loadu_si256 ( (const __m256i*) (ptr + bytesPerChar) );
+		__m256i follow = _mm256_or_si256 ( _mm256_cmpeq_epi8 ( next, question ), _mm256_cmpeq_epi8 ( next, nulls ) );
+		XMP_Uns32 found = (XMP_Uns32) _mm256_movemask_epi8 ( _mm256_and_si256 ( _mm256_cmpeq_epi8 ( curr, lessThan ), follow ) );
+		found &= charMask;
+		if ( found != 0 ) return ptr + LowBitIndex ( found );
+	}
+
+	return ptr;	// ! The caller finishes the tail.
+
+}	// FindPacketLessThanAVX2
+
+#endif
+
+static int sMaxVectorBytes = 32;
+
+void XMPScanner::LimitVectorSearch ( int maxBytes )
+{
+	sMaxVectorBytes = maxBytes;
+}
+
+static const char *
+FindPacketLessThan ( const char * ptr, const char * limit, int bytesPerChar, bool allowNull )
+{
+	// Each form stops at a match or where it can't look further, a match stops all of them. They all
+	// step by a multiple of bytesPerChar, so the character alignment is kept.
+
+	#if ScanWithAVX2
+		if ( (sMaxVectorBytes >= 32) && HaveAVX2() ) ptr = FindPacketLessThanAVX2 ( ptr, limit, bytesPerChar, allowNull );
+	#endif
+
+	#if ScanWithSSE2
+		if ( sMaxVectorBytes >= 16 ) ptr = FindPacketLessThanSSE2 ( ptr, limit, bytesPerChar, allowNull );
+	#endif
+
+	return FindPacketLessThanBytes ( ptr, limit, bytesPerChar, allowNull );
+
+}	// FindPacketLessThan
+
 // =================================================================================================
 // FindLessThan
 // ============
@@ -186,10 +319,8 @@ XMPScanner::PacketMachine::FindLessThan ( PacketMachine * ths, const char * whic
 		ths->fCharForm = eChar8Bit;	// We might have just failed from a bogus 16 or 32 bit case.
 		ths->fBytesPerChar = 1;
 
-		while ( ths->fBufferPtr < ths->fBufferLimit ) {	// Don't skip nulls for the header's '<'!
-			if ( *ths->fBufferPtr == '<' ) break;
-			ths->fBufferPtr++;
-		}
+		// Don't skip nulls for the header's '<'!
+		ths->fBufferPtr = FindPacketLessThan ( ths->fBufferPtr, ths->fBufferLimit, 1, true );
 
 		if ( ths->fBufferPtr >= ths->fBufferLimit ) return eTriNo;
 		ths->fBufferPtr++;
@@ -204,10 +335,7 @@ XMPScanner::PacketMachine::FindLessThan ( PacketMachine * ths, const char * whic
 
 		const int bytesPerChar = ths->fBytesPerChar;
 
-		while ( ths->fBufferPtr < ths->fBufferLimit ) {
-			if ( *ths->fBufferPtr == '<' ) break;
-			ths->fBufferPtr += bytesPerChar;
-		}
+		ths->fBufferPtr = FindPacketLessThan ( ths->fBufferPtr, ths->fBufferLimit, bytesPerChar, false );
 
 		if ( ths->fBufferPtr >= ths->fBufferLimit ) return eTriMaybe;
 		ths->fBufferPtr += bytesPerChar;
@@ -418,6 +546,14 @@ XMPScanner::PacketMachine::TriState
 XMPScanner::PacketMachine::RecordStart ( PacketMachine * ths, const char * /* unused */ )
 {
 
+	if ( ths->fPosition == 0 ) {	// Record the start, even if the '<' ends the buffer.
+		assert ( ths->fCharForm == eChar8Bit );
+		assert ( ths->fBytesPerChar == 1 );
+		ths->fPacketStart = ths->fBufferOffset + ((ths->fBufferPtr - 1) - ths->fBufferOrigin);
+		ths->fPacketLength = 0;
+		ths->fPosition = 1;
+	}
+
 	while ( true ) {
 
 		if ( ths->fBufferPtr >= ths->fBufferLimit ) return eTriMaybe;
@@ -426,14 +562,6 @@ XMPScanner::PacketMachine::RecordStart ( PacketMachine * ths, const char * /* un
 
 		switch ( ths->fPosition ) {
 
-			case 0 :	// Record the length.
-				assert ( ths->fCharForm == eChar8Bit );
-				assert ( ths->fBytesPerChar == 1 );
-				ths->fPacketStart = ths->fBufferOffset + ((ths->fBufferPtr - 1) - ths->fBufferOrigin);
-				ths->fPacketLength = 0;
-				ths->fPosition = 1;
-				// ! OK to fall through here, we didn't consume a byte in this step.
-
 			case 1 :	// Look for the first null byte.
 				if ( currByte != 0 ) return eTriYes;	// No nulls found.
 				ths->fCharForm = eChar16BitBig;			// Assume 16 bit big endian for now.
@@ -975,7 +1103,8 @@ XMPScanner::PacketMachine::FindNextPacket ()
 // InternalSnip
 // ============
 
-XMPScanner::InternalSnip::InternalSnip ( XMP_Int64 offset, XMP_Int64 length )
+XMPScanner::InternalSnip::InternalSnip ( XMP_Int64 offset, XMP_Int64 length ) :
+	fMachine ( 0 )
 {
 
 	fInfo.fOffset = offset;
@@ -983,28 +1112,6 @@ XMPScanner::InternalSnip::InternalSnip ( XMP_Int64 offset, XMP_Int64 length )
 
 }	// InternalSnip
 
-// =================================================================================================
-// InternalSnip
-// ============
-
-XMPScanner::InternalSnip::InternalSnip ( const InternalSnip & rhs ) :
-	fInfo ( rhs.fInfo ),
-	fMachine ()
-{
-
-	assert ( rhs.fMachine.get() == NULL );	// Don't copy a snip with a machine.
-	assert ( (rhs.fInfo.fEncodingAttr == 0) || (*rhs.fInfo.fEncodingAttr == 0) ); // Don't copy a snip with an encoding.
-
-}	// InternalSnip
-
-// =================================================================================================
-// ~InternalSnip
-// =============
-
-XMPScanner::InternalSnip::~InternalSnip ()
-{
-}	// ~InternalSnip
-
 
 // =================================================================================================
 // =================================================================================================
@@ -1022,13 +1129,11 @@ static const char *	snipStateName [6] = { "not-seen", "pending", "raw-data", "go
 void
 XMPScanner::DumpSnipList ( const char * title )
 {
-	InternalSnipIterator currPos = fInternalSnips.begin();
-	InternalSnipIterator endPos  = fInternalSnips.end();
 
 	cout << endl << title << " snip list: " << fInternalSnips.size() << endl;
 
-	for ( ; currPos != endPos; ++currPos ) {
-		SnipInfo * currSnip = &currPos->fInfo;
+	for ( size_t i = 0; i < fInternalSnips.size(); ++i ) {
+		SnipInfo * currSnip = &fInternalSnips[i].fInfo;
 		cout << '\t' << currSnip << ' ' << snipStateName[currSnip->fState] << ' '
 		     << currSnip->fOffset << ".." << (currSnip->fOffset + currSnip->fLength - 1)
 			 << ' ' << currSnip->fLength << ' ' << endl;
@@ -1037,28 +1142,6 @@ XMPScanner::DumpSnipList ( const char * title )
 
 #endif
 
-// =================================================================================================
-// PrevSnip and NextSnip
-// =====================
-
-XMPScanner::InternalSnipIterator
-XMPScanner::PrevSnip ( InternalSnipIterator snipPos )
-{
-
-	InternalSnipIterator prev = snipPos;
-	return --prev;
-
-}	// PrevSnip
-
-XMPScanner::InternalSnipIterator
-XMPScanner::NextSnip ( InternalSnipIterator snipPos )
-{
-
-	InternalSnipIterator next = snipPos;
-	return ++next;
-
-}	// NextSnip
-
 // =================================================================================================
 // XMPScanner
 // ==========
@@ -1072,7 +1155,7 @@ XMPScanner::XMPScanner ( XMP_Int64 streamLength ) :
 {
 	InternalSnip	rootSnip ( 0, streamLength );
 
-	if ( streamLength > 0 ) fInternalSnips.push_front ( rootSnip );		// Be nice for empty files.
+	if ( streamLength > 0 ) fInternalSnips.push_back ( rootSnip );		// Be nice for empty files.
 	// DumpSnipList ( "New XMPScanner" );
 
 }	// XMPScanner
@@ -1084,6 +1167,8 @@ XMPScanner::XMPScanner ( XMP_Int64 streamLength ) :
 XMPScanner::~XMPScanner()
 {
 
+	for ( size_t i = 0; i < fMachines.size(); ++i ) delete fMachines[i];
+
 }	// ~XMPScanner
 
 // =================================================================================================
@@ -1105,16 +1190,81 @@ XMPScanner::GetSnipCount ()
 bool
 XMPScanner::StreamAllScanned ()
 {
-	InternalSnipIterator currPos = fInternalSnips.begin();
-	InternalSnipIterator endPos  = fInternalSnips.end();
 
-	for ( ; currPos != endPos; ++currPos ) {
-		if ( currPos->fInfo.fState == eNotSeenSnip ) return false;
+	for ( size_t i = 0; i < fInternalSnips.size(); ++i ) {
+		if ( fInternalSnips[i].fInfo.fState == eNotSeenSnip ) return false;
 	}
 	return true;
 
 }	// StreamAllScanned
 
+// =================================================================================================
+// AcquireMachine and ReleaseMachine
+// =================================
+//
+// A scan creates a packet machine for every buffer that does not continue a partial packet, and
+// drops it again once the buffer is done. The machines are pooled so that the churn does not go
+// through the allocator, the pool only grows to the number of machines active at once.
+
+XMPScanner::PacketMachine *
+XMPScanner::AcquireMachine ( XMP_Int64 bufferOffset, const void * bufferOrigin, XMP_Int64 bufferLength )
+{
+	PacketMachine * machine;
+
+	if ( ! fFreeMachines.empty() ) {
+		machine = fFreeMachines.back();
+		fFreeMachines.pop_back();
+		machine->RestartMachine ( bufferOffset, bufferOrigin, bufferLength );
+	} else {
+		fMachines.reserve ( fMachines.size() + 1 );
+		fFreeMachines.reserve ( fMachines.size() + 1 );	// ! So that ReleaseMachine can't throw.
+		machine = new PacketMachine ( bufferOffset, bufferOrigin, bufferLength );
+		fMachines.push_back ( machine );
+	}
+
+	return machine;
+
+}	// AcquireMachine
+
+void
+XMPScanner::ReleaseMachine ( InternalSnipIndex snipPos )
+{
+	InternalSnip & snip = fInternalSnips[snipPos];
+
+	if ( snip.fMachine != 0 ) {
+		fFreeMachines.push_back ( snip.fMachine );
+		snip.fMachine = 0;
+	}
+
+}	// ReleaseMachine
+
+// =================================================================================================
+// FindEnclosingSnip
+// =================
+//
+// Find the first snip whose end is at or beyond the given offset. The snips are in stream order
+// and contiguous, so a binary search works.
+
+XMPScanner::InternalSnipIndex
+XMPScanner::FindEnclosingSnip ( XMP_Int64 endOffset )
+{
+	InternalSnipIndex low  = 0;
+	InternalSnipIndex high = fInternalSnips.size() - 1;
+
+	while ( low < high ) {
+		InternalSnipIndex middle = low + (high - low) / 2;
+		const SnipInfo & info = fInternalSnips[middle].fInfo;
+		if ( endOffset > (info.fOffset + info.fLength - 1) ) {
+			low = middle + 1;
+		} else {
+			high = middle;
+		}
+	}
+
+	return low;
+
+}	// FindEnclosingSnip
+
 // =================================================================================================
 // SplitInternalSnip
 // =================
@@ -1122,59 +1272,61 @@ XMPScanner::StreamAllScanned ()
 // Split the given snip into up to 3 pieces.  The new pieces are inserted before and after this one
 // in the snip list.  The relOffset is the first byte to be kept, it is relative to this snip.  If
 // the preceeding or following snips have the same state as this one, just shift the boundaries.
-// I.e. move the contents from one snip to the other, don't create a new snip.
+// I.e. move the contents from one snip to the other, don't create a new snip.  The snipPos is
+// updated to keep referring to the middle piece.
 
 // *** To be thread safe we ought to lock the entire list during manipulation.  Let data scanning
 // *** happen in parallel, serialize all mucking with the list.
 
 void
-XMPScanner::SplitInternalSnip ( InternalSnipIterator snipPos, XMP_Int64 relOffset, XMP_Int64 newLength )
+XMPScanner::SplitInternalSnip ( InternalSnipIndex & snipPos, XMP_Int64 relOffset, XMP_Int64 newLength )
 {
 
 	assert ( (relOffset + newLength) > relOffset );	// Check for overflow.
-	assert ( (relOffset + newLength) <= snipPos->fInfo.fLength );
+	assert ( (relOffset + newLength) <= fInternalSnips[snipPos].fInfo.fLength );
 
 	// -----------------------------------
 	// First deal with the low offset end.
 
 	if ( relOffset > 0 ) {
 
-		InternalSnipIterator prevPos;
-		if ( snipPos != fInternalSnips.begin() ) prevPos = PrevSnip ( snipPos );
+		const SnipInfo & thisInfo = fInternalSnips[snipPos].fInfo;
 
-		if ( (snipPos != fInternalSnips.begin()) && (snipPos->fInfo.fState == prevPos->fInfo.fState) ) {
-			prevPos->fInfo.fLength += relOffset;	// Adjust the preceeding snip.
+		if ( (snipPos > 0) && (thisInfo.fState == fInternalSnips[snipPos-1].fInfo.fState) ) {
+			fInternalSnips[snipPos-1].fInfo.fLength += relOffset;	// Adjust the preceeding snip.
 		} else {
-			InternalSnip headExcess ( snipPos->fInfo.fOffset, relOffset );
-			headExcess.fInfo.fState = snipPos->fInfo.fState;
-			headExcess.fInfo.fOutOfOrder = snipPos->fInfo.fOutOfOrder;
-			fInternalSnips.insert ( snipPos, headExcess );	// Insert the head piece before the middle piece.
+			InternalSnip headExcess ( thisInfo.fOffset, relOffset );
+			headExcess.fInfo.fState = thisInfo.fState;
+			headExcess.fInfo.fOutOfOrder = thisInfo.fOutOfOrder;
+			fInternalSnips.insert ( (fInternalSnips.begin() + snipPos), headExcess );	// Insert the head piece before the middle piece.
+			++snipPos;
 		}
 
-		snipPos->fInfo.fOffset += relOffset;	// Adjust the remainder of this snip.
-		snipPos->fInfo.fLength -= relOffset;
+		fInternalSnips[snipPos].fInfo.fOffset += relOffset;	// Adjust the remainder of this snip.
+		fInternalSnips[snipPos].fInfo.fLength -= relOffset;
 
 	}
 
 	// ----------------------------------
 	// Now deal with the high offset end.
 
-	if ( newLength < snipPos->fInfo.fLength ) {
+	if ( newLength < fInternalSnips[snipPos].fInfo.fLength ) {
 
-		InternalSnipIterator nextPos    = NextSnip ( snipPos );
-		const XMP_Int64      tailLength = snipPos->fInfo.fLength - newLength;
+		const InternalSnipIndex nextPos    = snipPos + 1;
+		const SnipInfo &        thisInfo   = fInternalSnips[snipPos].fInfo;
+		const XMP_Int64         tailLength = thisInfo.fLength - newLength;
 
-		if ( (nextPos != fInternalSnips.end()) && (snipPos->fInfo.fState == nextPos->fInfo.fState) ) {
-			nextPos->fInfo.fOffset -= tailLength;		// Adjust the following snip.
-			nextPos->fInfo.fLength += tailLength;
+		if ( (nextPos < fInternalSnips.size()) && (thisInfo.fState == fInternalSnips[nextPos].fInfo.fState) ) {
+			fInternalSnips[nextPos].fInfo.fOffset -= tailLength;		// Adjust the following snip.
+			fInternalSnips[nextPos].fInfo.fLength += tailLength;
 		} else {
-			InternalSnip tailExcess ( (snipPos->fInfo.fOffset + newLength), tailLength );
-			tailExcess.fInfo.fState = snipPos->fInfo.fState;
-			tailExcess.fInfo.fOutOfOrder = snipPos->fInfo.fOutOfOrder;
-			fInternalSnips.insert ( nextPos, tailExcess );		// Insert the tail piece after the middle piece.
+			InternalSnip tailExcess ( (thisInfo.fOffset + newLength), tailLength );
+			tailExcess.fInfo.fState = thisInfo.fState;
+			tailExcess.fInfo.fOutOfOrder = thisInfo.fOutOfOrder;
+			fInternalSnips.insert ( (fInternalSnips.begin() + nextPos), tailExcess );		// Insert the tail piece after the middle piece.
 		}
 
-		snipPos->fInfo.fLength = newLength;
+		fInternalSnips[snipPos].fInfo.fLength = newLength;
 
 	}
 
@@ -1184,12 +1336,13 @@ XMPScanner::SplitInternalSnip ( InternalSnipIterator snipPos, XMP_Int64 relOffse
 // MergeInternalSnips
 // ==================
 
-XMPScanner::InternalSnipIterator
-XMPScanner::MergeInternalSnips ( InternalSnipIterator firstPos, InternalSnipIterator secondPos )
+XMPScanner::InternalSnipIndex
+XMPScanner::MergeInternalSnips ( InternalSnipIndex firstPos, InternalSnipIndex secondPos )
 {
 
-	firstPos->fInfo.fLength += secondPos->fInfo.fLength;
-	fInternalSnips.erase ( secondPos );
+	fInternalSnips[firstPos].fInfo.fLength += fInternalSnips[secondPos].fInfo.fLength;
+	ReleaseMachine ( secondPos );
+	fInternalSnips.erase ( fInternalSnips.begin() + secondPos );
 	return firstPos;
 
 }	// MergeInternalSnips
@@ -1224,14 +1377,13 @@ XMPScanner::Scan ( const void * bufferOrigin, XMP_Int64 bufferOffset, XMP_Int64
 
 	// *** It would be friendly for rescans for out of order problems to accept any buffer postion.
 
-	const XMP_Int64			endOffset	= bufferOffset + bufferLength - 1;
-	InternalSnipIterator	snipPos	= fInternalSnips.begin();
+	const XMP_Int64		endOffset	= bufferOffset + bufferLength - 1;
+	InternalSnipIndex	snipPos		= FindEnclosingSnip ( endOffset );
 
-	while ( endOffset > (snipPos->fInfo.fOffset + snipPos->fInfo.fLength - 1) ) ++ snipPos;
-	if ( snipPos->fInfo.fState != eNotSeenSnip ) throw ScanError ( "Already seen" );
+	if ( fInternalSnips[snipPos].fInfo.fState != eNotSeenSnip ) throw ScanError ( "Already seen" );
 
-	relOffset = bufferOffset - snipPos->fInfo.fOffset;
-	if ( (relOffset + bufferLength) > snipPos->fInfo.fLength ) throw ScanError ( "Not within existing snip" );
+	relOffset = bufferOffset - fInternalSnips[snipPos].fInfo.fOffset;
+	if ( (relOffset + bufferLength) > fInternalSnips[snipPos].fInfo.fLength ) throw ScanError ( "Not within existing snip" );
 
 	SplitInternalSnip ( snipPos, relOffset, bufferLength );		// *** If sequential & prev is partial, just tack on,
 
@@ -1240,33 +1392,23 @@ XMPScanner::Scan ( const void * bufferOrigin, XMP_Int64 bufferOffset, XMP_Int64
 
 	// *** When out of order I/O is supported we have to do something about buffers who's predecessor is not seen.
 
-	if ( snipPos->fInfo.fOffset > 0 ) {
-		InternalSnipIterator prevPos = PrevSnip ( snipPos );
-		if ( prevPos->fInfo.fState == ePartialPacketSnip ) snipPos = MergeInternalSnips ( prevPos, snipPos );
+	if ( fInternalSnips[snipPos].fInfo.fOffset > 0 ) {
+		InternalSnipIndex prevPos = snipPos - 1;
+		if ( fInternalSnips[prevPos].fInfo.fState == ePartialPacketSnip ) snipPos = MergeInternalSnips ( prevPos, snipPos );
 	}
 
 	// ----------------------------------
 	// Look for packets within this snip.
 
-	snipPos->fInfo.fState = ePendingSnip;
-	PacketMachine* thisMachine = snipPos->fMachine.get();
+	fInternalSnips[snipPos].fInfo.fState = ePendingSnip;
+	PacketMachine* thisMachine = fInternalSnips[snipPos].fMachine;
 	// DumpSnipList ( "Before scan" );
 
 	if ( thisMachine != 0 ) {
 		thisMachine->AssociateBuffer ( bufferOffset, bufferOrigin, bufferLength );
 	} else {
-		// *** snipPos->fMachine.reset ( new PacketMachine ( bufferOffset, bufferOrigin, bufferLength ) );		VC++ lacks reset
-		#if 0
-			snipPos->fMachine = unique_ptr<PacketMachine> ( new PacketMachine ( bufferOffset, bufferOrigin, bufferLength ) );
-		#else
-			{
-				// Some versions of gcc complain about the assignment operator above.  This avoids the gcc bug.
-				PacketMachine *	pm	= new PacketMachine ( bufferOffset, bufferOrigin, bufferLength );
-				unique_ptr<PacketMachine>	ap ( pm );
-				snipPos->fMachine = std::move(ap);
-			}
-		#endif
-		thisMachine = snipPos->fMachine.get();
+		thisMachine = AcquireMachine ( bufferOffset, bufferOrigin, bufferLength );
+		fInternalSnips[snipPos].fMachine = thisMachine;
 	}
 
 	bool	bufferDone	= false;
@@ -1280,16 +1422,8 @@ XMPScanner::Scan ( const void * bufferOrigin, XMP_Int64 bufferOffset, XMP_Int64
 			// No packet, mark the snip as raw data and get rid of the packet machine.
 			// We're done with this buffer.
 
-			snipPos->fInfo.fState = eRawInputSnip;
-			#if 0
-				snipPos->fMachine = unique_ptr<PacketMachine>();	// *** snipPos->fMachine.reset();	VC++ lacks reset
-			#else
-				{
-					// Some versions of gcc complain about the assignment operator above.  This avoids the gcc bug.
-					unique_ptr<PacketMachine>	ap;
-					snipPos->fMachine = std::move(ap);
-				}
-			#endif
+			fInternalSnips[snipPos].fInfo.fState = eRawInputSnip;
+			ReleaseMachine ( snipPos );
 			bufferDone = true;
 
 		} else {
@@ -1301,36 +1435,37 @@ XMPScanner::Scan ( const void * bufferOrigin, XMP_Int64 bufferOffset, XMP_Int64
 			// a complete packet first extract the additional information from the packet machine.  If there
 			// is leftover data split the snip and transfer the packet machine to the new trailing snip.
 
-			if ( thisMachine->fPacketStart > snipPos->fInfo.fOffset ) {
+			if ( thisMachine->fPacketStart > fInternalSnips[snipPos].fInfo.fOffset ) {
 
 				// There is data at the front of the current snip that must be trimmed.
-				SnipState	savedState	= snipPos->fInfo.fState;
-				snipPos->fInfo.fState = eRawInputSnip;	// ! So it gets propagated to the trimmed front part.
-				relOffset = thisMachine->fPacketStart - snipPos->fInfo.fOffset;
-				SplitInternalSnip ( snipPos, relOffset, (snipPos->fInfo.fLength - relOffset) );
-				snipPos->fInfo.fState = savedState;
+				SnipState	savedState	= fInternalSnips[snipPos].fInfo.fState;
+				fInternalSnips[snipPos].fInfo.fState = eRawInputSnip;	// ! So it gets propagated to the trimmed front part.
+				relOffset = thisMachine->fPacketStart - fInternalSnips[snipPos].fInfo.fOffset;
+				SplitInternalSnip ( snipPos, relOffset, (fInternalSnips[snipPos].fInfo.fLength - relOffset) );
+				fInternalSnips[snipPos].fInfo.fState = savedState;
 
 			}
 
 			if ( foundPacket == PacketMachine::eTriMaybe ) {
 
 				// We have only found a partial packet.
-				snipPos->fInfo.fState = ePartialPacketSnip;
+				fInternalSnips[snipPos].fInfo.fState = ePartialPacketSnip;
 				bufferDone = true;
 
 			} else {
 
 				// We have found a complete packet. Extract all the info for it and split any trailing data.
 
-				InternalSnipIterator	packetSnip	= snipPos;
-				SnipState				packetState	= eValidPacketSnip;
+				InternalSnipIndex	packetSnip	= snipPos;
+				SnipState			packetState	= eValidPacketSnip;
 
 				if ( thisMachine->fBogusPacket ) packetState = eBadPacketSnip;
 
-				packetSnip->fInfo.fAccess = thisMachine->fAccess;
-				packetSnip->fInfo.fCharForm = thisMachine->fCharForm;
-				packetSnip->fInfo.fBytesAttr = thisMachine->fBytesAttr;
-				packetSnip->fInfo.fEncodingAttr = thisMachine->fEncodingAttr.c_str();
+				SnipInfo & packetInfo = fInternalSnips[packetSnip].fInfo;
+				packetInfo.fAccess = thisMachine->fAccess;
+				packetInfo.fCharForm = thisMachine->fCharForm;
+				packetInfo.fBytesAttr = thisMachine->fBytesAttr;
+				packetInfo.fEncodingAttr = thisMachine->fEncodingAttr.c_str();
 				thisMachine->fEncodingAttr.erase ( thisMachine->fEncodingAttr.begin(), thisMachine->fEncodingAttr.end() );
 
 				if ( (thisMachine->fCharForm != eChar8Bit) && CharFormIsBigEndian ( thisMachine->fCharForm ) ) {
@@ -1352,37 +1487,34 @@ XMPScanner::Scan ( const void * bufferOrigin, XMP_Int64 bufferOffset, XMP_Int64
 					// The raw snip (the one before the packet) might entirely disappear.  A simple
 					// example of this is when the packet is at the start of the file.
 
-					assert ( packetSnip != fInternalSnips.begin() );	// Leading nulls were trimmed!
+					assert ( packetSnip != 0 );	// Leading nulls were trimmed!
 
-					if ( packetSnip != fInternalSnips.begin() ) {	// ... but let's program defensibly.
+					if ( packetSnip != 0 ) {	// ... but let's program defensibly.
 
-						InternalSnipIterator prevSnip  = PrevSnip ( packetSnip );
+						InternalSnipIndex prevSnip = packetSnip - 1;
 						const unsigned int nullsToAdd = ( CharFormIs16Bit ( thisMachine->fCharForm ) ? 1 : 3 );
 
-						assert ( nullsToAdd <= prevSnip->fInfo.fLength );
-						prevSnip->fInfo.fLength -= nullsToAdd;
-						if ( prevSnip->fInfo.fLength == 0 ) (void) fInternalSnips.erase ( prevSnip );
-
-						packetSnip->fInfo.fOffset	-= nullsToAdd;
-						packetSnip->fInfo.fLength	+= nullsToAdd;
-						thisMachine->fPacketStart	-= nullsToAdd;
+						assert ( nullsToAdd <= fInternalSnips[prevSnip].fInfo.fLength );
+						fInternalSnips[prevSnip].fInfo.fLength -= nullsToAdd;
+						fInternalSnips[packetSnip].fInfo.fOffset -= nullsToAdd;
+						fInternalSnips[packetSnip].fInfo.fLength += nullsToAdd;
+						thisMachine->fPacketStart -= nullsToAdd;
+
+						if ( fInternalSnips[prevSnip].fInfo.fLength == 0 ) {
+							ReleaseMachine ( prevSnip );
+							fInternalSnips.erase ( fInternalSnips.begin() + prevSnip );
+							packetSnip -= 1;
+							snipPos -= 1;
+						}
 
 					}
 
 				}
 
-				if ( thisMachine->fPacketLength == snipPos->fInfo.fLength ) {
+				if ( thisMachine->fPacketLength == fInternalSnips[snipPos].fInfo.fLength ) {
 
 					// This packet ends exactly at the end of the current snip.
-					#if 0
-						snipPos->fMachine = unique_ptr<PacketMachine>();	// *** snipPos->fMachine.reset();	VC++ lacks reset
-					#else
-						{
-							// Some versions of gcc complain about the assignment operator above.  This avoids the gcc bug.
-							unique_ptr<PacketMachine>	ap;
-							snipPos->fMachine = std::move(ap);
-						}
-					#endif
+					ReleaseMachine ( snipPos );
 					bufferDone = true;
 
 				} else {
@@ -1390,16 +1522,17 @@ XMPScanner::Scan ( const void * bufferOrigin, XMP_Int64 bufferOffset, XMP_Int64
 					// There is trailing data to split from the just found packet.
 					SplitInternalSnip ( snipPos, 0, thisMachine->fPacketLength );
 
-					InternalSnipIterator	tailPos	= NextSnip ( snipPos );
+					InternalSnipIndex	tailPos	= snipPos + 1;
 
-					tailPos->fMachine = std::move(snipPos->fMachine);	// unique_ptr assignment - taking ownership
+					fInternalSnips[tailPos].fMachine = fInternalSnips[snipPos].fMachine;	// Transfer the machine.
+					fInternalSnips[snipPos].fMachine = 0;
 					thisMachine->ResetMachine ();
 
 					snipPos = tailPos;
 
 				}
 
-				packetSnip->fInfo.fState = packetState;	// Do this last to avoid messing up the tail split.
+				fInternalSnips[packetSnip].fInfo.fState = packetState;	// Do this last to avoid messing up the tail split.
 				// DumpSnipList ( "Found a packet" );
 
 			}
@@ -1413,9 +1546,9 @@ XMPScanner::Scan ( const void * bufferOrigin, XMP_Int64 bufferOffset, XMP_Int64
 
 	// *** When out of order I/O is supported we have to check the following snip too.
 
-	if ( (snipPos->fInfo.fOffset > 0) && (snipPos->fInfo.fState == eRawInputSnip) ) {
-		InternalSnipIterator prevPos = PrevSnip ( snipPos );
-		if ( prevPos->fInfo.fState == eRawInputSnip ) snipPos = MergeInternalSnips ( prevPos, snipPos );
+	if ( (fInternalSnips[snipPos].fInfo.fOffset > 0) && (fInternalSnips[snipPos].fInfo.fState == eRawInputSnip) ) {
+		InternalSnipIndex prevPos = snipPos - 1;
+		if ( fInternalSnips[prevPos].fInfo.fState == eRawInputSnip ) snipPos = MergeInternalSnips ( prevPos, snipPos );
 	}
 
 	// DumpSnipList ( "After scan" );
@@ -1429,8 +1562,7 @@ XMPScanner::Scan ( const void * bufferOrigin, XMP_Int64 bufferOffset, XMP_Int64
 void
 XMPScanner::Report ( SnipInfoVector& snips )
 {
-	const int				count	= (int)fInternalSnips.size();
-	InternalSnipIterator	snipPos	= fInternalSnips.begin();
+	const int	count	= (int)fInternalSnips.size();
 
 	int	s;
 
@@ -1440,9 +1572,7 @@ XMPScanner::Report ( SnipInfoVector& snips )
 	snips.reserve ( count );
 
 	for ( s = 0; s < count; s += 1 ) {
-		snips.push_back ( SnipInfo ( snipPos->fInfo.fState, snipPos->fInfo.fOffset, snipPos->fInfo.fLength ) );
-		snips[s] = snipPos->fInfo;	// Pick up all of the fields.
-		++ snipPos;
+		snips.push_back ( fInternalSnips[s].fInfo );
 	}
 
 }	// Report
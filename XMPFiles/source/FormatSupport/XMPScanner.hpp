@@ -14,7 +14,6 @@
 
 #include "public/include/XMP_Environment.h"	// ! This must be the first include.
 
-#include <list>
 #include <vector>
 #include <string>
 #include <memory>
@@ -141,6 +140,10 @@ public:
 	void Report ( SnipInfoVector & snips );
 	// Produces a report of what is known about the input stream. 
 
+	static void LimitVectorSearch ( int maxBytes );
+	// Only for testing. Limits the search for packet '<' characters to vectors of at most maxBytes,
+	// 0 leaves the byte-by-byte loop. By default the widest form the build and CPU support is used.
+
 	class ScanError : public std::logic_error {
 	public:
 		ScanError() throw() : std::logic_error ( "" ) {}
@@ -155,17 +158,15 @@ private:	// XMPScanner
 	class InternalSnip {
 	public:
 
-		SnipInfo	fInfo;							// The public info about this snip.
-		std::unique_ptr<PacketMachine>	fMachine;	// The state machine for "active" snips.
+		SnipInfo		fInfo;		// The public info about this snip.
+		PacketMachine *	fMachine;	// The state machine for "active" snips, owned by the scanner.
 		
 		InternalSnip ( XMP_Int64 offset, XMP_Int64 length );
-		InternalSnip ( const InternalSnip & );
-		~InternalSnip ();
 
 	};	// InternalSnip
 
-	typedef std::list<InternalSnip>		InternalSnipList;
-	typedef InternalSnipList::iterator	InternalSnipIterator;
+	typedef std::vector<InternalSnip>	InternalSnipList;	// ! Snips are referred to by index.
+	typedef size_t						InternalSnipIndex;
 
 	class PacketMachine {
 	public:
@@ -179,6 +180,7 @@ private:	// XMPScanner
 		bool			fBogusPacket;	// True if the packet has an error such as a bad "bytes" attribute value.
 		
 		void ResetMachine();
+		void RestartMachine ( XMP_Int64 bufferOffset, const void * bufferOrigin, XMP_Int64 bufferLength );
 
 		enum TriState {
 			eTriNo,
@@ -309,17 +311,26 @@ private:	// XMPScanner
 	XMP_Int64			fStreamLength;
 	InternalSnipList	fInternalSnips;
 
+	std::vector<PacketMachine*>	fMachines;		// All of the packet machines, for deletion.
+	std::vector<PacketMachine*>	fFreeMachines;	// The machines not in use by a snip, for reuse.
+
+	XMPScanner ( const XMPScanner & );				// ! Hide copying, the machines are owned.
+	XMPScanner & operator= ( const XMPScanner & );
+
+	PacketMachine *
+	AcquireMachine ( XMP_Int64 bufferOffset, const void * bufferOrigin, XMP_Int64 bufferLength );
+
 	void
-	SplitInternalSnip ( InternalSnipIterator snipPos, XMP_Int64 relOffset, XMP_Int64 newLength );
+	ReleaseMachine ( InternalSnipIndex snipPos );
 
-	InternalSnipIterator
-	MergeInternalSnips ( InternalSnipIterator firstPos, InternalSnipIterator secondPos );
+	InternalSnipIndex
+	FindEnclosingSnip ( XMP_Int64 endOffset );
 
-	InternalSnipIterator
-	PrevSnip ( InternalSnipIterator snipPos );
+	void
+	SplitInternalSnip ( InternalSnipIndex & snipPos, XMP_Int64 relOffset, XMP_Int64 newLength );
 
-	InternalSnipIterator
-	NextSnip ( InternalSnipIterator snipPos );
+	InternalSnipIndex
+	MergeInternalSnips ( InternalSnipIndex firstPos, InternalSnipIndex secondPos );
 
 	#if DEBUG
 		void DumpSnipList ( const char * title );
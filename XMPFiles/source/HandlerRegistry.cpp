@@ -77,6 +77,68 @@ static inline bool CheckP2ContentChild ( const std::string & folderName )
 
 #endif
 
+// =================================================================================================
+// File signatures
+// ===============
+//
+// Leading bytes that a file must have for one of the linked-in normal handlers to accept it when the
+// format is not known. The search of the normal handlers reads a short header prefix once and does
+// not call a CheckProc whose signatures all fail to match, the CheckProc still makes the decision for
+// the rest. Handlers without an entry here (e.g. MPEG-4, SVG, or plugin replacements) are always called.
+
+struct FileSignature {
+	CheckFileFormatProc checkProc;
+	XMP_Uns8 offset;
+	XMP_Uns8 length;
+	const char * bytes;
+};
+
+static const FileSignature kFileSignatures[] = {
+#if EnablePhotoHandlers
+	{ JPEG_CheckFormat, 0, 2, "\xFF\xD8" },
+	{ PSD_CheckFormat, 0, 4, "8BPS" },
+	{ TIFF_CheckFormat, 0, 4, "\x49\x49\x2A\x00" },
+	{ TIFF_CheckFormat, 0, 4, "\x4D\x4D\x00\x2A" },
+	{ GIF_CheckFormat, 0, 6, "GIF89a" },
+#endif
+#if EnableDynamicMediaHandlers
+	{ ASF_CheckFormat, 0, 4, "\x30\x26\xB2\x75" },
+	{ MP3_CheckFormat, 0, 3, "ID3" },	// ! Only when the format is not known from the extension.
+	{ WAVE_CheckFormat, 0, 4, "RIFF" },
+	{ WAVE_CheckFormat, 0, 4, "RF64" },
+	{ RIFF_CheckFormat, 0, 4, "RIFF" },
+	{ WEBP_CheckFormat, 0, 4, "RIFF" },
+	{ SWF_CheckFormat, 1, 2, "WS" },
+	{ FLV_CheckFormat, 0, 4, "FLV\x01" },
+	{ AIFF_CheckFormat, 0, 4, "FORM" },
+#endif
+#if EnableMiscHandlers
+	{ InDesign_CheckFormat, 0, 4, "\x06\x06\xED\xF5" },
+	{ PNG_CheckFormat, 0, 4, "\x89PNG" },
+	{ UCF_CheckFormat, 0, 4, "PK\x03\x04" },
+	{ PostScript_CheckFormat, 0, 4, "\xC5\xD0\xD3\xC6" },
+	{ PostScript_CheckFormat, 0, 4, "%!PS" },
+#endif
+	{ 0, 0, 0, 0 }
+};
+
+enum { kSignatureHeaderSize = 8 };
+
+static bool CouldBeFormat ( CheckFileFormatProc checkProc, const XMP_Uns8 * header, size_t headerLen )
+{
+	bool haveSignature = false;
+
+	for ( const FileSignature * sig = &kFileSignatures[0]; sig->checkProc != 0; ++sig ) {
+		if ( sig->checkProc != checkProc ) continue;
+		haveSignature = true;
+		if ( ((size_t)sig->offset + sig->length) > headerLen ) continue;
+		if ( memcmp ( header + sig->offset, sig->bytes, sig->length ) == 0 ) return true;
+	}
+
+	return (! haveSignature);
+
+}	// CouldBeFormat
+
 // =================================================================================================
 
 //
@@ -102,10 +164,20 @@ HandlerRegistry::HandlerRegistry()
 	mNormalHandlers		= new XMPFileHandlerTable;
 	mOwningHandlers		= new XMPFileHandlerTable;
 	mReplacedHandlers	= new XMPFileHandlerTable;
+
+	mFormatCacheCapacity = 0;
+	InitializeBasicMutex ( mFormatCacheLock );
 }
 
-HandlerRegistry::~HandlerRegistry()
+HandlerRegistry::~HandlerRegistry() noexcept(false)
 {
+	try {
+		this->saveFormatCache();
+	} catch ( ... ) {
+		// Ignore failures to write the snapshot, it is only a cache.
+	}
+	TerminateBasicMutex ( mFormatCacheLock );
+
 	delete mFolderHandlers;
 	delete mNormalHandlers;
 	delete mOwningHandlers;
@@ -775,6 +847,12 @@ XMPFileHandlerInfo* HandlerRegistry::selectSmartHandler( XMPFiles* session, XMP_
 		if ( session->ioRef == 0 ) return 0;
 	}
 	
+	// Read the start of the file once, handlers whose signatures don't match are not called.
+
+	XMP_Uns8 header [kSignatureHeaderSize];
+	session->ioRef->Rewind();
+	size_t headerLen = session->ioRef->Read ( header, kSignatureHeaderSize );
+
 	XMPFileHandlerTablePos handlerPos = mNormalHandlers->begin();
 
 	for( ; handlerPos != mNormalHandlers->end(); ++handlerPos ) 
@@ -782,6 +860,7 @@ XMPFileHandlerInfo* HandlerRegistry::selectSmartHandler( XMPFiles* session, XMP_
 		session->format = kXMP_UnknownFile;	// ! Hack to tell the CheckProc this is not an initial call.
 		handlerInfo = &handlerPos->second;
 		CheckFileFormatProc CheckProc = (CheckFileFormatProc) (handlerInfo->checkProc);
+		if ( ! CouldBeFormat ( CheckProc, header, headerLen ) ) continue;
 		foundHandler = CheckProc ( handlerInfo->format, clientPath, session->ioRef, session );
 		XMP_Assert ( foundHandler || (session->tempPtr == 0) );
 		if ( foundHandler ) return handlerInfo;
@@ -812,6 +891,218 @@ XMPFileHandlerInfo* HandlerRegistry::selectSmartHandler( XMPFiles* session, XMP_
 
 }	// HandlerRegistry::selectSmartHandler
 
+// =================================================================================================
+// Format detection cache
+// ======================
+//
+// Entries are keyed by the kind of check and the path as passed in, handlers look at extensions and
+// folder names too. The file identity only tells if the object at that path is still the same.
+//
+// The snapshot is a signature followed by entries in native byte order, most recently used first.
+// Each entry is the fixed size identity and format part, the kind, the path length, and the path.
+// It is only meant to be read back by the same library on the same machine.
+
+static const char kFormatCacheSignature[8] = { 'X', 'M', 'P', 'F', 'm', 't', 'C', '2' };
+
+enum { kFormatCacheEntrySize = 8+8+8+8+4+1+4 };
+
+static bool SameFileIdentity ( const Host_IO::FileIdentity & left, const Host_IO::FileIdentity & right )
+{
+	return (left.device == right.device) && (left.fileNumber == right.fileNumber) &&
+		   (left.length == right.length) && (left.modifyTime == right.modifyTime);
+}
+
+// -------------------------------------------------------------------------------------------------
+
+void HandlerRegistry::setFormatCache( XMP_Uns32 capacity, XMP_StringPtr snapshotPath )
+{
+	XMP_AutoMutex cacheLock ( &mFormatCacheLock );
+
+	try {
+		this->saveFormatCache();
+	} catch ( ... ) {
+		// Ignore failures to write the old snapshot, the new settings still apply.
+	}
+	mFormatCacheList.clear();
+	mFormatCacheIndex.clear();
+
+	mFormatCacheCapacity = capacity;
+	mFormatCacheSnapshot.clear();
+	if ( (capacity == 0) || (snapshotPath == 0) ) return;
+
+	mFormatCacheSnapshot = snapshotPath;
+	this->loadFormatCache();
+
+}	// HandlerRegistry::setFormatCache
+
+// -------------------------------------------------------------------------------------------------
+
+bool HandlerRegistry::formatCacheEnabled()
+{
+	XMP_AutoMutex cacheLock ( &mFormatCacheLock );
+	return (mFormatCacheCapacity != 0);
+
+}	// HandlerRegistry::formatCacheEnabled
+
+// -------------------------------------------------------------------------------------------------
+
+bool HandlerRegistry::lookupFormatCache( FormatCacheKind kind, XMP_StringPtr path, FormatCacheStamp* stamp, XMP_FileFormat* format )
+{
+	stamp->valid = false;
+	if ( ! this->formatCacheEnabled() ) return false;	// Don't stat the file when there is no cache.
+
+	if ( ! Host_IO::GetFileIdentity ( path, &stamp->identity ) ) return false;
+	stamp->valid = true;
+
+	XMP_AutoMutex cacheLock ( &mFormatCacheLock );
+
+	FormatCacheIndex::iterator indexPos = mFormatCacheIndex.find ( FormatCacheKey ( (XMP_Uns8)kind, path ) );
+	if ( indexPos == mFormatCacheIndex.end() ) return false;
+
+	FormatCacheList::iterator entry = indexPos->second;
+	if ( ! SameFileIdentity ( entry->identity, stamp->identity ) ) return false;
+	if ( (entry->format != kXMP_UnknownFile) && (this->getHandlerInfo ( entry->format ) == 0) ) return false;
+
+	mFormatCacheList.splice ( mFormatCacheList.begin(), mFormatCacheList, entry );
+	*format = entry->format;
+	return true;
+
+}	// HandlerRegistry::lookupFormatCache
+
+// -------------------------------------------------------------------------------------------------
+
+void HandlerRegistry::storeFormatCache( FormatCacheKind kind, XMP_StringPtr path, const FormatCacheStamp & stamp, XMP_FileFormat format )
+{
+	if ( ! stamp.valid ) return;
+
+	FormatCacheEntry newEntry;
+	newEntry.identity = stamp.identity;
+	newEntry.key = FormatCacheKey ( (XMP_Uns8)kind, path );
+	newEntry.format = format;
+
+	XMP_AutoMutex cacheLock ( &mFormatCacheLock );
+	if ( mFormatCacheCapacity == 0 ) return;	// The cache was turned off meanwhile.
+
+	FormatCacheIndex::iterator indexPos = mFormatCacheIndex.find ( newEntry.key );
+
+	if ( indexPos != mFormatCacheIndex.end() ) {
+		*indexPos->second = newEntry;
+		mFormatCacheList.splice ( mFormatCacheList.begin(), mFormatCacheList, indexPos->second );
+		return;
+	}
+
+	if ( mFormatCacheList.size() >= mFormatCacheCapacity ) {
+		mFormatCacheIndex.erase ( mFormatCacheList.back().key );
+		mFormatCacheList.pop_back();
+	}
+
+	mFormatCacheList.push_front ( newEntry );
+	mFormatCacheIndex[newEntry.key] = mFormatCacheList.begin();
+
+}	// HandlerRegistry::storeFormatCache
+
+// -------------------------------------------------------------------------------------------------
+
+void HandlerRegistry::loadFormatCache()
+{
+	// ! The caller holds the cache lock. A missing or malformed snapshot just leaves the cache empty.
+
+	Host_IO::FileRef snapshot = Host_IO::noFileRef;
+	try {
+		snapshot = Host_IO::Open ( mFormatCacheSnapshot.c_str(), Host_IO::openReadOnly );
+	} catch ( ... ) {
+		return;
+	}
+	if ( snapshot == Host_IO::noFileRef ) return;
+
+	std::vector<XMP_Uns8> buffer;
+	try {
+		XMP_Int64 length = Host_IO::Length ( snapshot );
+		if ( length > 64*1024*1024 ) length = 0;	// Not something this library wrote.
+		buffer.resize ( (size_t)length );
+		if ( length > 0 ) buffer.resize ( Host_IO::ReadAt ( snapshot, 0, &buffer[0], (XMP_Uns32)length ) );
+	} catch ( ... ) {
+		buffer.clear();
+	}
+	Host_IO::Close ( snapshot );
+
+	if ( (buffer.size() < sizeof(kFormatCacheSignature)) ||
+		 (memcmp ( &buffer[0], kFormatCacheSignature, sizeof(kFormatCacheSignature) ) != 0) ) return;
+
+	size_t offset = sizeof(kFormatCacheSignature);
+	while ( ((offset + kFormatCacheEntrySize) <= buffer.size()) && (mFormatCacheList.size() < mFormatCacheCapacity) ) {
+
+		FormatCacheEntry entry;
+		XMP_Uns32 pathLen;
+		const XMP_Uns8 * entryPtr = &buffer[offset];
+		memcpy ( &entry.identity.device, entryPtr, 8 );
+		memcpy ( &entry.identity.fileNumber, entryPtr+8, 8 );
+		memcpy ( &entry.identity.length, entryPtr+16, 8 );
+		memcpy ( &entry.identity.modifyTime, entryPtr+24, 8 );
+		memcpy ( &entry.format, entryPtr+32, 4 );
+		entry.key.first = entryPtr[36];
+		memcpy ( &pathLen, entryPtr+37, 4 );
+
+		offset += kFormatCacheEntrySize;
+		if ( pathLen > (buffer.size() - offset) ) break;
+		entry.key.second.assign ( (const char*)&buffer[offset], pathLen );
+		offset += pathLen;
+
+		if ( mFormatCacheIndex.find ( entry.key ) != mFormatCacheIndex.end() ) continue;
+		mFormatCacheList.push_back ( entry );
+		mFormatCacheIndex[entry.key] = --mFormatCacheList.end();
+
+	}
+
+}	// HandlerRegistry::loadFormatCache
+
+// -------------------------------------------------------------------------------------------------
+
+void HandlerRegistry::saveFormatCache()
+{
+	// ! The caller holds the cache lock, or is the destructor. Write to a temp and swap it in.
+
+	if ( mFormatCacheSnapshot.empty() ) return;
+
+	size_t bufferSize = sizeof(kFormatCacheSignature);
+	FormatCacheList::const_iterator entry = mFormatCacheList.begin();
+	for ( ; entry != mFormatCacheList.end(); ++entry ) bufferSize += kFormatCacheEntrySize + entry->key.second.size();
+
+	std::vector<XMP_Uns8> buffer ( bufferSize );
+	memcpy ( &buffer[0], kFormatCacheSignature, sizeof(kFormatCacheSignature) );
+
+	XMP_Uns8 * entryPtr = &buffer[sizeof(kFormatCacheSignature)];
+	for ( entry = mFormatCacheList.begin(); entry != mFormatCacheList.end(); ++entry ) {
+		XMP_Uns32 pathLen = (XMP_Uns32)entry->key.second.size();
+		memcpy ( entryPtr, &entry->identity.device, 8 );
+		memcpy ( entryPtr+8, &entry->identity.fileNumber, 8 );
+		memcpy ( entryPtr+16, &entry->identity.length, 8 );
+		memcpy ( entryPtr+24, &entry->identity.modifyTime, 8 );
+		memcpy ( entryPtr+32, &entry->format, 4 );
+		entryPtr[36] = entry->key.first;
+		memcpy ( entryPtr+37, &pathLen, 4 );
+		entryPtr += kFormatCacheEntrySize;
+		if ( pathLen > 0 ) memcpy ( entryPtr, entry->key.second.data(), pathLen );
+		entryPtr += pathLen;
+	}
+
+	std::string tempPath = Host_IO::CreateTemp ( mFormatCacheSnapshot.c_str() );
+	Host_IO::FileRef snapshot = Host_IO::Open ( tempPath.c_str(), Host_IO::openReadWrite );
+
+	try {
+		Host_IO::Write ( snapshot, &buffer[0], (XMP_Uns32)buffer.size() );
+		Host_IO::Close ( snapshot );
+		snapshot = Host_IO::noFileRef;
+		if ( Host_IO::Exists ( mFormatCacheSnapshot.c_str() ) ) Host_IO::Delete ( mFormatCacheSnapshot.c_str() );
+		Host_IO::Rename ( tempPath.c_str(), mFormatCacheSnapshot.c_str() );
+	} catch ( ... ) {
+		Host_IO::Close ( snapshot );
+		Host_IO::Delete ( tempPath.c_str() );
+		throw;
+	}
+
+}	// HandlerRegistry::saveFormatCache
+
 // =================================================================================================
 
 #if EnableDynamicMediaHandlers
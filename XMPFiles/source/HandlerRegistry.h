@@ -22,6 +22,8 @@
 #include "XMPFiles/source/FormatSupport/IFF/ChunkPath.h"
 #include "source/Endian.h"
 
+#include <list>
+
 namespace Common
 {
 
@@ -182,6 +184,57 @@ public:
 	 */
 	XMPFileHandlerInfo*	selectSmartHandler( XMPFiles* session, XMP_StringPtr clientPath, XMP_FileFormat format, XMP_OptionBits openFlags );
 
+	/**
+	 * Configure the format detection cache. Detected formats are remembered by file system identity
+	 * (device, file number, length and modification time), so an unchanged file or package folder
+	 * is not looked at again. The least recently used entries are dropped beyond the capacity.
+	 * If a snapshot path is given the cache is loaded from it now and written back when the cache
+	 * is reconfigured or the registry is terminated.
+	 *
+	 * @param capacity		Maximum number of entries, 0 disables the cache
+	 * @param snapshotPath	Path of the on-disk snapshot, can be NULL or empty
+	 */
+	void				setFormatCache( XMP_Uns32 capacity, XMP_StringPtr snapshotPath );
+
+	/**
+	 * What a format cache entry answers, file and package checks of the same path differ.
+	 */
+	enum FormatCacheKind { kFormatCacheFile = 0, kFormatCachePackage = 1 };
+
+	/**
+	 * The identity of a file or folder as read by lookupFormatCache, before the format is detected.
+	 * Not valid if the cache is off or the path can't be read.
+	 */
+	struct FormatCacheStamp {
+		bool					valid;
+		Host_IO::FileIdentity	identity;
+		FormatCacheStamp() : valid(false) {};
+	};
+
+	/**
+	 * Look up the cached format of a file or package folder. Handlers also look at the path
+	 * (extension, folder names), so entries are per path and not per file system object.
+	 *
+	 * @param kind		File or package check
+	 * @param path		Path to the file or folder
+	 * @param stamp		Return the current identity of the path, to pass to storeFormatCache
+	 * @param format	Return the cached format, kXMP_UnknownFile if there is no handler
+	 * @return			True if the cache has a current entry for the path
+	 */
+	bool				lookupFormatCache( FormatCacheKind kind, XMP_StringPtr path, FormatCacheStamp* stamp, XMP_FileFormat* format );
+
+	/**
+	 * Remember the detected format of a file or package folder. Does nothing if the cache is off
+	 * or the stamp is not valid. The stamp is the one from the lookupFormatCache call made before
+	 * the detection, so a file replaced meanwhile is not cached with the old file's format.
+	 *
+	 * @param kind		File or package check
+	 * @param path		Path to the file or folder
+	 * @param stamp		Identity of the path from lookupFormatCache
+	 * @param format	Detected format, kXMP_UnknownFile if there is no handler
+	 */
+	void				storeFormatCache( FormatCacheKind kind, XMP_StringPtr path, const FormatCacheStamp & stamp, XMP_FileFormat format );
+
 private:
 	/**
 	 * Return default file handler for file format identifier or filename extension
@@ -217,7 +270,7 @@ private:
 	 * ctor/dtor
 	 */
 	 HandlerRegistry();
-	~HandlerRegistry();
+	~HandlerRegistry() noexcept(false);
 
 private:
 	typedef std::map <XMP_FileFormat, XMPFileHandlerInfo>	XMPFileHandlerTable;
@@ -230,6 +283,27 @@ private:
 
 	XMPFileHandlerTable*	mReplacedHandlers;	// All file handler that where replaced by a later one
 
+	typedef std::pair <XMP_Uns8, std::string>						FormatCacheKey;	// Kind and path.
+
+	struct FormatCacheEntry {
+		FormatCacheKey			key;
+		Host_IO::FileIdentity	identity;
+		XMP_FileFormat			format;
+	};
+
+	typedef std::list <FormatCacheEntry>							FormatCacheList;	// Most recently used first.
+	typedef std::map <FormatCacheKey, FormatCacheList::iterator>	FormatCacheIndex;
+
+	bool					formatCacheEnabled();
+	void					loadFormatCache();
+	void					saveFormatCache();
+
+	XMP_Uns32				mFormatCacheCapacity;
+	std::string				mFormatCacheSnapshot;
+	FormatCacheList			mFormatCacheList;
+	FormatCacheIndex		mFormatCacheIndex;
+	XMP_BasicMutex			mFormatCacheLock;
+
 	static HandlerRegistry*	sInstance;			// singleton instance
 };
 
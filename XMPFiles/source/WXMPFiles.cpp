@@ -166,6 +166,19 @@ void WXMPFiles_CheckPackageFormat_1 ( XMP_StringPtr folderPath,
 
 // -------------------------------------------------------------------------------------------------
 
+void WXMPFiles_SetFormatCache_1 ( XMP_Uns32     capacity,
+                                  XMP_StringPtr snapshotPath,
+                                  WXMP_Result * wResult )
+{
+	XMP_ENTER_Static ( "WXMPFiles_SetFormatCache_1" )
+
+		XMPFiles::SetFormatCache ( capacity, snapshotPath );
+
+	XMP_EXIT
+}
+
+// -------------------------------------------------------------------------------------------------
+
 void WXMPFiles_GetFileModDate_1 ( XMP_StringPtr    filePath,
 								  XMP_DateTime *   modDate,
 								  XMP_FileFormat * format,
@@ -310,6 +323,20 @@ void WXMPFiles_SetAbortProc_1 ( XMPFilesRef   xmpObjRef,
 
 // -------------------------------------------------------------------------------------------------
 
+void WXMPFiles_SetParseNamespaces_1 ( XMPFilesRef           xmpObjRef,
+									  const XMP_StringPtr * namespaceURIs,
+									  XMP_Index             uriCount,
+									  WXMP_Result *         wResult )
+{
+	XMP_ENTER_ObjWrite ( XMPFiles, "WXMPFiles_SetParseNamespaces_1" )
+
+		thiz->SetParseNamespaces ( namespaceURIs, uriCount );
+
+	XMP_EXIT
+}
+
+// -------------------------------------------------------------------------------------------------
+
 void WXMPFiles_GetXMP_1 ( XMPFilesRef      xmpObjRef,
                           XMPMetaRef       xmpRef,
 		                  void *           clientPacket,
@@ -323,12 +350,18 @@ void WXMPFiles_GetXMP_1 ( XMPFilesRef      xmpObjRef,
 		bool hasXMP = false;
 		XMP_StringPtr packetStr;
 		XMP_StringLen packetLen;
+		XMP_StringPtr * packetStrOut = 0;	// ! Only ask for the packet if the client wants it, that copies a borrowed packet.
+		XMP_StringLen * packetLenOut = 0;
+		if ( clientPacket != 0 ) {
+			packetStrOut = &packetStr;
+			packetLenOut = &packetLen;
+		}
 
 		if ( xmpRef == 0 ) {
-			hasXMP = thiz->GetXMP ( 0, &packetStr, &packetLen, packetInfo );
+			hasXMP = thiz->GetXMP ( 0, packetStrOut, packetLenOut, packetInfo );
 		} else {
 			SXMPMeta xmpObj ( xmpRef );
-			hasXMP = thiz->GetXMP ( &xmpObj, &packetStr, &packetLen, packetInfo );
+			hasXMP = thiz->GetXMP ( &xmpObj, packetStrOut, packetLenOut, packetInfo );
 		}
 
 		if ( hasXMP && (clientPacket != 0) ) (*SetClientString) ( clientPacket, packetStr, packetLen );
@@ -373,6 +373,22 @@ static inline void CloseLocalFile ( XMPFiles* thiz )
 
 }	// CloseLocalFile
 
+// =================================================================================================
+// MapLocalFile
+// ============
+//
+// Memory map a local file opened for read-only access if the client asked for it. Failure to map
+// is not an error, the handler then reads through the host file as usual.
+
+static inline void MapLocalFile ( XMPFiles* thiz, bool readOnly )
+{
+	if ( readOnly && (thiz->openFlags & kXMPFiles_OpenUseMmap) && thiz->UsesLocalIO() && (thiz->ioRef != 0) ) {
+		XMPFiles_IO* localFile = (XMPFiles_IO*)thiz->ioRef;
+		(void) localFile->MapFile();
+	}
+
+}	// MapLocalFile
+
 // =================================================================================================
 
 XMPFiles::~XMPFiles()
@@ -409,6 +425,19 @@ XMPFiles::GetFormatInfo ( XMP_FileFormat   format,
 
 // =================================================================================================
 
+/* class static */
+void
+XMPFiles::SetFormatCache ( XMP_Uns32     capacity,
+                           XMP_StringPtr snapshotPath /* = 0 */ )
+{
+	XMP_FILES_STATIC_START
+		HandlerRegistry::getInstance().setFormatCache ( capacity, snapshotPath );
+	XMP_FILES_STATIC_END2 ( snapshotPath, kXMPErrSev_OperationFatal )
+
+}	// XMPFiles::SetFormatCache
+
+// =================================================================================================
+
 /* class static */
 XMP_FileFormat
 XMPFiles::CheckFileFormat ( XMP_StringPtr clientPath )
@@ -416,17 +445,24 @@ XMPFiles::CheckFileFormat ( XMP_StringPtr clientPath )
 	XMP_FILES_STATIC_START
 	if ( (clientPath == 0) || (*clientPath == 0) ) return kXMP_UnknownFile;
 
+	HandlerRegistry & registry = HandlerRegistry::getInstance();
+	HandlerRegistry::FormatCacheStamp cacheStamp;
+	XMP_FileFormat cachedFormat;
+	if ( registry.lookupFormatCache ( HandlerRegistry::kFormatCacheFile, clientPath, &cacheStamp, &cachedFormat ) ) return cachedFormat;
+
 	XMPFiles bogus;	// Needed to provide context to SelectSmartHandler.
 	bogus.SetFilePath ( clientPath ); // So that XMPFiles destructor cleans up the XMPFiles_IO object.
-	XMPFileHandlerInfo * handlerInfo = HandlerRegistry::getInstance().selectSmartHandler(&bogus, clientPath, kXMP_UnknownFile, kXMPFiles_OpenForRead);
+	XMPFileHandlerInfo * handlerInfo = registry.selectSmartHandler(&bogus, clientPath, kXMP_UnknownFile, kXMPFiles_OpenForRead);
 
 	if ( handlerInfo == 0 ) {
 		if ( !Host_IO::Exists ( clientPath ) ) {
 			XMP_Error error ( kXMPErr_NoFile, "XMPFiles: file does not exist" );
 			XMP_FILES_STATIC_NOTIFY_ERROR ( &sDefaultErrorCallback, clientPath, kXMPErrSev_Recoverable, error );
 		}
+		registry.storeFormatCache ( HandlerRegistry::kFormatCacheFile, clientPath, cacheStamp, kXMP_UnknownFile );
 		return kXMP_UnknownFile;
 	}
+	registry.storeFormatCache ( HandlerRegistry::kFormatCacheFile, clientPath, cacheStamp, handlerInfo->format );
 	return handlerInfo->format;
 	XMP_FILES_STATIC_END2 ( clientPath, kXMPErrSev_OperationFatal )
 	return kXMP_UnknownFile;
@@ -451,7 +487,15 @@ XMPFiles::CheckPackageFormat ( XMP_StringPtr folderPath )
 	#else
 		Host_IO::FileMode folderMode = Host_IO::GetFileMode ( folderPath );
 		if ( folderMode != Host_IO::kFMode_IsFolder ) return kXMP_UnknownFile;
-		return HandlerRegistry::checkTopFolderName ( std::string ( folderPath ) );
+
+		HandlerRegistry & registry = HandlerRegistry::getInstance();
+		HandlerRegistry::FormatCacheStamp cacheStamp;
+		XMP_FileFormat format;
+		if ( registry.lookupFormatCache ( HandlerRegistry::kFormatCachePackage, folderPath, &cacheStamp, &format ) ) return format;
+
+		format = HandlerRegistry::checkTopFolderName ( std::string ( folderPath ) );
+		registry.storeFormatCache ( HandlerRegistry::kFormatCachePackage, folderPath, cacheStamp, format );
+		return format;
 	#endif
 	XMP_FILES_STATIC_END2 ( folderPath, kXMPErrSev_OperationFatal )
 	return kXMP_UnknownFile;
@@ -930,6 +974,20 @@ XMPFiles::IsMetadataWritable (
 
 // =================================================================================================
 
+static void
+SetHandlerParseNamespaces ( XMPFiles * thiz, XMPFileHandler * handler )
+{
+	if ( thiz->parseNamespaces.empty() ) return;
+
+	std::vector<XMP_StringPtr> namespaceURIs ( thiz->parseNamespaces.size() );
+	for ( size_t i = 0; i < namespaceURIs.size(); ++i ) namespaceURIs[i] = thiz->parseNamespaces[i].c_str();
+
+	handler->xmpObj.SetParseNamespaces ( &namespaceURIs[0], (XMP_Index)namespaceURIs.size() );
+
+}	// SetHandlerParseNamespaces
+
+// =================================================================================================
+
 static bool
 DoOpenFile ( XMPFiles *     thiz,
 			 XMP_IO *       clientIO,
@@ -945,6 +1003,10 @@ DoOpenFile ( XMPFiles *     thiz,
 			XMP_Throw ( "OptimizeFileLayout requires OpenForUpdate", kXMPErr_BadParam );
 	}
 
+	if ( (openFlags & kXMPFiles_OpenForUpdate) && (! thiz->parseNamespaces.empty()) ) {
+			XMP_Throw ( "OpenForUpdate is not allowed with parse namespaces", kXMPErr_BadParam );
+	}
+
 	if ( thiz->handler != 0 ) XMP_Throw ( "File already open", kXMPErr_BadParam );
 	CloseLocalFile ( thiz );	// Sanity checks if prior call failed.
 
@@ -1073,6 +1135,8 @@ DoOpenFile ( XMPFiles *     thiz,
 				XMP_Throw ( "Open, file permission error", kXMPErr_FilePermission );
 			}
 		}
+		SetHandlerParseNamespaces ( thiz, handler );
+		MapLocalFile ( thiz, readOnly );
 		handler->CacheFileData();
 	} catch ( ... ) {
 		delete thiz->handler;
@@ -1081,7 +1145,7 @@ DoOpenFile ( XMPFiles *     thiz,
 		throw;
 	}
 
-	if ( handler->containsXMP ) FillPacketInfo ( handler->xmpPacket, &handler->packetInfo );
+	if ( handler->containsXMP ) FillPacketInfo ( handler->PacketPtr(), handler->PacketLen(), &handler->packetInfo );
 
 	if ( (! (openFlags & kXMPFiles_OpenForUpdate)) && (! (handlerFlags & kXMPFiles_HandlerOwnsFile)) ) {
 		// Close the disk file now if opened for read-only access.
@@ -1108,6 +1172,10 @@ static bool DoOpenFile( XMPFiles* thiz,
 			XMP_Throw ( "OptimizeFileLayout requires OpenForUpdate", kXMPErr_BadParam );
 	}
 
+	if ( (openFlags & kXMPFiles_OpenForUpdate) && (! thiz->parseNamespaces.empty()) ) {
+			XMP_Throw ( "OpenForUpdate is not allowed with parse namespaces", kXMPErr_BadParam );
+	}
+
 	if ( thiz->handler != 0 ) XMP_Throw ( "File already open", kXMPErr_BadParam );
 
 	//
@@ -1139,11 +1207,13 @@ static bool DoOpenFile( XMPFiles* thiz,
 	//
 	try 
 	{
+		SetHandlerParseNamespaces ( thiz, handler );
+		MapLocalFile ( thiz, readOnly );
 		handler->CacheFileData();
 
 		if( handler->containsXMP ) 
 		{
-			FillPacketInfo( handler->xmpPacket, &handler->packetInfo );
+			FillPacketInfo( handler->PacketPtr(), handler->PacketLen(), &handler->packetInfo );
 		}
 
 		if( (! (openFlags & kXMPFiles_OpenForUpdate)) && (! (handlerFlags & kXMPFiles_HandlerOwnsFile)) ) 
@@ -1309,9 +1379,12 @@ XMPFiles::CloseFile ( XMP_OptionBits closeFlags /* = 0 */ )
 
 				XMP_IO* origFileRef = this->ioRef;
 
+				bool cloned = false;
+				if ( this->UsesLocalIO() ) cloned = ((XMPFiles_IO*)origFileRef)->CloneToTemp();
+
 				origFileRef->Rewind();
 				if ( this->progressTracker != 0 && (this->handler->handlerFlags & kXMPFiles_CanNotifyProgress) ) progressTracker->BeginWork ( (float) origFileRef->Length() );
-				XIO::Copy ( origFileRef, tempFileRef, origFileRef->Length(), abortProc, abortArg );
+				if ( ! cloned ) XIO::Copy ( origFileRef, tempFileRef, origFileRef->Length(), abortProc, abortArg );
 
 				try {
 
@@ -1427,6 +1500,26 @@ XMPFiles::SetAbortProc ( XMP_AbortProc abortProc,
 	XMP_FILES_END1 ( kXMPErrSev_OperationFatal )
 }	// XMPFiles::SetAbortProc
 
+// =================================================================================================
+
+void
+XMPFiles::SetParseNamespaces ( const XMP_StringPtr * namespaceURIs,
+							   XMP_Index             uriCount )
+{
+	XMP_FILES_START
+	if ( (namespaceURIs == 0) && (uriCount != 0) ) XMP_Throw ( "Null namespace list", kXMPErr_BadParam );
+	if ( uriCount < 0 ) XMP_Throw ( "Negative namespace count", kXMPErr_BadParam );
+
+	std::vector<std::string> newNamespaces ( uriCount );
+	for ( XMP_Index i = 0; i < uriCount; ++i ) {
+		if ( (namespaceURIs[i] == 0) || (*namespaceURIs[i] == 0) ) XMP_Throw ( "Empty namespace URI", kXMPErr_BadSchema );
+		newNamespaces[i] = namespaceURIs[i];
+	}
+
+	this->parseNamespaces.swap ( newNamespaces );
+	XMP_FILES_END1 ( kXMPErrSev_OperationFatal )
+}	// XMPFiles::SetParseNamespaces
+
 // =================================================================================================
 // SetClientPacketInfo
 // ===================
@@ -1465,12 +1558,14 @@ XMPFiles::GetXMP ( SXMPMeta *       xmpObj /* = 0 */,
 	if ( this->handler == 0 ) XMP_Throw ( "XMPFiles::GetXMP - No open file", kXMPErr_BadObject );
 
 	XMP_OptionBits applyTemplateFlags = kXMPTemplate_AddNewProperties | kXMPTemplate_IncludeInternalProperties;
+	bool wantPacket = (xmpPacket != 0) || (xmpPacketLen != 0);	// ! Only copy a borrowed packet if asked.
 
 	if ( ! this->handler->processedXMP ) {
 		try {
 			this->handler->ProcessXMP();
 		} catch ( ... ) {
 			// Return the outputs then rethrow the exception.
+			if ( wantPacket ) this->handler->MaterializePacket();
 			if ( xmpObj != 0 ) {
 				// ! Don't use Clone, that replaces the internal ref in the local xmpObj, leaving the client unchanged!
 				xmpObj->Erase();
@@ -1495,6 +1590,7 @@ XMPFiles::GetXMP ( SXMPMeta *       xmpObj /* = 0 */,
 		}
 	#endif
 
+	if ( wantPacket ) this->handler->MaterializePacket();
 	if ( xmpPacket != 0 ) *xmpPacket = this->handler->xmpPacket.c_str();
 	if ( xmpPacketLen != 0 ) *xmpPacketLen = (XMP_StringLen) this->handler->xmpPacket.size();
 	SetClientPacketInfo ( packetInfo, this->handler->packetInfo,
@@ -181,6 +181,7 @@ public:
 
 	static XMP_FileFormat CheckFileFormat(XMP_StringPtr filePath);
 	static XMP_FileFormat CheckPackageFormat(XMP_StringPtr folderPath);
+	static void SetFormatCache(XMP_Uns32 capacity, XMP_StringPtr snapshotPath = 0);
 
 	static bool GetAssociatedResources ( 
 		XMP_StringPtr              filePath,
@@ -244,6 +245,7 @@ public:
 	bool CanPutXMP(const SXMPMeta & xmpObj);
 	bool CanPutXMP(XMP_StringPtr xmpPacket, XMP_StringLen xmpPacketLen = kXMP_UseNullTermination);
 	void SetAbortProc(XMP_AbortProc abortProc, void * abortArg);
+	void SetParseNamespaces(const XMP_StringPtr * namespaceURIs, XMP_Index uriCount);
 
 	void SetProgressCallback(const XMP_ProgressTracker::CallbackInfo & cbInfo);
 
@@ -299,6 +301,7 @@ public:
 	void *					abortArg;
 	XMP_ProgressTracker *	progressTracker;
 	ErrorCallbackInfo		errorCallback;
+	std::vector<std::string> parseNamespaces;	// Passed to the handler's xmpObj at open, all if empty.
 
 private:
 	std::string				filePath;	// Empty for client-managed I/O.
@@ -14,6 +14,7 @@
 
 #include "XMPFiles/source/XMPFiles_Impl.hpp"
 #include "source/XIO.hpp"
+#include "source/XMPFiles_IO.hpp"
 
 #include "source/UnicodeConversions.hpp"
 
@@ -307,8 +308,11 @@ static XMP_StringPtr kPacketTrailiers[3] = { k8BitTrailer, k16BitTrailer, k32Bit
 
 void FillPacketInfo ( const std::string & packet, XMP_PacketInfo * info )
 {
-	XMP_StringPtr packetStr = packet.c_str();
-	XMP_StringLen packetLen = (XMP_StringLen) packet.size();
+	FillPacketInfo ( packet.c_str(), (XMP_StringLen) packet.size(), info );
+}
+
+void FillPacketInfo ( XMP_StringPtr packetStr, XMP_StringLen packetLen, XMP_PacketInfo * info )
+{
 	if ( packetLen == 0 ) return;
 
 	info->charForm = GetPacketCharForm ( packetStr, packetLen );
@@ -356,6 +360,8 @@ void ReadXMPPacket ( XMPFileHandler * handler )
 
 	if ( packetLen == 0 ) XMP_Throw ( "ReadXMPPacket - No XMP packet", kXMPErr_BadXMP );
 
+	if ( handler->ViewMappedPacket ( handler->packetInfo.offset, packetLen ) ) return;
+
 	xmpPacket.erase();
 	xmpPacket.reserve ( packetLen );
 	xmpPacket.append ( packetLen, ' ' );
@@ -367,6 +373,57 @@ void ReadXMPPacket ( XMPFileHandler * handler )
 
 }	// ReadXMPPacket
 
+// =================================================================================================
+// XMPFileHandler::SetPacketView
+// =============================
+
+void XMPFileHandler::SetPacketView ( const void * packetPtr, XMP_StringLen packetLen,
+									 const std::shared_ptr<const void> & owner /* = empty */ )
+{
+	XMP_Assert ( ! (this->parent->openFlags & kXMPFiles_OpenForUpdate) );
+
+	this->xmpPacket.clear();
+	this->packetView = (packetLen == 0) ? 0 : (XMP_StringPtr)packetPtr;
+	this->packetViewLen = (this->packetView == 0) ? 0 : packetLen;
+	this->packetOwner = owner;
+
+}	// XMPFileHandler::SetPacketView
+
+// =================================================================================================
+// XMPFileHandler::ViewMappedPacket
+// ================================
+
+bool XMPFileHandler::ViewMappedPacket ( XMP_Int64 offset, XMP_StringLen length )
+{
+	if ( ! this->parent->UsesLocalIO() ) return false;
+
+	XMPFiles_IO * localFile = (XMPFiles_IO*)this->parent->ioRef;
+	if ( localFile == 0 ) return false;
+
+	XMPFiles_IO::MappedData mapping = localFile->GetMapping();
+	if ( mapping.get() == 0 ) return false;
+	if ( (offset < 0) || ((XMP_Uns64)offset + length > (XMP_Uns64)localFile->Length()) ) return false;
+
+	this->SetPacketView ( mapping.get() + offset, length, mapping );
+	return true;
+
+}	// XMPFileHandler::ViewMappedPacket
+
+// =================================================================================================
+// XMPFileHandler::MaterializePacket
+// =================================
+
+void XMPFileHandler::MaterializePacket()
+{
+	if ( this->packetView == 0 ) return;
+
+	this->xmpPacket.assign ( this->packetView, this->packetViewLen );
+	this->packetView = 0;
+	this->packetViewLen = 0;
+	this->packetOwner.reset();
+
+}	// XMPFileHandler::MaterializePacket
+
 // =================================================================================================
 // XMPFileHandler::GetFileModDate
 // ==============================
@@ -484,7 +541,7 @@ void XMPFileHandler::ProcessXMP()
 	}
 
 	SXMPUtils::RemoveProperties ( &this->xmpObj, 0, 0, kXMPUtil_DoAllProperties );
-	this->xmpObj.ParseFromBuffer ( this->xmpPacket.c_str(), (XMP_StringLen)this->xmpPacket.size() );
+	this->xmpObj.ParseFromBuffer ( this->PacketPtr(), this->PacketLen() );
 	this->processedXMP = true;
 
 }	// XMPFileHandler::ProcessXMP
@@ -27,6 +27,7 @@
 
 #include <vector>
 #include <map>
+#include <memory>
 #include <cassert>
 #include <cstring>
 #include <cstdlib>
@@ -273,13 +274,15 @@ static inline void MakeUpperCase ( std::string * str )
 extern void ReadXMPPacket ( XMPFileHandler * handler );
 
 extern void FillPacketInfo ( const XMP_VarString & packet, XMP_PacketInfo * info );
+extern void FillPacketInfo ( XMP_StringPtr packetStr, XMP_StringLen packetLen, XMP_PacketInfo * info );
 
 class XMPFileHandler {	// See XMPFiles.hpp for usage notes.
 public:
 
 #define DefaultCTorPresets							\
 	handlerFlags(0), stdCharForm(kXMP_CharUnknown),	\
-	containsXMP(false), processedXMP(false), needsUpdate(false), needsArtUpdate (false)
+	containsXMP(false), processedXMP(false), needsUpdate(false), needsArtUpdate (false),	\
+	packetView(0), packetViewLen(0)
 
 	XMPFileHandler() : parent(0), DefaultCTorPresets {};
 	XMPFileHandler (XMPFiles * _parent) : parent(_parent), DefaultCTorPresets
@@ -309,6 +312,23 @@ public:
 
 	static void NotifyClient(GenericErrorCallback * errCBptr, XMP_ErrorSeverity severity, XMP_Error & error);
 
+	// In a read-only session the raw packet can be borrowed instead of copied into xmpPacket. A
+	// handler that keeps the packet bytes in memory for the whole session, in the file mapping or in
+	// a legacy block it owns, passes them to SetPacketView. The owner reference keeps a mapping
+	// alive after the file is closed. ViewMappedPacket borrows a packet range from the file mapping,
+	// it returns false if the file is not mapped. Parsing uses PacketPtr and PacketLen, the copy into
+	// xmpPacket is only made by MaterializePacket when the packet string itself is asked for.
+
+	void SetPacketView ( const void * packetPtr, XMP_StringLen packetLen,
+						 const std::shared_ptr<const void> & owner = std::shared_ptr<const void>() );
+	bool ViewMappedPacket ( XMP_Int64 offset, XMP_StringLen length );
+	void MaterializePacket();
+
+	XMP_StringPtr PacketPtr() const
+		{ return (this->packetView != 0) ? this->packetView : this->xmpPacket.c_str(); };
+	XMP_StringLen PacketLen() const
+		{ return (this->packetView != 0) ? this->packetViewLen : (XMP_StringLen)this->xmpPacket.size(); };
+
 	// ! Leave the data members public so common code can see them.
 
 	XMPFiles *     parent;			// Let's the handler see the file info.
@@ -324,6 +344,10 @@ public:
 	XMP_PacketInfo			packetInfo;	// ! This is always info about the packet in the file, if any!
 	std::string				xmpPacket;	// ! This is the current XMP, updated by XMPFiles::PutXMP.
 	SXMPMeta				xmpObj;
+
+	XMP_StringPtr				packetView;		// Borrowed packet bytes, xmpPacket is empty while this is set.
+	XMP_StringLen				packetViewLen;
+	std::shared_ptr<const void>	packetOwner;	// Keeps the borrowed bytes alive, e.g. the file mapping.
 };	// XMPFileHandler
 
 typedef XMPFileHandler * (* XMPFileHandlerCTor) ( XMPFiles * parent );
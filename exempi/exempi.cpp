@@ -41,9 +41,13 @@
 #include "xmp.h"
 #include "xmperrors.h"
 
+#include <algorithm>
 #include <string>
 #include <iostream>
 #include <memory>
+#include <new>
+#include <vector>
+#include <cstring>
 
 #define XMP_INCLUDE_XMPFILES 1
 #define TXMP_STRING_TYPE std::string
@@ -142,6 +146,315 @@ static void set_error(const XMP_Error &e)
     (dst).tzMinute = (src).tzMinute;                                           \
     (dst).nanoSecond = (src).nanoSecond;
 
+namespace {
+
+/** XMP_IO over a block of memory. Either a read-only view of a client buffer,
+ * which is never copied, or a growable buffer owned by the object. The latter
+ * is used as the temp of the client I/O sessions.
+ */
+class MemoryIO : public XMP_IO {
+public:
+    MemoryIO(const void *data, size_t len)
+        : m_view(static_cast<const XMP_Uns8 *>(data))
+        , m_length(len)
+        , m_readOnly(true)
+        , m_offset(0)
+        , m_temp(nullptr)
+    {
+    }
+    MemoryIO()
+        : m_view(nullptr)
+        , m_length(0)
+        , m_readOnly(false)
+        , m_offset(0)
+        , m_temp(nullptr)
+    {
+    }
+    virtual ~MemoryIO()
+    {
+        delete m_temp;
+    }
+
+    const XMP_Uns8 *data() const
+    {
+        return m_readOnly ? m_view : m_owned.data();
+    }
+
+    virtual XMP_Uns32 Read(void *buffer, XMP_Uns32 count, bool readAll) override
+    {
+        XMP_Int64 available = m_length - m_offset;
+        if (count > available) {
+            if (readAll) {
+                throw XMP_Error(kXMPErr_EnforceFailure, "MemoryIO::Read, not enough data");
+            }
+            count = static_cast<XMP_Uns32>(available);
+        }
+        memcpy(buffer, data() + m_offset, count);
+        m_offset += count;
+        return count;
+    }
+    virtual void Write(const void *buffer, XMP_Uns32 count) override
+    {
+        checkWritable();
+        if (m_offset + count > m_length) {
+            m_length = m_offset + count;
+            m_owned.resize(static_cast<size_t>(m_length));
+        }
+        memcpy(m_owned.data() + m_offset, buffer, count);
+        m_offset += count;
+    }
+    virtual XMP_Int64 Seek(XMP_Int64 offset, SeekMode mode) override
+    {
+        XMP_Int64 newOffset = offset;
+        if (mode == kXMP_SeekFromCurrent) {
+            newOffset += m_offset;
+        } else if (mode == kXMP_SeekFromEnd) {
+            newOffset += m_length;
+        }
+        if (newOffset < 0) {
+            throw XMP_Error(kXMPErr_EnforceFailure, "MemoryIO::Seek, negative offset");
+        }
+        if (newOffset > m_length) {
+            checkWritable();
+            m_length = newOffset;
+            m_owned.resize(static_cast<size_t>(m_length));
+        }
+        m_offset = newOffset;
+        return m_offset;
+    }
+    virtual XMP_Int64 Length() override
+    {
+        return m_length;
+    }
+    virtual void Truncate(XMP_Int64 length) override
+    {
+        checkWritable();
+        if (length > m_length) {
+            throw XMP_Error(kXMPErr_EnforceFailure, "MemoryIO::Truncate, can't extend");
+        }
+        m_length = length;
+        m_owned.resize(static_cast<size_t>(m_length));
+        if (m_offset > m_length) {
+            m_offset = m_length;
+        }
+    }
+    virtual XMP_IO *DeriveTemp() override
+    {
+        checkWritable();
+        if (!m_temp) {
+            m_temp = new MemoryIO;
+        }
+        return m_temp;
+    }
+    virtual void AbsorbTemp() override
+    {
+        if (!m_temp) {
+            throw XMP_Error(kXMPErr_InternalFailure, "MemoryIO::AbsorbTemp, no temp to absorb");
+        }
+        m_owned.swap(m_temp->m_owned);
+        m_length = m_temp->m_length;
+        m_offset = 0;
+        DeleteTemp();
+    }
+    virtual void DeleteTemp() override
+    {
+        delete m_temp;
+        m_temp = nullptr;
+    }
+
+private:
+    void checkWritable() const
+    {
+        if (m_readOnly) {
+            throw XMP_Error(kXMPErr_FilePermission, "MemoryIO, the buffer is read-only");
+        }
+    }
+
+    const XMP_Uns8 *m_view;
+    std::vector<XMP_Uns8> m_owned;
+    XMP_Int64 m_length;
+    bool m_readOnly;
+    XMP_Int64 m_offset;
+    MemoryIO *m_temp;
+};
+
+/** XMP_IO calling back into the client. Safe updates are written to a
+ * MemoryIO temp first, then copied back through the callbacks.
+ */
+class CallbackIO : public XMP_IO {
+public:
+    CallbackIO(const XmpIOCallbacks &callbacks, void *opaque)
+        : m_callbacks(callbacks)
+        , m_opaque(opaque)
+        , m_offset(0)
+        , m_temp(nullptr)
+    {
+        m_length = m_callbacks.length(m_opaque);
+        if (m_length < 0) {
+            throw XMP_Error(kXMPErr_ExternalFailure, "CallbackIO, length callback failure");
+        }
+    }
+    virtual ~CallbackIO()
+    {
+        delete m_temp;
+    }
+
+    virtual XMP_Uns32 Read(void *buffer, XMP_Uns32 count, bool readAll) override
+    {
+        XMP_Int64 available = m_length - m_offset;
+        if (count > available) {
+            if (readAll) {
+                throw XMP_Error(kXMPErr_EnforceFailure, "CallbackIO::Read, not enough data");
+            }
+            count = static_cast<XMP_Uns32>(available);
+        }
+        XMP_Uns8 *dest = static_cast<XMP_Uns8 *>(buffer);
+        XMP_Uns32 total = 0;
+        while (total < count) {
+            int64_t got = m_callbacks.read(m_opaque, m_offset + total,
+                                           dest + total, count - total);
+            if (got < 0) {
+                throw XMP_Error(kXMPErr_ReadError, "CallbackIO::Read, read callback failure");
+            }
+            if (got == 0) {
+                break;
+            }
+            total += static_cast<XMP_Uns32>(got);
+        }
+        if (readAll && (total != count)) {
+            throw XMP_Error(kXMPErr_EnforceFailure, "CallbackIO::Read, not enough data");
+        }
+        m_offset += total;
+        return total;
+    }
+    virtual void Write(const void *buffer, XMP_Uns32 count) override
+    {
+        writeAt(m_offset, buffer, count);
+        m_offset += count;
+        if (m_offset > m_length) {
+            m_length = m_offset;
+        }
+    }
+    virtual XMP_Int64 Seek(XMP_Int64 offset, SeekMode mode) override
+    {
+        XMP_Int64 newOffset = offset;
+        if (mode == kXMP_SeekFromCurrent) {
+            newOffset += m_offset;
+        } else if (mode == kXMP_SeekFromEnd) {
+            newOffset += m_length;
+        }
+        if (newOffset < 0) {
+            throw XMP_Error(kXMPErr_EnforceFailure, "CallbackIO::Seek, negative offset");
+        }
+        if (newOffset > m_length) {
+            setLength(newOffset);
+        }
+        m_offset = newOffset;
+        return m_offset;
+    }
+    virtual XMP_Int64 Length() override
+    {
+        return m_length;
+    }
+    virtual void Truncate(XMP_Int64 length) override
+    {
+        if (length > m_length) {
+            throw XMP_Error(kXMPErr_EnforceFailure, "CallbackIO::Truncate, can't extend");
+        }
+        setLength(length);
+        if (m_offset > m_length) {
+            m_offset = m_length;
+        }
+    }
+    virtual XMP_IO *DeriveTemp() override
+    {
+        if (!m_callbacks.write) {
+            throw XMP_Error(kXMPErr_FilePermission, "CallbackIO, no write callback");
+        }
+        if (!m_temp) {
+            m_temp = new MemoryIO;
+        }
+        return m_temp;
+    }
+    virtual void AbsorbTemp() override
+    {
+        if (!m_temp) {
+            throw XMP_Error(kXMPErr_InternalFailure, "CallbackIO::AbsorbTemp, no temp to absorb");
+        }
+        const XMP_Uns8 *data = m_temp->data();
+        XMP_Int64 length = m_temp->Length();
+        const XMP_Int64 chunk = 1024 * 1024;
+        for (XMP_Int64 done = 0; done < length; done += chunk) {
+            XMP_Int64 count = std::min(chunk, length - done);
+            writeAt(done, data + done, static_cast<XMP_Uns32>(count));
+        }
+        setLength(length);
+        m_offset = 0;
+        DeleteTemp();
+    }
+    virtual void DeleteTemp() override
+    {
+        delete m_temp;
+        m_temp = nullptr;
+    }
+
+private:
+    void writeAt(XMP_Int64 offset, const void *buffer, XMP_Uns32 count)
+    {
+        if (!m_callbacks.write) {
+            throw XMP_Error(kXMPErr_FilePermission, "CallbackIO, no write callback");
+        }
+        if (m_callbacks.write(m_opaque, offset, buffer, count) != 0) {
+            throw XMP_Error(kXMPErr_WriteError, "CallbackIO, write callback failure");
+        }
+    }
+    void setLength(XMP_Int64 length)
+    {
+        if (!m_callbacks.truncate) {
+            throw XMP_Error(kXMPErr_FilePermission, "CallbackIO, no truncate callback");
+        }
+        if (m_callbacks.truncate(m_opaque, length) != 0) {
+            throw XMP_Error(kXMPErr_WriteError, "CallbackIO, truncate callback failure");
+        }
+        m_length = length;
+    }
+
+    XmpIOCallbacks m_callbacks;
+    void *m_opaque;
+    XMP_Int64 m_length;
+    XMP_Int64 m_offset;
+    MemoryIO *m_temp;
+};
+
+/** Holds the I/O object of a client I/O session. A base class of IOFiles so
+ * that it is destroyed after the SXMPFiles part, which refers to it.
+ */
+struct IOHolder {
+    explicit IOHolder(XMP_IO *io)
+        : m_io(io)
+    {
+    }
+    std::unique_ptr<XMP_IO> m_io;
+};
+
+/** An SXMPFiles that owns the XMP_IO it was opened with. It is what an
+ * XmpFilePtr points to for xmp_files_open_memory() and xmp_files_open_io(),
+ * and is freed like any other by xmp_files_free().
+ */
+class IOFiles : private IOHolder, public SXMPFiles {
+public:
+    explicit IOFiles(XMP_IO *io)
+        : IOHolder(io)
+    {
+    }
+    bool open(XmpOpenFileOptions options)
+    {
+        return OpenFile(m_io.get(), XMP_FT_UNKNOWN, options);
+    }
+};
+
+}
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -303,6 +616,88 @@ bool xmp_files_open(XmpFilePtr xf, const char *path, XmpOpenFileOptions options)
     return false;
 }
 
+bool xmp_files_set_parse_namespaces(XmpFilePtr xf, const char **namespaces,
+                                    size_t count)
+{
+    CHECK_PTR(xf, false);
+    RESET_ERROR;
+
+    if (count > INT32_MAX) {
+        set_error(XMPErr_BadParam);
+        return false;
+    }
+
+    auto txf = reinterpret_cast<SXMPFiles *>(xf);
+    try {
+        txf->SetParseNamespaces(namespaces, (XMP_Index)count);
+    }
+    catch (const XMP_Error &e) {
+        set_error(e);
+        return false;
+    }
+    return true;
+}
+
+XmpFilePtr xmp_files_open_memory(const void *buffer, size_t len,
+                                 XmpOpenFileOptions options)
+{
+    CHECK_PTR(buffer, NULL);
+    RESET_ERROR;
+
+    if (options & XMP_OPEN_FORUPDATE) {
+        set_error(XMPErr_BadParam);
+        return NULL;
+    }
+
+    try {
+        auto txf = std::unique_ptr<IOFiles>(
+            new IOFiles(new MemoryIO(buffer, len)));
+
+        if (!txf->open(options)) {
+            set_error(XMPErr_NoFileHandler);
+            return NULL;
+        }
+
+        return reinterpret_cast<XmpFilePtr>(static_cast<SXMPFiles *>(txf.release()));
+    }
+    catch (const XMP_Error &e) {
+        set_error(e);
+    }
+
+    return NULL;
+}
+
+XmpFilePtr xmp_files_open_io(const XmpIOCallbacks *callbacks, void *opaque,
+                             XmpOpenFileOptions options)
+{
+    CHECK_PTR(callbacks, NULL);
+    RESET_ERROR;
+
+    if (!callbacks->read || !callbacks->length ||
+        ((options & XMP_OPEN_FORUPDATE) &&
+         (!callbacks->write || !callbacks->truncate))) {
+        set_error(XMPErr_BadParam);
+        return NULL;
+    }
+
+    try {
+        auto txf = std::unique_ptr<IOFiles>(
+            new IOFiles(new CallbackIO(*callbacks, opaque)));
+
+        if (!txf->open(options)) {
+            set_error(XMPErr_NoFileHandler);
+            return NULL;
+        }
+
+        return reinterpret_cast<XmpFilePtr>(static_cast<SXMPFiles *>(txf.release()));
+    }
+    catch (const XMP_Error &e) {
+        set_error(e);
+    }
+
+    return NULL;
+}
+
 bool xmp_files_close(XmpFilePtr xf, XmpCloseFileOptions options)
 {
     CHECK_PTR(xf, false);
@@ -558,6 +953,20 @@ XmpFileType xmp_files_check_file_format(const char *filePath)
     return file_type;
 }
 
+bool xmp_files_set_format_cache(uint32_t capacity, const char *snapshotPath)
+{
+    RESET_ERROR;
+
+    try {
+        SXMPFiles::SetFormatCache(capacity, snapshotPath);
+    }
+    catch (const XMP_Error &e) {
+        set_error(e);
+        return false;
+    }
+    return true;
+}
+
 XmpPtr xmp_new_empty()
 {
     RESET_ERROR;
@@ -611,6 +1020,117 @@ bool xmp_parse(XmpPtr xmp, const char *buffer, size_t len)
     return true;
 }
 
+bool xmp_parse_with_options(XmpPtr xmp, const char *buffer, size_t len,
+                            uint32_t options)
+{
+    CHECK_PTR(xmp, false);
+    CHECK_PTR(buffer, false);
+
+    SXMPMeta *txmp = (SXMPMeta *)xmp;
+    try {
+        txmp->ParseFromBuffer(buffer, len, options);
+    }
+    catch (const XMP_Error &e) {
+        set_error(e);
+        return false;
+    }
+    return true;
+}
+
+bool xmp_set_parse_namespaces(XmpPtr xmp, const char **namespaces,
+                              size_t count)
+{
+    CHECK_PTR(xmp, false);
+    RESET_ERROR;
+
+    if (count > INT32_MAX) {
+        set_error(XMPErr_BadParam);
+        return false;
+    }
+
+    SXMPMeta *txmp = (SXMPMeta *)xmp;
+    try {
+        txmp->SetParseNamespaces(namespaces, (XMP_Index)count);
+    }
+    catch (const XMP_Error &e) {
+        set_error(e);
+        return false;
+    }
+    return true;
+}
+
+bool xmp_parse_batch(const char **buffers, const size_t *lens, size_t count,
+                     uint32_t options, XmpPtr *xmps, int *errors)
+{
+    RESET_ERROR;
+    if (count == 0) {
+        return true;
+    }
+    CHECK_PTR(buffers, false);
+    CHECK_PTR(lens, false);
+    CHECK_PTR(xmps, false);
+
+    if (count > INT32_MAX) {
+        set_error(XMPErr_BadParam);
+        return false;
+    }
+    std::vector<XMP_StringLen> sizes(count);
+    for (size_t i = 0; i < count; i++) {
+        if (lens[i] >= kXMP_UseNullTermination) {
+            set_error(XMPErr_BadParam);
+            return false;
+        }
+        sizes[i] = (XMP_StringLen)lens[i];
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        xmps[i] = NULL;
+    }
+    std::vector<XMP_Int32> errorIDs(count);
+    try {
+        std::vector<SXMPMeta> parsed(count);
+        SXMPMeta::ParseBatch((XMP_Index)count, buffers, sizes.data(),
+                             parsed.data(), errorIDs.data(), options);
+
+        // Copy all the results before handing any out, so that nothing
+        // leaks if one of the copies fails.
+        std::vector<std::unique_ptr<SXMPMeta>> results(count);
+        for (size_t i = 0; i < count; i++) {
+            if (errorIDs[i] == kXMPErr_NoError) {
+                results[i].reset(new SXMPMeta(parsed[i]));
+            }
+        }
+
+        bool all_parsed = true;
+        for (size_t i = 0; i < count; i++) {
+            int err = 0;
+            if (results[i]) {
+                xmps[i] = reinterpret_cast<XmpPtr>(results[i].release());
+            } else {
+                err = -errorIDs[i];
+                if (all_parsed) {
+                    set_error(err);
+                    all_parsed = false;
+                }
+            }
+            if (errors) {
+                errors[i] = err;
+            }
+        }
+        return all_parsed;
+    }
+    catch (const XMP_Error &e) {
+        set_error(e);
+    }
+    catch (const std::bad_alloc &) {
+        set_error(XMPErr_NoMemory);
+    }
+    catch (...) {
+        set_error(XMPErr_UnknownException);
+    }
+    return false;
+}
+
 bool xmp_serialize(XmpPtr xmp, XmpStringPtr buffer, uint32_t options,
                    uint32_t padding)
 {
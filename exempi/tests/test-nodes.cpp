@@ -0,0 +1,346 @@
+/*
+ * exempi - test-nodes.cpp
+ *
+ * Copyright (C) 2026 The exempi contributors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1 Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *
+ * 2 Redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the
+ * distribution.
+ *
+ * 3 Neither the name of the Authors, nor the names of its
+ * contributors may be used to endorse or promote products derived
+ * from this software wit hout specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MAIN
+
+#include <stdio.h>
+#include <string.h>
+
+#include <atomic>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include "../../XMPCore/source/XMPMeta.hpp"
+
+#include "utils.h"
+
+using boost::unit_test::test_suite;
+
+struct Fixture {
+  Fixture() {
+    XMPMeta::Initialize();
+  }
+  ~Fixture() {
+    XMPMeta::Terminate();
+  }
+};
+
+BOOST_GLOBAL_FIXTURE(Fixture);
+
+static const char *kPacket =
+  "<x:xmpmeta xmlns:x='adobe:ns:meta/'>"
+  "<rdf:RDF xmlns:rdf='http://www.w3.org/1999/02/22-rdf-syntax-ns#'>"
+  "<rdf:Description rdf:about=''"
+  " xmlns:dc='http://purl.org/dc/elements/1.1/'"
+  " xmlns:xmp='http://ns.adobe.com/xap/1.0/'"
+  " xmlns:ex='http://ns.example.com/nodes/1.0/' xmp:Rating='3'>"
+  "<dc:title><rdf:Alt><rdf:li xml:lang='x-default'>T</rdf:li></rdf:Alt>"
+  "</dc:title>"
+  "<dc:subject><rdf:Bag><rdf:li>a</rdf:li><rdf:li>b</rdf:li><rdf:li>c</rdf:li>"
+  "</rdf:Bag></dc:subject>"
+  "<ex:s rdf:parseType='Resource'><ex:f>1</ex:f><ex:g>2</ex:g></ex:s>"
+  "</rdf:Description></rdf:RDF></x:xmpmeta>";
+
+static std::string serialize(const XMPMeta &meta)
+{
+  std::string rdf;
+  meta.SerializeToBuffer(&rdf, kXMP_OmitPacketWrapper, 0, "\n", " ", 0);
+  return rdf;
+}
+
+// A thread_local destroyed after the node cache and the Expat adapter pool
+// of its thread, it is constructed first. It parses once more before freeing
+// its object.
+struct ExitHolder {
+  XMPMeta *meta;
+  ExitHolder() : meta(0) {}
+  ~ExitHolder()
+  {
+    if (meta != 0) {
+      meta->ParseFromBuffer(kPacket, (XMP_StringLen)strlen(kPacket), 0);
+    }
+    delete meta;
+  }
+};
+
+static thread_local ExitHolder sExitHolder;
+
+static const int kThreadCount = 4;
+static const int kLoopCount = 200;
+
+static void createCloneFree(const std::string *expected,
+                            std::vector<XMPMeta *> *handOff,
+                            std::atomic<int> *failures)
+{
+  sExitHolder.meta = 0;
+
+  for (int i = 0; i < kLoopCount; ++i) {
+    XMPMeta *meta = new XMPMeta();
+    meta->ParseFromBuffer(kPacket, (XMP_StringLen)strlen(kPacket), 0);
+    XMPMeta *clone = new XMPMeta();
+    meta->Clone(clone, 0);
+    meta->SetProperty("http://ns.example.com/nodes/1.0/", "extra", "x", 0);
+    meta->DeleteProperty("http://ns.example.com/nodes/1.0/", "extra");
+    if ((serialize(*meta) != *expected) || (serialize(*clone) != *expected)) {
+      ++(*failures);
+    }
+    delete meta;
+    if (i % 10 == 0) {
+      handOff->push_back(clone);  // Freed by another thread.
+    } else {
+      delete clone;
+    }
+  }
+
+  sExitHolder.meta = new XMPMeta();
+  sExitHolder.meta->ParseFromBuffer(kPacket, (XMP_StringLen)strlen(kPacket),
+                                    0);
+}
+
+// Children beyond XMP_NodeOffspring::kMinIndexedSize are found through the
+// name index.
+static const int kWideCount = 40;
+static const char *kNS_Wide = "http://ns.example.com/wide/1.0/";
+
+typedef std::map<std::string, std::string> ExpectedValues;  // "" if deleted.
+
+static std::string wideName(const char *prefix, int i)
+{
+  char name[16];
+  snprintf(name, sizeof(name), "%s%02d", prefix, i);
+  return name;
+}
+
+static std::string widePacket(const char *extraProperty, const char *extraField)
+{
+  std::string packet =
+    "<x:xmpmeta xmlns:x='adobe:ns:meta/'>"
+    "<rdf:RDF xmlns:rdf='http://www.w3.org/1999/02/22-rdf-syntax-ns#'>"
+    "<rdf:Description rdf:about='' xmlns:w='http://ns.example.com/wide/1.0/'>";
+  for (int i = kWideCount - 1; i >= 0; --i) {
+    std::string name = "w:" + wideName("p", i);
+    packet += "<" + name + ">" + wideName("v", i) + "</" + name + ">";
+  }
+  packet += extraProperty;
+  packet += "<w:s rdf:parseType='Resource'>";
+  for (int i = kWideCount - 1; i >= 0; --i) {
+    std::string name = "w:" + wideName("f", i);
+    packet += "<" + name + ">" + wideName("v", i) + "</" + name + ">";
+  }
+  packet += extraField;
+  packet += "</w:s></rdf:Description></rdf:RDF></x:xmpmeta>";
+  return packet;
+}
+
+static int checkValues(const XMPMeta &meta, const ExpectedValues &properties,
+                       const ExpectedValues &fields)
+{
+  int failures = 0;
+  XMP_StringPtr value;
+  XMP_StringLen valueLen;
+  XMP_OptionBits options;
+
+  for (ExpectedValues::const_iterator pos = properties.begin();
+       pos != properties.end(); ++pos) {
+    std::string path = "w:" + pos->first;
+    bool found =
+      meta.GetProperty(kNS_Wide, path.c_str(), &value, &valueLen, &options);
+    if (found != !pos->second.empty() ||
+        (found && (pos->second != std::string(value, valueLen)))) {
+      BOOST_TEST_MESSAGE("property " << pos->first);
+      ++failures;
+    }
+  }
+  for (ExpectedValues::const_iterator pos = fields.begin();
+       pos != fields.end(); ++pos) {
+    std::string field = "w:" + pos->first;
+    bool found = meta.GetStructField(kNS_Wide, "w:s", kNS_Wide, field.c_str(),
+                                     &value, &valueLen, &options);
+    if (found != !pos->second.empty() ||
+        (found && (pos->second != std::string(value, valueLen)))) {
+      BOOST_TEST_MESSAGE("field " << pos->first);
+      ++failures;
+    }
+  }
+  return failures;
+}
+
+BOOST_AUTO_TEST_SUITE(test_nodes)
+
+BOOST_AUTO_TEST_CASE(test_wideChildren)
+{
+  ExpectedValues properties;
+  ExpectedValues fields;
+  for (int i = 0; i < kWideCount; ++i) {
+    properties[wideName("p", i)] = wideName("v", i);
+    fields[wideName("f", i)] = wideName("v", i);
+  }
+
+  XMPMeta meta;
+  std::string packet = widePacket("", "");
+  meta.ParseFromBuffer(packet.data(), (XMP_StringLen)packet.size(), 0);
+  BOOST_CHECK(checkValues(meta, properties, fields) == 0);
+
+  // Set existing and new children, each lookup after a new child.
+  for (int i = 0; i < kWideCount + 10; ++i) {
+    std::string name = wideName("p", i);
+    properties[name] = "set-" + name;
+    meta.SetProperty(kNS_Wide, ("w:" + name).c_str(),
+                     properties[name].c_str(), 0);
+    std::string field = wideName("f", i);
+    fields[field] = "set-" + field;
+    meta.SetStructField(kNS_Wide, "w:s", kNS_Wide, ("w:" + field).c_str(),
+                        fields[field].c_str(), 0);
+  }
+  BOOST_CHECK(checkValues(meta, properties, fields) == 0);
+
+  // Delete every third child, the later ones move down.
+  for (int i = 0; i < kWideCount + 10; i += 3) {
+    std::string name = wideName("p", i);
+    meta.DeleteProperty(kNS_Wide, ("w:" + name).c_str());
+    properties[name] = "";
+    std::string field = wideName("f", i);
+    meta.DeleteStructField(kNS_Wide, "w:s", kNS_Wide, ("w:" + field).c_str());
+    fields[field] = "";
+  }
+  BOOST_CHECK(checkValues(meta, properties, fields) == 0);
+
+  meta.Sort();
+  BOOST_CHECK(checkValues(meta, properties, fields) == 0);
+
+  XMPMeta clone;
+  meta.Clone(&clone, 0);
+  BOOST_CHECK(checkValues(clone, properties, fields) == 0);
+
+  // Put the deleted ones back at the end.
+  for (int i = 0; i < kWideCount + 10; i += 3) {
+    std::string name = wideName("p", i);
+    properties[name] = "again-" + name;
+    meta.SetProperty(kNS_Wide, ("w:" + name).c_str(),
+                     properties[name].c_str(), 0);
+    std::string field = wideName("f", i);
+    fields[field] = "again-" + field;
+    meta.SetStructField(kNS_Wide, "w:s", kNS_Wide, ("w:" + field).c_str(),
+                        fields[field].c_str(), 0);
+  }
+  BOOST_CHECK(checkValues(meta, properties, fields) == 0);
+
+  // A duplicate beyond the first 32 children is an error.
+  const char *duplicates[][2] = {
+    { "<w:p07>dup</w:p07>", "" },
+    { "", "<w:f07>dup</w:f07>" },
+  };
+  for (size_t d = 0; d < 2; ++d) {
+    packet = widePacket(duplicates[d][0], duplicates[d][1]);
+    for (XMP_OptionBits streaming = 0; streaming <= kXMP_ParseStreaming;
+         streaming += kXMP_ParseStreaming) {
+      XMPMeta strict;
+      strict.SetErrorCallback(&callErrorCallback, &throwErrors, 0, 1);
+      XMP_Int32 errorID = kXMPErr_NoError;
+      try {
+        strict.ParseFromBuffer(packet.data(), (XMP_StringLen)packet.size(),
+                               streaming);
+      } catch (XMP_Error &e) {
+        errorID = e.GetID();
+      }
+      BOOST_CHECK(errorID == kXMPErr_BadXMP);
+
+      XMPMeta lenient;
+      lenient.ParseFromBuffer(packet.data(), (XMP_StringLen)packet.size(),
+                              streaming);
+      XMP_StringPtr value;
+      XMP_StringLen valueLen;
+      XMP_OptionBits options;
+      BOOST_CHECK(lenient.GetProperty(kNS_Wide, "w:p07", &value, &valueLen,
+                                      &options));
+      BOOST_CHECK(std::string(value, valueLen) == "v07");
+      BOOST_CHECK(lenient.GetStructField(kNS_Wide, "w:s", kNS_Wide, "w:f07",
+                                         &value, &valueLen, &options));
+      BOOST_CHECK(std::string(value, valueLen) == "v07");
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(test_threadedNodes)
+{
+  std::string expected;
+  {
+    XMPMeta meta;
+    meta.ParseFromBuffer(kPacket, (XMP_StringLen)strlen(kPacket), 0);
+    expected = serialize(meta);
+  }
+
+  std::atomic<int> failures(0);
+  std::vector<std::vector<XMPMeta *> > handOffs(kThreadCount);
+
+  for (int round = 0; round < 2; ++round) {
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreadCount; ++t) {
+      threads.push_back(
+        std::thread(createCloneFree, &expected, &handOffs[t], &failures));
+    }
+    for (int t = 0; t < kThreadCount; ++t) {
+      threads[t].join();
+    }
+
+    // Free the objects of each thread on the next one.
+    threads.clear();
+    for (int t = 0; t < kThreadCount; ++t) {
+      std::vector<XMPMeta *> *handOff = &handOffs[(t + 1) % kThreadCount];
+      threads.push_back(std::thread([handOff, &expected, &failures]() {
+        for (size_t i = 0; i < handOff->size(); ++i) {
+          if (serialize(*(*handOff)[i]) != expected) {
+            ++failures;
+          }
+          delete (*handOff)[i];
+        }
+        handOff->clear();
+      }));
+    }
+    for (int t = 0; t < kThreadCount; ++t) {
+      threads[t].join();
+    }
+  }
+
+  BOOST_CHECK(failures.load() == 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,368 @@
+/*
+ * exempi - test-parse-stream.cpp
+ *
+ * Copyright (C) 2026 The exempi contributors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1 Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *
+ * 2 Redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the
+ * distribution.
+ *
+ * 3 Neither the name of the Authors, nor the names of its
+ * contributors may be used to endorse or promote products derived
+ * from this software wit hout specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MAIN
+
+#include <algorithm>
+#include <string>
+
+#include <boost/test/unit_test.hpp>
+
+#include "../../XMPCore/source/XMPMeta.hpp"
+
+#include "utils.h"
+
+using boost::unit_test::test_suite;
+
+struct Fixture {
+  Fixture() {
+    XMPMeta::Initialize();
+  }
+  ~Fixture() {
+    XMPMeta::Terminate();
+  }
+};
+
+BOOST_GLOBAL_FIXTURE(Fixture);
+
+#define RDF_START \
+  "<rdf:RDF xmlns:rdf='http://www.w3.org/1999/02/22-rdf-syntax-ns#'" \
+  " xmlns:dc='http://purl.org/dc/elements/1.1/'" \
+  " xmlns:xmp='http://ns.adobe.com/xap/1.0/'" \
+  " xmlns:photoshop='http://ns.adobe.com/photoshop/1.0/'" \
+  " xmlns:ex='http://ns.example.com/parse/1.0/'>"
+#define RDF_END "</rdf:RDF>"
+#define XMPMETA_START "<x:xmpmeta xmlns:x='adobe:ns:meta/'>"
+#define XMPMETA_END "</x:xmpmeta>"
+#define DESC_START "<rdf:Description rdf:about=''>"
+#define DESC_END "</rdf:Description>"
+#define PACKET(props) \
+  XMPMETA_START RDF_START DESC_START props DESC_END RDF_END XMPMETA_END
+
+struct ParseCase {
+  const char *name;
+  const char *xml;
+  bool bad;   // The tree parse throws.
+};
+
+static const ParseCase kParseCases[] = {
+  { "simple", PACKET("<ex:a>1</ex:a><ex:b>two &amp; &#x33;</ex:b>"), false },
+  { "attribute properties",
+    XMPMETA_START RDF_START
+    "<rdf:Description rdf:about='' ex:a='1' xmp:Rating='3'/>"
+    RDF_END XMPMETA_END, false },
+  { "parseType Resource",
+    PACKET("<ex:res rdf:parseType='Resource'><ex:a>1</ex:a>"
+           "<ex:b rdf:parseType='Resource'><ex:c>3</ex:c></ex:b></ex:res>"),
+    false },
+  { "empty parseType Resource",
+    PACKET("<ex:res rdf:parseType='Resource'/>"), false },
+  { "parseType Literal",
+    PACKET("<ex:lit rdf:parseType='Literal'><b>x</b></ex:lit>"), true },
+  { "parseType Collection",
+    PACKET("<ex:col rdf:parseType='Collection'><rdf:Description/></ex:col>"),
+    true },
+  { "parseType Other",
+    PACKET("<ex:other rdf:parseType='Other'>x</ex:other>"), true },
+  { "rdf:value with qualifiers",
+    PACKET("<ex:q rdf:parseType='Resource'><rdf:value>v</rdf:value>"
+           "<ex:qual>q</ex:qual></ex:q>"
+           "<ex:r><rdf:Description><rdf:value xml:lang='en'>w</rdf:value>"
+           "<ex:qual>r</ex:qual></rdf:Description></ex:r>"),
+    false },
+  { "struct with rdf:value and fields",
+    PACKET("<ex:s><rdf:Description ex:f='1'><ex:g>2</ex:g>"
+           "</rdf:Description></ex:s>"), false },
+  { "empty property elements",
+    PACKET("<ex:e1 rdf:resource='http://ns.example.com/r'/>"
+           "<ex:e2 ex:f1='a' ex:f2='b'/>"
+           "<ex:e3 rdf:resource='http://ns.example.com/s' ex:qual='q'/>"
+           "<ex:e4/>"
+           "<ex:e5 rdf:value='v' ex:qual='q'/>"
+           "<ex:e6 xml:lang='fr' rdf:value='v'/>"
+           "<ex:e7 rdf:nodeID='n' ex:f='x'/>"),
+    false },
+  { "empty property with rdf:resource and rdf:value",
+    PACKET("<ex:e rdf:resource='http://ns.example.com/r' rdf:value='v'/>"),
+    true },
+  { "xml:lang",
+    XMPMETA_START RDF_START
+    "<rdf:Description rdf:about='' xml:lang='de'>"
+    "<dc:title><rdf:Alt><rdf:li xml:lang='en-US'>T us</rdf:li>"
+    "<rdf:li xml:lang='x-default'>T</rdf:li></rdf:Alt></dc:title>"
+    "<ex:a>inherited</ex:a><ex:b xml:lang='fr'>own</ex:b>"
+    "</rdf:Description>" RDF_END XMPMETA_END,
+    false },
+  { "arrays",
+    PACKET("<dc:subject><rdf:Bag><rdf:li>a</rdf:li><rdf:li>b</rdf:li>"
+           "</rdf:Bag></dc:subject>"
+           "<ex:seq><rdf:Seq><rdf:li rdf:parseType='Resource'>"
+           "<ex:f>1</ex:f></rdf:li><rdf:li rdf:parseType='Resource'>"
+           "<rdf:value>2</rdf:value><ex:q>x</ex:q></rdf:li>"
+           "<rdf:li/></rdf:Seq></ex:seq>"),
+    false },
+  { "property attributes with content",
+    PACKET("<ex:seq><rdf:Seq><rdf:li ex:q='x'>2</rdf:li></rdf:Seq></ex:seq>"),
+    true },
+  { "alias", PACKET("<photoshop:Author>me</photoshop:Author>"), false },
+  { "duplicate properties", PACKET("<ex:d>1</ex:d><ex:d>2</ex:d>"), true },
+  { "duplicate across descriptions",
+    XMPMETA_START RDF_START
+    DESC_START "<ex:d>1</ex:d>" DESC_END
+    DESC_START "<ex:d>2</ex:d>" DESC_END
+    RDF_END XMPMETA_END, true },
+  { "multiple rdf:Description",
+    XMPMETA_START RDF_START
+    DESC_START "<ex:a>1</ex:a>" DESC_END
+    "<rdf:Description rdf:about='' ex:b='2'/>"
+    "<rdf:Description><dc:format>x</dc:format></rdf:Description>"
+    RDF_END XMPMETA_END, false },
+  { "mismatched rdf:about",
+    XMPMETA_START RDF_START
+    "<rdf:Description rdf:about='a'><ex:a>1</ex:a></rdf:Description>"
+    "<rdf:Description rdf:about='b'><ex:b>2</ex:b></rdf:Description>"
+    RDF_END XMPMETA_END, true },
+  { "multiple rdf:RDF",
+    XMPMETA_START RDF_START DESC_START "<ex:a>1</ex:a>" DESC_END RDF_END
+    RDF_START DESC_START "<ex:b>2</ex:b>" DESC_END RDF_END XMPMETA_END,
+    false },
+  { "multiple x:xmpmeta",
+    "<wrap>" PACKET("<ex:a>1</ex:a>") PACKET("<ex:b>2</ex:b>") "</wrap>",
+    false },
+  { "x:xapmeta", "<x:xapmeta xmlns:x='adobe:ns:meta/'>" RDF_START
+    DESC_START "<ex:a>1</ex:a>" DESC_END RDF_END "</x:xapmeta>", false },
+  { "bare rdf:RDF",
+    RDF_START DESC_START "<ex:a>1</ex:a>" DESC_END RDF_END, false },
+  { "rdf:RDF in other XML",
+    "<outer><inner>" RDF_START DESC_START "<ex:a>1</ex:a>" DESC_END RDF_END
+    "</inner></outer>", false },
+  { "comments and PIs",
+    XMPMETA_START "<!-- c -->" RDF_START "<?pi x?>" DESC_START
+    "<ex:a><!-- c -->1</ex:a>" DESC_END RDF_END XMPMETA_END, false },
+  { "packet wrapper",
+    "<?xpacket begin='\xEF\xBB\xBF' id='W5M0MpCehiHzreSzNTczkc9d'?>"
+    PACKET("<ex:a>\xC3\xA9t\xC3\xA9</ex:a>")
+    "<?xpacket end='w'?>", false },
+  { "bad XML", XMPMETA_START RDF_START DESC_START "<ex:a>1</ex:b>", true },
+  { "truncated", XMPMETA_START RDF_START DESC_START "<ex:a>1", true },
+  { "empty", "", false },
+};
+
+static XMP_Status appendText(void *refCon, XMP_StringPtr buffer,
+                             XMP_StringLen bufferSize)
+{
+  static_cast<std::string *>(refCon)->append(buffer, bufferSize);
+  return 0;
+}
+
+struct ParseResult {
+  XMP_Int32 errorID;
+  std::string rdf;
+  std::string dump;   // Also shows the node options.
+
+  bool operator==(const ParseResult &other) const
+  {
+    return (errorID == other.errorID) && (rdf == other.rdf) &&
+           (dump == other.dump);
+  }
+};
+
+// Parse the XML at once or in chunks, and serialize and dump the result. Without the
+// error callback recoverable errors are skipped.
+static ParseResult parse(const std::string &xml, XMP_OptionBits options,
+                         size_t chunkSize, bool strict)
+{
+  ParseResult result;
+  result.errorID = kXMPErr_NoError;
+
+  XMPMeta meta;
+  if (strict) {
+    meta.SetErrorCallback(&callErrorCallback, &throwErrors, 0, 1);
+  }
+  try {
+    if (chunkSize == 0) {
+      meta.ParseFromBuffer(xml.data(), (XMP_StringLen)xml.size(), options);
+    } else {
+      for (size_t pos = 0; pos < xml.size(); pos += chunkSize) {
+        size_t len = std::min(chunkSize, xml.size() - pos);
+        meta.ParseFromBuffer(xml.data() + pos, (XMP_StringLen)len,
+                             options | kXMP_ParseMoreBuffers);
+      }
+      meta.ParseFromBuffer(0, 0, options);
+    }
+    meta.SerializeToBuffer(&result.rdf, kXMP_OmitPacketWrapper, 0, "\n", " ",
+                           0);
+    meta.DumpObject(&appendText, &result.dump);
+  } catch (XMP_Error &e) {
+    result.errorID = e.GetID();
+  }
+  return result;
+}
+
+BOOST_AUTO_TEST_SUITE(test_parse_stream)
+
+BOOST_AUTO_TEST_CASE(test_streamingParity)
+{
+  static const size_t kChunkSizes[] = { 0, 1, 2, 3, 5, 7, 13, 64 };
+
+  for (size_t c = 0; c < sizeof(kParseCases) / sizeof(kParseCases[0]); ++c) {
+    const ParseCase &parseCase = kParseCases[c];
+
+    for (int strict = 0; strict <= 1; ++strict) {
+      for (XMP_OptionBits options = 0; options <= kXMP_RequireXMPMeta;
+           ++options) {
+        ParseResult tree = parse(parseCase.xml, options, 0, strict);
+        if (strict && (options == 0)) {
+          BOOST_CHECK_MESSAGE(
+            (tree.errorID != kXMPErr_NoError) == parseCase.bad,
+            parseCase.name);
+        }
+
+        for (size_t s = 0; s < sizeof(kChunkSizes) / sizeof(kChunkSizes[0]);
+             ++s) {
+          ParseResult chunked =
+            parse(parseCase.xml, options, kChunkSizes[s], strict);
+          ParseResult streamed = parse(
+            parseCase.xml, options | kXMP_ParseStreaming, kChunkSizes[s],
+            strict);
+          BOOST_CHECK_MESSAGE(chunked == tree,
+                              parseCase.name << ", strict " << strict
+                              << ", options " << options
+                              << ", chunk " << kChunkSizes[s]);
+          BOOST_CHECK_MESSAGE(streamed == tree,
+                              parseCase.name << ", streaming, strict "
+                              << strict << ", options " << options
+                              << ", chunk " << kChunkSizes[s]);
+        }
+      }
+    }
+  }
+}
+
+// Values with input that the UTF-8 check must stop at or pass, and the value
+// that is parsed.
+struct InputCase {
+  const char *name;
+  const char *input;
+  const char *value;
+};
+
+static const InputCase kInputCases[] = {
+  { "2-byte", "caf\xC3\xA9 \xC3\xBC\xC3\xBC\xC3\xBC",
+    "caf\xC3\xA9 \xC3\xBC\xC3\xBC\xC3\xBC" },
+  { "3-byte", "\xE2\x82\xAC\xE2\x82\xAC \xE6\x97\xA5\xE6\x9C\xAC",
+    "\xE2\x82\xAC\xE2\x82\xAC \xE6\x97\xA5\xE6\x9C\xAC" },
+  { "4-byte", "\xF0\x9F\x98\x80x\xF0\x9F\x98\x80\xF0\x9F\x98\x80",
+    "\xF0\x9F\x98\x80x\xF0\x9F\x98\x80\xF0\x9F\x98\x80" },
+  { "Latin-1", "caf\xE9 \xA0\xFF\xF8", "caf\xC3\xA9 \xC2\xA0\xC3\xBF\xC3\xB8" },
+  { "Windows 1252", "\x80\x93x\x94", "\xE2\x82\xAC\xE2\x80\x9Cx\xE2\x80\x9D" },
+  { "bad sequences", "\xBFx\xC3y\xE2\x82z\xC3\xA9\xA9",
+    "\xC2\xBFx\xC3\x83y\xC3\xA2\xE2\x80\x9Az\xC3\xA9\xC2\xA9" },
+  { "5-byte lead", "\xF8\x88\x80\x80x",
+    "\xC3\xB8\xCB\x86\xE2\x82\xAC\xE2\x82\xACx" },
+  { "controls", "a\x01" "b\x1F" "c\x7F" "d\te\nf",
+    "a b c d\te\nf" },
+  { "escapes", "a&#x1;b&#x1F;c&#x7f;d&#x9;e&amp;f",
+    "a b c d\te&f" },
+  { "mixed", "\xC3\xA9\x01&#x02;\xE9\xE2\x82\xAC&lt;\xF0\x9F\x98\x80",
+    "\xC3\xA9  \xC3\xA9\xE2\x82\xAC<\xF0\x9F\x98\x80" },
+};
+
+static std::string parseValue(const std::string &xml, XMP_OptionBits options,
+                              size_t chunkSize)
+{
+  XMPMeta meta;
+  if (chunkSize == 0) {
+    meta.ParseFromBuffer(xml.data(), (XMP_StringLen)xml.size(), options);
+  } else {
+    for (size_t pos = 0; pos < xml.size(); pos += chunkSize) {
+      size_t len = std::min(chunkSize, xml.size() - pos);
+      meta.ParseFromBuffer(xml.data() + pos, (XMP_StringLen)len,
+                           options | kXMP_ParseMoreBuffers);
+    }
+    meta.ParseFromBuffer(0, 0, options);
+  }
+
+  XMP_StringPtr value;
+  XMP_StringLen valueLen;
+  XMP_OptionBits valueOptions;
+  if (!meta.GetProperty("http://ns.example.com/parse/1.0/", "ex:v", &value,
+                        &valueLen, &valueOptions)) {
+    return "(missing)";
+  }
+  return std::string(value, valueLen);
+}
+
+BOOST_AUTO_TEST_CASE(test_utf8Input)
+{
+  static const size_t kChunkSizes[] = { 0, 1, 2, 3, 5, 7, 13, 64 };
+  static const char *kPrefix = XMPMETA_START RDF_START DESC_START "<ex:v>";
+
+  // Shift each input through 64 offsets so that every sequence crosses the
+  // 16 and 32 byte blocks of the vector checks, at once and repeated.
+  for (size_t c = 0; c < sizeof(kInputCases) / sizeof(kInputCases[0]); ++c) {
+    const InputCase &inputCase = kInputCases[c];
+
+    for (size_t shift = 0; shift < 64; ++shift) {
+      for (int repeat = 1; repeat <= 8; repeat *= 8) {
+        std::string input(shift, 'x');
+        std::string value(shift, 'x');
+        for (int r = 0; r < repeat; ++r) {
+          input += inputCase.input;
+          value += inputCase.value;
+        }
+        std::string xml = kPrefix + input + "</ex:v>" DESC_END RDF_END
+                          XMPMETA_END;
+
+        for (size_t s = 0; s < sizeof(kChunkSizes) / sizeof(kChunkSizes[0]);
+             ++s) {
+          for (XMP_OptionBits streaming = 0;
+               streaming <= kXMP_ParseStreaming;
+               streaming += kXMP_ParseStreaming) {
+            BOOST_CHECK_MESSAGE(
+              parseValue(xml, streaming, kChunkSizes[s]) == value,
+              inputCase.name << ", shift " << shift << ", repeat " << repeat
+              << ", chunk " << kChunkSizes[s] << ", streaming "
+              << (streaming != 0));
+          }
+        }
+      }
+    }
+  }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,565 @@
+/*
+ * exempi - test-scanner.cpp
+ *
+ * Copyright (C) 2026 The exempi contributors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1 Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *
+ * 2 Redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the
+ * distribution.
+ *
+ * 3 Neither the name of the Authors, nor the names of its
+ * contributors may be used to endorse or promote products derived
+ * from this software wit hout specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <boost/test/minimal.hpp>
+
+#include "utils.h"
+#include "xmp.h"
+#include "xmpconsts.h"
+
+#include "XMPFiles/source/XMPFiles_Impl.hpp"
+#include "XMPFiles/source/FileHandlers/Scanner_Handler.hpp"
+#include "XMPFiles/source/FormatSupport/XMPScanner.hpp"
+
+using boost::unit_test::test_suite;
+
+// The parallel scan splits a 64 MB file in 4 ranges of 16 MB.
+static const long kMB = 1024 * 1024;
+static const long kFileSize = 64 * kMB;
+static const char *kScanFile = "scan.dat";
+
+struct Packet {
+  long offset;
+  int day;         // MetadataDate, the newest packet is the main one.
+  bool terminated; // false for a header that is never closed.
+};
+
+static std::string make_packet(int day)
+{
+  char packet[1024];
+  snprintf(packet, sizeof(packet),
+           "<?xpacket begin=\"\xEF\xBB\xBF\" id=\"W5M0MpCehiHzreSzNTczkc9d\"?>"
+           "<x:xmpmeta xmlns:x=\"adobe:ns:meta/\">"
+           "<rdf:RDF xmlns:rdf=\"http://www.w3.org/1999/02/22-rdf-syntax-ns#\">"
+           "<rdf:Description rdf:about=\"\" "
+           "xmlns:xmp=\"http://ns.adobe.com/xap/1.0/\" "
+           "xmp:MetadataDate=\"2020-01-%02dT00:00:00Z\"/>"
+           "</rdf:RDF></x:xmpmeta><?xpacket end=\"w\"?>",
+           day);
+  return packet;
+}
+
+static bool write_scan_file(const std::vector<Packet> &packets)
+{
+  FILE *fp = fopen(kScanFile, "wb");
+  if (fp == NULL) {
+    return false;
+  }
+  bool ok = (ftruncate(fileno(fp), kFileSize) == 0);
+  for (size_t i = 0; ok && (i < packets.size()); ++i) {
+    std::string packet = make_packet(packets[i].day);
+    if (!packets[i].terminated) {
+      packet.erase(packet.find("<x:xmpmeta"));
+    }
+    ok = (fseek(fp, packets[i].offset, SEEK_SET) == 0) &&
+         (fwrite(packet.data(), 1, packet.size(), fp) == packet.size());
+  }
+  return (fclose(fp) == 0) && ok;
+}
+
+// Return the offset of the main packet, -1 if none, and the packet.
+static int64_t scan_file(XmpOpenFileOptions options, std::string &packet)
+{
+  int64_t offset = -1;
+  packet.clear();
+  XmpFilePtr f = xmp_files_open_new(
+    kScanFile, XmpOpenFileOptions(XMP_OPEN_READ | XMP_OPEN_USEPACKETSCANNING |
+                                  options));
+  BOOST_CHECK(f != NULL);
+  if (f == NULL) {
+    return offset;
+  }
+  XmpStringPtr xmp_packet = xmp_string_new();
+  XmpPacketInfo packet_info;
+  if (xmp_files_get_xmp_xmpstring(f, xmp_packet, &packet_info)) {
+    offset = packet_info.offset;
+    packet = xmp_string_cstr(xmp_packet);
+  }
+  xmp_string_free(xmp_packet);
+  BOOST_CHECK(xmp_files_free(f));
+  return offset;
+}
+
+// Scan the file sequentially and in parallel, both must find the packet
+// that is expected.
+static void check_scan(const std::vector<Packet> &packets, long expected)
+{
+  BOOST_CHECK(write_scan_file(packets));
+
+  std::string sequential_packet;
+  std::string parallel_packet;
+  int64_t sequential = scan_file(XMP_OPEN_NOOPTION, sequential_packet);
+  int64_t parallel = scan_file(XMP_OPEN_PARALLELSCAN, parallel_packet);
+
+  BOOST_CHECK(sequential == expected);
+  BOOST_CHECK(parallel == sequential);
+  BOOST_CHECK(parallel_packet == sequential_packet);
+}
+
+// Client I/O over a std::string that counts the bytes read.
+struct CountedData {
+  std::string data;
+  int64_t bytes_read;
+};
+
+static int64_t counted_read(void *opaque, uint64_t offset, void *buffer,
+                            uint32_t count)
+{
+  CountedData *counted = static_cast<CountedData *>(opaque);
+  if (offset >= counted->data.size()) {
+    return 0;
+  }
+  size_t len = counted->data.copy(static_cast<char *>(buffer), count, offset);
+  counted->bytes_read += len;
+  return len;
+}
+
+static int64_t counted_length(void *opaque)
+{
+  return static_cast<CountedData *>(opaque)->data.size();
+}
+
+// An EPS file with the main packet last and the packets at the offsets
+// given, the newest packet is the last one.
+static void make_eps(CountedData &counted, long size,
+                     const std::vector<long> &offsets)
+{
+  static const char *kHeader = "%!PS-Adobe-3.0 EPSF-3.0\n"
+                               "%%BoundingBox: 0 0 10 10\n"
+                               "%ADO_ContainsXMP: MainLast\n"
+                               "%%EndComments\n";
+  counted.data.assign(size, ' ');
+  counted.data.replace(0, strlen(kHeader), kHeader);
+  for (size_t i = 0; i < offsets.size(); ++i) {
+    std::string packet = make_packet(i + 1);
+    counted.data.replace(offsets[i], packet.size(), packet);
+  }
+  counted.data.replace(size - 6, 6, "%%EOF\n");
+  counted.bytes_read = 0;
+}
+
+// Return the offset of the main packet, -1 if none.
+static int64_t find_eps_packet(CountedData &counted)
+{
+  XmpIOCallbacks callbacks = { counted_read, NULL, counted_length, NULL };
+  XmpFilePtr f = xmp_files_open_io(&callbacks, &counted, XMP_OPEN_READ);
+  BOOST_CHECK(f != NULL);
+  if (f == NULL) {
+    return -1;
+  }
+  int64_t offset = -1;
+  XmpStringPtr xmp_packet = xmp_string_new();
+  XmpPacketInfo packet_info;
+  if (xmp_files_get_xmp_xmpstring(f, xmp_packet, &packet_info)) {
+    offset = packet_info.offset;
+  }
+  xmp_string_free(xmp_packet);
+  BOOST_CHECK(xmp_files_free(f));
+  return offset;
+}
+
+// Filler for the scanner inputs, with decoy '<' characters.
+static const char kFiller[] = { '<', '?', 'x', ' ', '\0' };
+
+static const XMPScanner::CharacterForm kForms[] = {
+  XMPScanner::eChar8Bit, XMPScanner::eChar16BitBig,
+  XMPScanner::eChar16BitLittle, XMPScanner::eChar32BitBig,
+  XMPScanner::eChar32BitLittle
+};
+
+// Encode an ASCII string in one of the scanner character forms, '\1' is
+// the byte order mark and '\2' puts "<?" bytes at each alignment.
+static std::string encode(const char *text, XMPScanner::CharacterForm form)
+{
+  const int width = CharFormIs32Bit(form) ? 4 : (CharFormIs16Bit(form) ? 2 : 1);
+  const int low = CharFormIsLittleEndian(form) ? 0 : width - 1;
+  std::string out;
+  for (; *text != 0; ++text) {
+    if (*text == '\2') {
+      out += "<<<<????";
+    } else if (*text != '\1') {
+      std::string ch(width, '\0');
+      ch[low] = *text;
+      out += ch;
+    } else if (width == 1) {
+      out += "\xEF\xBB\xBF";
+    } else {
+      std::string bom(width, '\0');
+      bom[low] = '\xFF';
+      bom[CharFormIsLittleEndian(form) ? 1 : width - 2] = '\xFE';
+      out += bom;
+    }
+  }
+  return out;
+}
+
+static XMPScanner::SnipInfoVector scan_chunks(const char *data, long len,
+                                              long chunk)
+{
+  XMPScanner scanner(len);
+  for (long pos = 0; pos < len; pos += chunk) {
+    scanner.Scan(data + pos, pos, std::min(chunk, len - pos));
+  }
+  XMPScanner::SnipInfoVector snips;
+  scanner.Report(snips);
+  return snips;
+}
+
+static bool same_snips(const XMPScanner::SnipInfoVector &a,
+                       const XMPScanner::SnipInfoVector &b)
+{
+  if (a.size() != b.size()) {
+    return false;
+  }
+  for (size_t i = 0; i < a.size(); ++i) {
+    if ((a[i].fOffset != b[i].fOffset) || (a[i].fLength != b[i].fLength) ||
+        (a[i].fState != b[i].fState) || (a[i].fCharForm != b[i].fCharForm)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// The packet '<' search uses SSE2 and AVX2 vectors where it can. Scan a
+// packet in each character form at every alignment, in filler full of decoy
+// '<' characters that ends at or just after the packet, and compare the
+// snips with those of the byte-by-byte search. A few spaces keep a decoy header
+// in the filler from running into the packet.
+static void test_vector_search()
+{
+  static const long kTrails[] = { 0, 1, 5, 40 };
+  static const long kChunks[] = { 13, 48, 100, 0 };
+  std::minstd_rand random(1);
+  int failures = 0;
+
+  for (size_t f = 0; f < sizeof(kForms) / sizeof(kForms[0]); ++f) {
+    const std::string packet = encode(
+      "<?xpacket begin='\1' id='W5M0MpCehiHzreSzNTczkc9d'?>"
+      "<x:xmpmeta xmlns:x='adobe:ns:meta/'>\2</x:xmpmeta>"
+      "<?xpacket end='w'?>",
+      kForms[f]);
+    for (long lead = 0; lead < 64; ++lead) {
+      for (size_t t = 0; t < sizeof(kTrails) / sizeof(kTrails[0]); ++t) {
+        std::string input;
+        for (long i = 0; i < lead; ++i) {
+          input += kFiller[random() % sizeof(kFiller)];
+        }
+        input += "    ";
+        input += packet;
+        for (long i = 0; i < kTrails[t]; ++i) {
+          input += kFiller[random() % sizeof(kFiller)];
+        }
+        if (kTrails[t] != 0) {
+          input[input.size() - 1] = '<';
+        }
+        // Move the input in memory too, the vector loads are unaligned.
+        const long len = input.size();
+        std::vector<char> storage(len + 31);
+        char *data = &storage[(lead * 7) % 32];
+        memcpy(data, input.data(), len);
+
+        for (size_t c = 0; c < sizeof(kChunks) / sizeof(kChunks[0]); ++c) {
+          const long chunk = (kChunks[c] != 0) ? kChunks[c] : len;
+          XMPScanner::LimitVectorSearch(0);
+          XMPScanner::SnipInfoVector bytes = scan_chunks(data, len, chunk);
+          XMPScanner::LimitVectorSearch(16);
+          XMPScanner::SnipInfoVector sse2 = scan_chunks(data, len, chunk);
+          XMPScanner::LimitVectorSearch(32);
+          XMPScanner::SnipInfoVector avx2 = scan_chunks(data, len, chunk);
+
+          int found = 0;
+          for (size_t i = 0; i < bytes.size(); ++i) {
+            if ((bytes[i].fState == XMPScanner::eValidPacketSnip) &&
+                (bytes[i].fOffset == lead + 4) &&
+                (bytes[i].fLength == (XMP_Int64)packet.size()) &&
+                (bytes[i].fCharForm == kForms[f])) {
+              ++found;
+            }
+          }
+          if ((found != 1) || !same_snips(bytes, sse2) ||
+              !same_snips(bytes, avx2)) {
+            ++failures;
+          }
+        }
+      }
+    }
+  }
+  BOOST_CHECK(failures == 0);
+}
+
+// Many packets in all the character forms, some of them read-only or with a
+// bytes attribute that is too small, scanned in buffers of many sizes. The
+// snips are found by index in a long list, the packets cross the buffer
+// boundaries and the packet machines are reused from one buffer to the next.
+static void test_many_packets()
+{
+  std::minstd_rand random(2);
+  std::string input;
+  XMPScanner::SnipInfoVector expected;
+
+  for (int i = 0; i < 300; ++i) {
+    const long start = input.size();
+    const long count = 4 + random() % 200;
+    for (long f = 0; f < count - 4; ++f) {
+      input += kFiller[random() % sizeof(kFiller)];
+    }
+    input += "    ";
+    expected.push_back(XMPScanner::SnipInfo(XMPScanner::eRawInputSnip,
+                                            start, count));
+
+    const bool bad = ((i % 7) == 3);
+    const char access = ((i % 3) == 1) ? 'r' : 'w';
+    std::string text = "<?xpacket begin='\1' id='W5M0MpCehiHzreSzNTczkc9d'";
+    text += bad ? " bytes='8'?>" : "?>";
+    text += "<x:xmpmeta xmlns:x='adobe:ns:meta/'/><?xpacket end='";
+    text += access;
+    text += "'?>";
+    const std::string packet = encode(text.c_str(), kForms[i % 5]);
+
+    XMPScanner::SnipInfo info(bad ? XMPScanner::eBadPacketSnip
+                                  : XMPScanner::eValidPacketSnip,
+                              input.size(), packet.size());
+    info.fAccess = access;
+    info.fCharForm = kForms[i % 5];
+    info.fBytesAttr = bad ? 8 : -1;
+    expected.push_back(info);
+    input += packet;
+  }
+  expected.push_back(XMPScanner::SnipInfo(XMPScanner::eRawInputSnip,
+                                          input.size(), 100));
+  input.append(100, ' ');
+
+  const long len = input.size();
+  static const long kChunks[] = { 1, 7, 64, 1000, 65536, 0, -1 };
+  for (size_t c = 0; c < sizeof(kChunks) / sizeof(kChunks[0]); ++c) {
+    XMPScanner scanner(len);
+    for (long pos = 0; pos < len;) {
+      long chunk = kChunks[c];
+      if (chunk == 0) {
+        chunk = len;
+      } else if (chunk < 0) {
+        chunk = 1 + random() % 2000;
+      }
+      chunk = std::min(chunk, len - pos);
+      scanner.Scan(input.data() + pos, pos, chunk);
+      pos += chunk;
+    }
+    BOOST_CHECK(scanner.StreamAllScanned());
+    BOOST_CHECK(scanner.GetSnipCount() == (long)expected.size());
+
+    XMPScanner::SnipInfoVector snips;
+    scanner.Report(snips);
+    BOOST_CHECK(same_snips(snips, expected));
+    int failures = 0;
+    for (size_t i = 0; i < std::min(snips.size(), expected.size()); ++i) {
+      if ((snips[i].fState != XMPScanner::eRawInputSnip) &&
+          ((snips[i].fAccess != expected[i].fAccess) ||
+           (snips[i].fBytesAttr != expected[i].fBytesAttr))) {
+        ++failures;
+      }
+    }
+    BOOST_CHECK(failures == 0);
+
+    // A seen range can't be scanned again.
+    bool rescanned = true;
+    try {
+      scanner.Scan(input.data() + 1000, 1000, 10);
+    } catch (XMPScanner::ScanError &) {
+      rescanned = false;
+    }
+    BOOST_CHECK(!rescanned);
+  }
+
+  // Buffers that each hold one packet, scanned out of order so the
+  // enclosing snip is not the last one. Half of them start right at their
+  // packet. The raw snips are not merged as in order, and a '<' at the end
+  // of a buffer stays a partial packet, but each packet is found.
+  std::vector<long> bounds(1, 0);
+  for (size_t i = 1; i < expected.size(); i += 2) {
+    const XMPScanner::SnipInfo &raw = expected[i - 1];
+    bounds.push_back(raw.fOffset +
+                     (((i % 4) == 1) ? raw.fLength : raw.fLength / 2));
+  }
+  bounds.push_back(len);
+  std::vector<size_t> order;
+  for (size_t b = 1; b + 1 < bounds.size(); b += 2) {
+    order.push_back(b);
+  }
+  for (size_t b = 0; b + 1 < bounds.size(); b += 2) {
+    order.insert(order.begin() + order.size() / 2, b);
+  }
+  XMPScanner scanner(len);
+  for (size_t o = 0; o < order.size(); ++o) {
+    const long pos = bounds[order[o]];
+    scanner.Scan(input.data() + pos, pos, bounds[order[o] + 1] - pos);
+  }
+  BOOST_CHECK(scanner.StreamAllScanned());
+
+  XMPScanner::SnipInfoVector snips;
+  XMPScanner::SnipInfoVector packets;
+  XMPScanner::SnipInfoVector expected_packets;
+  scanner.Report(snips);
+  for (size_t i = 0; i < snips.size(); ++i) {
+    if ((snips[i].fState == XMPScanner::eValidPacketSnip) ||
+        (snips[i].fState == XMPScanner::eBadPacketSnip)) {
+      packets.push_back(snips[i]);
+    }
+  }
+  for (size_t i = 1; i < expected.size(); i += 2) {
+    expected_packets.push_back(expected[i]);
+  }
+  BOOST_CHECK(same_snips(packets, expected_packets));
+}
+
+int test_main(int /*argc*/, char * /*argv*/ [])
+{
+  // Run the parallel path whatever the number of CPUs.
+  Scanner_SetParallelScanThreads(4);
+
+  BOOST_CHECK(xmp_init());
+
+  test_vector_search();
+  test_many_packets();
+
+  // Packets crossing each range boundary, each in turn the newest.
+  for (int newest = 1; newest <= 3; ++newest) {
+    std::vector<Packet> packets;
+    packets.push_back(Packet{ 1000, 10, true });
+    for (int b = 1; b <= 3; ++b) {
+      packets.push_back(Packet{ b * 16 * kMB - 100, (b == newest) ? 20 : b, true });
+    }
+    check_scan(packets, newest * 16 * kMB - 100);
+  }
+
+  // One packet per range.
+  for (int newest = 0; newest < 4; ++newest) {
+    std::vector<Packet> packets;
+    for (int r = 0; r < 4; ++r) {
+      packets.push_back(Packet{ r * 16 * kMB + 8 * kMB, (r == newest) ? 20 : r + 1, true });
+    }
+    check_scan(packets, newest * 16 * kMB + 8 * kMB);
+  }
+
+  // A header without its own trailer runs to the next trailer, the packet
+  // found spans ranges and hides the one it swallowed.
+  {
+    std::vector<Packet> packets;
+    packets.push_back(Packet{ 1000, 1, true });
+    packets.push_back(Packet{ 20 * kMB, 2, false });
+    packets.push_back(Packet{ 40 * kMB, 20, true });
+    check_scan(packets, 20 * kMB);
+  }
+  {
+    std::vector<Packet> packets;
+    packets.push_back(Packet{ 100, 2, false });
+    packets.push_back(Packet{ 32 * kMB - 20, 2, false });
+    packets.push_back(Packet{ 32 * kMB + 1000, 20, true });
+    packets.push_back(Packet{ 56 * kMB, 1, true });
+    check_scan(packets, 100);
+  }
+  {
+    std::vector<Packet> packets;
+    packets.push_back(Packet{ 8 * kMB, 1, true });
+    packets.push_back(Packet{ 32 * kMB - 20, 2, false });
+    packets.push_back(Packet{ 32 * kMB + 1000, 20, true });
+    packets.push_back(Packet{ 56 * kMB, 3, true });
+    check_scan(packets, 32 * kMB - 20);
+  }
+
+  // A header that is never closed is not a packet.
+  {
+    std::vector<Packet> packets;
+    packets.push_back(Packet{ 8 * kMB, 1, true });
+    packets.push_back(Packet{ 40 * kMB, 20, false });
+    check_scan(packets, 8 * kMB);
+  }
+
+  // The PostScript handler looks for the last packet from the end of the
+  // file, in a window that doubles until a packet is found. Reading the DSC
+  // comments already reads the whole file once.
+  {
+    static const long kEPSSize = 20 * kMB;
+    CountedData counted;
+    std::vector<long> offsets;
+
+    // In the first 1 MB window.
+    offsets.push_back(1000);
+    offsets.push_back(kEPSSize - 100 * 1024);
+    make_eps(counted, kEPSSize, offsets);
+    BOOST_CHECK(find_eps_packet(counted) == kEPSSize - 100 * 1024);
+    BOOST_CHECK(counted.bytes_read < kEPSSize + 2 * kMB);
+
+    // Across the start of the first window, and in the third one.
+    offsets[1] = kEPSSize - kMB - 100;
+    make_eps(counted, kEPSSize, offsets);
+    BOOST_CHECK(find_eps_packet(counted) == kEPSSize - kMB - 100);
+    BOOST_CHECK(counted.bytes_read < kEPSSize + 3 * kMB);
+    offsets[1] = kEPSSize - 3 * kMB;
+    make_eps(counted, kEPSSize, offsets);
+    BOOST_CHECK(find_eps_packet(counted) == kEPSSize - 3 * kMB);
+    BOOST_CHECK(counted.bytes_read < kEPSSize + 5 * kMB);
+
+    // Only near the start, the windows read the file once.
+    offsets.pop_back();
+    make_eps(counted, kEPSSize, offsets);
+    BOOST_CHECK(find_eps_packet(counted) == 1000);
+    BOOST_CHECK(counted.bytes_read < 2 * kEPSSize + kMB);
+
+    // No packet.
+    offsets.clear();
+    make_eps(counted, kEPSSize, offsets);
+    BOOST_CHECK(find_eps_packet(counted) == -1);
+    BOOST_CHECK(counted.bytes_read < 2 * kEPSSize + kMB);
+  }
+
+  unlink(kScanFile);
+  xmp_terminate();
+
+  BOOST_CHECK(!g_lt->check_leaks());
+  BOOST_CHECK(!g_lt->check_errors());
+  return 0;
+}
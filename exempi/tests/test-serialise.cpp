@@ -44,6 +44,7 @@
 
 #include "utils.h"
 #include "xmpconsts.h"
+#include "xmperrors.h"
 #include "xmp.h"
 
 using boost::unit_test::test_suite;
@@ -88,6 +89,67 @@ int test_main(int argc, char *argv[])
   // find a way to compare that.
   //	BOOST_CHECK_EQUAL(b1, b2);
 
+  XmpPtr xmp2 = xmp_new_empty();
+  BOOST_CHECK(xmp_parse_with_options(
+    xmp2, buffer, len, XMP_PARSE_REQUIREXMPMETA | XMP_PARSE_STREAMING));
+  BOOST_CHECK(xmp_get_error() == 0);
+  BOOST_CHECK(xmp_serialize_and_format(
+    xmp2, output, XMP_SERIAL_OMITPACKETWRAPPER, 0, "\n", " ", 0));
+  BOOST_CHECK(b2 == xmp_string_cstr(output));
+  BOOST_CHECK(xmp_free(xmp2));
+
+  // The parser is recycled, a failed parse must not affect the next one.
+  const char *broken = "<x:xmpmeta xmlns:x='adobe:ns:meta/'><rdf:RDF";
+  XmpPtr xmp4 = xmp_new_empty();
+  BOOST_CHECK(!xmp_parse(xmp4, broken, strlen(broken)));
+  BOOST_CHECK(xmp_get_error() == XMPErr_BadXML);
+  BOOST_CHECK(xmp_parse(xmp4, buffer, len));
+  BOOST_CHECK(xmp_serialize_and_format(
+    xmp4, output, XMP_SERIAL_OMITPACKETWRAPPER, 0, "\n", " ", 0));
+  BOOST_CHECK(b2 == xmp_string_cstr(output));
+  BOOST_CHECK(xmp_free(xmp4));
+
+  // Only the dc and tiff schemas, the same with and without streaming.
+  const char *namespaces[] = { NS_DC, NS_TIFF };
+  std::string b3;
+  for (uint32_t streaming = 0; streaming <= XMP_PARSE_STREAMING;
+       streaming += XMP_PARSE_STREAMING) {
+    XmpPtr xmp3 = xmp_new_empty();
+    BOOST_CHECK(xmp_set_parse_namespaces(xmp3, namespaces, 2));
+    BOOST_CHECK(xmp_parse_with_options(xmp3, buffer, len, streaming));
+    BOOST_CHECK(xmp_get_error() == 0);
+    BOOST_CHECK(xmp_has_property(xmp3, NS_TIFF, "Make"));
+    BOOST_CHECK(xmp_has_property(xmp3, NS_DC, "rights"));
+    BOOST_CHECK(!xmp_has_property(xmp3, NS_EXIF, "ExifVersion"));
+    BOOST_CHECK(xmp_serialize_and_format(
+      xmp3, output, XMP_SERIAL_OMITPACKETWRAPPER, 0, "\n", " ", 0));
+    if (streaming == 0) {
+      b3 = xmp_string_cstr(output);
+    } else {
+      BOOST_CHECK(b3 == xmp_string_cstr(output));
+    }
+    BOOST_CHECK(xmp_free(xmp3));
+  }
+  BOOST_CHECK(b3.find("exif:") == std::string::npos);
+
+  // A batch with a bad packet in the middle.
+  const char *batch[] = { buffer, broken, buffer, buffer };
+  size_t batch_lens[] = { len, strlen(broken), len, len };
+  XmpPtr batch_xmps[4];
+  int batch_errors[4];
+  BOOST_CHECK(!xmp_parse_batch(batch, batch_lens, 4, XMP_PARSE_REQUIREXMPMETA,
+                               batch_xmps, batch_errors));
+  BOOST_CHECK(xmp_get_error() == XMPErr_BadXML);
+  BOOST_CHECK(batch_xmps[1] == NULL);
+  BOOST_CHECK(batch_errors[1] == XMPErr_BadXML);
+  for (int i = 0; i < 4; i += (i == 0 ? 2 : 1)) {
+    BOOST_CHECK(batch_errors[i] == 0);
+    BOOST_CHECK(xmp_serialize_and_format(
+      batch_xmps[i], output, XMP_SERIAL_OMITPACKETWRAPPER, 0, "\n", " ", 0));
+    BOOST_CHECK(b2 == xmp_string_cstr(output));
+    BOOST_CHECK(xmp_free(batch_xmps[i]));
+  }
+
   xmp_string_free(output);
   BOOST_CHECK(xmp_free(xmp));
 
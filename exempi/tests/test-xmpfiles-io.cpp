@@ -0,0 +1,452 @@
+/*
+ * exempi - test-xmpfiles-io.cpp
+ *
+ * Copyright (C) 2026 The exempi contributors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1 Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *
+ * 2 Redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the
+ * distribution.
+ *
+ * 3 Neither the name of the Authors, nor the names of its
+ * contributors may be used to endorse or promote products derived
+ * from this software wit hout specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <string>
+
+#include <boost/test/minimal.hpp>
+
+#include "utils.h"
+#include "xmp.h"
+#include "xmpconsts.h"
+
+#include "XMPFiles/source/XMPFiles_Impl.hpp"
+#include "source/XMPFiles_IO.hpp"
+#include "source/XIO.hpp"
+
+using boost::unit_test::test_suite;
+
+// A byte pattern that does not repeat with the cache page size.
+static unsigned char pattern_byte(long offset)
+{
+  return (unsigned char)((offset * 131) + (offset / 251));
+}
+
+// Read count bytes at offset, they must match the pattern up to EOF.
+static bool check_read(XMPFiles_IO *io, long offset, long count, long fileSize)
+{
+  unsigned char buffer[8192];
+  io->Seek(offset, kXMP_SeekFromStart);
+  long expected = (offset + count > fileSize) ? (fileSize - offset) : count;
+  if ((long)io->Read(buffer, (XMP_Uns32)count) != expected) {
+    return false;
+  }
+  for (long i = 0; i < expected; ++i) {
+    if (buffer[i] != pattern_byte(offset + i)) {
+      return false;
+    }
+  }
+  return io->Offset() == offset + expected;
+}
+
+// Small reads through the block read cache, across page boundaries, up to
+// EOF, and back into pages that are still cached or were recycled.
+static void test_read_cache()
+{
+  const long kFileSize = 40000;
+  const long kPageSize = 4096;
+
+  FILE *fp = fopen("readcache.dat", "wb");
+  BOOST_CHECK(fp != NULL);
+  for (long i = 0; i < kFileSize; ++i) {
+    fputc(pattern_byte(i), fp);
+  }
+  fclose(fp);
+
+  XMPFiles_IO *io =
+    XMPFiles_IO::New_XMPFiles_IO("readcache.dat", Host_IO::openReadOnly);
+  BOOST_CHECK(io != NULL);
+  io->SetReadCache(kPageSize, 3);
+
+  BOOST_CHECK(check_read(io, kPageSize - 6, 12, kFileSize));
+  BOOST_CHECK(check_read(io, 2 * kPageSize - 100, kPageSize - 1, kFileSize));
+  BOOST_CHECK(check_read(io, kPageSize - 2, 4, kFileSize));
+  BOOST_CHECK(check_read(io, 0, 10, kFileSize));
+  BOOST_CHECK(check_read(io, kFileSize - 10, 10, kFileSize));
+  BOOST_CHECK(check_read(io, kFileSize - 5, 100, kFileSize));
+  BOOST_CHECK(check_read(io, kPageSize - 6, 12, kFileSize));
+  BOOST_CHECK(check_read(io, 3 * kPageSize - 10, kPageSize, kFileSize));
+
+  // Runs of sequential small reads, like a handler parsing fields, with
+  // seeks back and forth between them.
+  unsigned long seed = 12345;
+  bool ok = true;
+  for (int run = 0; run < 200 && ok; ++run) {
+    seed = seed * 1103515245 + 12345;
+    long offset = (long)((seed >> 8) % kFileSize);
+    io->Seek(offset, kXMP_SeekFromStart);
+    for (int field = 0; field < 20 && ok; ++field) {
+      seed = seed * 1103515245 + 12345;
+      long count = 1 + (long)((seed >> 8) % 300);
+      ok = check_read(io, offset, count, kFileSize);
+      offset = io->Offset();
+    }
+  }
+  BOOST_CHECK(ok);
+
+  io->SetReadCache(0, 0);
+  BOOST_CHECK(check_read(io, kPageSize - 6, 12, kFileSize));
+
+  io->Close();
+  delete io;
+  unlink("readcache.dat");
+}
+
+static std::string read_file(const std::string &path)
+{
+  std::string data;
+  FILE *fp = fopen(path.c_str(), "rb");
+  if (fp == NULL) {
+    return data;
+  }
+  char buf[4096];
+  size_t n;
+  while ((n = fread(buf, 1, sizeof(buf), fp)) > 0) {
+    data.append(buf, n);
+  }
+  fclose(fp);
+  return data;
+}
+
+// XIO::Copy and XIO::Move between two local files go through the host copy.
+// The destination must not keep cached pages of what the copy replaced.
+static void test_host_copy()
+{
+  const long kSourceSize = 200000;
+  std::string source;
+  for (long i = 0; i < kSourceSize; ++i) {
+    source += pattern_byte(i);
+  }
+  FILE *fp = fopen("hostcopy.src", "wb");
+  BOOST_CHECK(fp != NULL);
+  fwrite(source.data(), 1, source.size(), fp);
+  fclose(fp);
+  fp = fopen("hostcopy.dst", "wb");
+  BOOST_CHECK(fp != NULL);
+  fclose(fp);
+
+  XMPFiles_IO *src =
+    XMPFiles_IO::New_XMPFiles_IO("hostcopy.src", Host_IO::openReadWrite);
+  XMPFiles_IO *dst =
+    XMPFiles_IO::New_XMPFiles_IO("hostcopy.dst", Host_IO::openReadWrite);
+  BOOST_CHECK(src != NULL && dst != NULL);
+
+  src->Seek(100, kXMP_SeekFromStart);
+  src->Write("pending", 7);
+  source.replace(100, 7, "pending");
+
+  std::string zeros(5000, '\0');
+  char buffer[16];
+  dst->Write(zeros.data(), (XMP_Uns32)zeros.size());
+  dst->Seek(4090, kXMP_SeekFromStart);
+  dst->Read(buffer, sizeof(buffer));
+
+  src->Rewind();
+  dst->Rewind();
+  XIO::Copy(src, dst, 150000);
+  BOOST_CHECK(src->Offset() == 150000);
+  BOOST_CHECK(dst->Offset() == 150000);
+  BOOST_CHECK(dst->Length() == 150000);
+  std::string expected = source.substr(0, 150000);
+
+  dst->Seek(4090, kXMP_SeekFromStart);
+  BOOST_CHECK(dst->Read(buffer, sizeof(buffer)) == sizeof(buffer));
+  BOOST_CHECK(memcmp(buffer, expected.data() + 4090, sizeof(buffer)) == 0);
+
+  // Between different files Move also uses the host copy, this one extends
+  // the destination.
+  XIO::Move(src, 1000, dst, 140000, 20000);
+  expected.replace(140000, 10000, source.substr(1000, 20000));
+  BOOST_CHECK(dst->Length() == 160000);
+
+  // Within one file it goes through the buffer.
+  XIO::Move(dst, 0, dst, 10, 5000);
+  expected.replace(10, 5000, expected.substr(0, 5000));
+
+  src->Close();
+  dst->Close();
+  delete src;
+  delete dst;
+
+  BOOST_CHECK(read_file("hostcopy.dst") == expected);
+  BOOST_CHECK(read_file("hostcopy.src") == source);
+  unlink("hostcopy.src");
+  unlink("hostcopy.dst");
+}
+
+// Stand-ins for Host_IO::CloneFile, with and without reflink support.
+static int g_clone_calls = 0;
+
+static bool copy_clone(Host_IO::FileRef src, Host_IO::FileRef dst)
+{
+  ++g_clone_calls;
+  if (ftruncate(dst, 0) != 0) {
+    return false;
+  }
+  char buf[4096];
+  off_t offset = 0;
+  ssize_t n;
+  while ((n = pread(src, buf, sizeof(buf), offset)) > 0) {
+    if (pwrite(dst, buf, n, offset) != n) {
+      return false;
+    }
+    offset += n;
+  }
+  return n == 0;
+}
+
+static bool no_clone(Host_IO::FileRef, Host_IO::FileRef)
+{
+  ++g_clone_calls;
+  return false;
+}
+
+// A safe MPEG-4 update clones the file into the temp when the file system
+// can, and copies it otherwise. Both give the same file.
+static void test_clone_temp()
+{
+  std::string mov = g_src_testdir + "../../samples/testfiles/BlueSquare.mov";
+  std::string updated[2];
+
+  for (int clone = 0; clone < 2; ++clone) {
+    XMPFiles_IO::SetCloneFileProc(clone ? copy_clone : no_clone);
+    g_clone_calls = 0;
+
+    BOOST_CHECK(copy_file(mov, "clone.mov"));
+    BOOST_CHECK(chmod("clone.mov", S_IRUSR | S_IWUSR) == 0);
+    XmpFilePtr f = xmp_files_open_new("clone.mov", XMP_OPEN_FORUPDATE);
+    BOOST_CHECK(f != NULL);
+    XmpPtr xmp = xmp_files_get_new_xmp(f);
+    BOOST_CHECK(xmp != NULL);
+    BOOST_CHECK(xmp_set_property(xmp, NS_XAP, "Label", "cloned", 0));
+    BOOST_CHECK(xmp_files_put_xmp(f, xmp));
+    BOOST_CHECK(xmp_free(xmp));
+    BOOST_CHECK(xmp_files_close(f, XMP_CLOSE_SAFEUPDATE));
+    BOOST_CHECK(xmp_files_free(f));
+    BOOST_CHECK(g_clone_calls == 1);
+
+    f = xmp_files_open_new("clone.mov", XMP_OPEN_READ);
+    BOOST_CHECK(f != NULL);
+    xmp = xmp_files_get_new_xmp(f);
+    BOOST_CHECK(xmp != NULL);
+    XmpStringPtr the_prop = xmp_string_new();
+    BOOST_CHECK(xmp_get_property(xmp, NS_XAP, "Label", the_prop, NULL));
+    BOOST_CHECK(strcmp("cloned", xmp_string_cstr(the_prop)) == 0);
+    xmp_string_free(the_prop);
+    BOOST_CHECK(xmp_free(xmp));
+    BOOST_CHECK(xmp_files_free(f));
+
+    updated[clone] = read_file("clone.mov");
+  }
+  XMPFiles_IO::SetCloneFileProc(0);
+
+  BOOST_CHECK(!updated[0].empty());
+  BOOST_CHECK(updated[0] == updated[1]);
+  BOOST_CHECK(updated[0] != read_file(mov));
+  unlink("clone.mov");
+}
+
+// Small writes through the write combining buffer, mixed with seeks, reads,
+// large writes, truncation and growth, checked against a string model.
+static void test_write_buffer()
+{
+  fclose(fopen("writebuf.dat", "wb"));
+  XMPFiles_IO *io =
+    XMPFiles_IO::New_XMPFiles_IO("writebuf.dat", Host_IO::openReadWrite);
+  BOOST_CHECK(io != NULL);
+  io->SetWriteBuffer(256);
+  io->SetReadCache(128, 4);
+
+  std::string model;
+  long offset = 0;
+  char data[600];
+  char buffer[200];
+  unsigned long seed = 4321;
+  bool ok = true;
+
+  for (int step = 0; step < 5000 && ok; ++step) {
+    seed = seed * 1103515245 + 12345;
+    unsigned long choice = (seed >> 8) % 100;
+    seed = seed * 1103515245 + 12345;
+    unsigned long value = seed >> 8;
+
+    if (choice < 45) {
+      long count = 1 + (long)(value % 100);
+      if (choice < 3) {
+        count = 300 + (long)(value % 300);  // Bigger than the buffer.
+      }
+      for (long i = 0; i < count; ++i) {
+        data[i] = (char)(step + i);
+      }
+      io->Write(data, (XMP_Uns32)count);
+      if (offset + count > (long)model.size()) {
+        model.resize(offset + count);
+      }
+      model.replace(offset, count, data, count);
+      offset += count;
+    } else if (choice < 65) {
+      offset = (long)(value % (model.size() + 1));
+      io->Seek(offset, kXMP_SeekFromStart);
+    } else if (choice < 70) {
+      io->Seek(0, kXMP_SeekFromCurrent);
+    } else if (choice < 95) {
+      long count = 1 + (long)(value % sizeof(buffer));
+      long expected = std::min(count, (long)model.size() - offset);
+      ok = (long)io->Read(buffer, (XMP_Uns32)count) == expected &&
+           model.compare(offset, expected, buffer, expected) == 0;
+      offset += expected;
+    } else if (choice < 97) {
+      long length = (long)(value % (model.size() + 1));
+      io->Truncate(length);
+      model.resize(length);
+      offset = std::min(offset, length);
+    } else {
+      offset = (long)model.size() + (long)(value % 50);
+      io->Seek(offset, kXMP_SeekFromStart);
+      model.resize(offset);
+    }
+
+    ok = ok && io->Offset() == offset && io->Length() == (long)model.size();
+  }
+  BOOST_CHECK(ok);
+
+  io->FlushWrites();
+  BOOST_CHECK(read_file("writebuf.dat") == model);
+  io->Close();
+  delete io;
+  BOOST_CHECK(read_file("writebuf.dat") == model);
+  unlink("writebuf.dat");
+}
+
+// With an extension that names no format, the normal handlers are searched
+// and only those whose file signature matches are asked to check the file.
+static void test_signature_filter()
+{
+  static const struct {
+    const char *name;
+    XmpFileType format;
+  } kSamples[] = {
+    { "BlueSquare.avi", XMP_FT_AVI },
+    { "BlueSquare.eps", XMP_FT_EPS },
+    { "BlueSquare.gif", XMP_FT_UNKNOWN },  // GIF87a, the handler wants GIF89a.
+    { "BlueSquare.indd", XMP_FT_INDESIGN },
+    { "BlueSquare.jpg", XMP_FT_JPEG },
+    { "BlueSquare.mov", XMP_FT_MOV },      // No signature, always checked.
+    { "BlueSquare.mp3", XMP_FT_MP3 },
+    { "BlueSquare.png", XMP_FT_PNG },
+    { "BlueSquare.psd", XMP_FT_PHOTOSHOP },
+    { "BlueSquare.tif", XMP_FT_TIFF },
+    { "BlueSquare.wav", XMP_FT_WAV },
+    { "BlueSquare.webp", XMP_FT_WEBP },
+    { NULL, XMP_FT_UNKNOWN }
+  };
+
+  for (int i = 0; kSamples[i].name != NULL; ++i) {
+    std::string sample =
+      g_src_testdir + "../../samples/testfiles/" + kSamples[i].name;
+    BOOST_CHECK(copy_file(sample, "signature.dat"));
+    BOOST_CHECK(xmp_files_check_file_format("signature.dat") ==
+                kSamples[i].format);
+
+    XmpFilePtr f = xmp_files_open_new("signature.dat", XMP_OPEN_READ);
+    BOOST_CHECK(f != NULL);
+    XmpPtr xmp = xmp_files_get_new_xmp(f);
+    BOOST_CHECK(xmp != NULL);
+    BOOST_CHECK(xmp_free(xmp));
+    BOOST_CHECK(xmp_files_free(f));
+  }
+
+  // Shorter than some of the signatures.
+  FILE *fp = fopen("signature.dat", "wb");
+  BOOST_CHECK(fp != NULL);
+  fputs("GIF", fp);
+  fclose(fp);
+  BOOST_CHECK(xmp_files_check_file_format("signature.dat") == XMP_FT_UNKNOWN);
+
+  unlink("signature.dat");
+}
+
+// In a memory mapped read-only session, getting only the XMP object leaves
+// the packet in the mapping. The raw packet is only copied out when asked for.
+static void test_borrowed_packet()
+{
+  XmpFilePtr f = xmp_files_open_new(
+    g_testfile.c_str(), (XmpOpenFileOptions)(XMP_OPEN_READ | XMP_OPEN_USEMMAP));
+  BOOST_CHECK(f != NULL);
+  XMPFiles *impl = reinterpret_cast<XMPFiles *>(
+    reinterpret_cast<SXMPFiles *>(f)->GetInternalRef());
+
+  XmpPtr xmp = xmp_new_empty();
+  BOOST_CHECK(xmp_files_get_xmp(f, xmp));
+  BOOST_CHECK(impl->handler->xmpPacket.empty());
+  BOOST_CHECK(impl->handler->PacketLen() == 4782);
+
+  XmpStringPtr packet = xmp_string_new();
+  BOOST_CHECK(xmp_files_get_xmp_xmpstring(f, packet, NULL));
+  BOOST_CHECK(xmp_string_len(packet) == 4782);
+  BOOST_CHECK(impl->handler->xmpPacket.size() == 4782);
+
+  xmp_string_free(packet);
+  BOOST_CHECK(xmp_free(xmp));
+  BOOST_CHECK(xmp_files_free(f));
+}
+
+// Checks of the XMPFiles I/O internals behind the C API.
+int test_main(int argc, char *argv[])
+{
+  prepare_test(argc, argv, "../../samples/testfiles/BlueSquare.jpg");
+
+  BOOST_CHECK(xmp_init());
+
+  test_signature_filter();
+  test_read_cache();
+  test_host_copy();
+  test_clone_temp();
+  test_write_buffer();
+  test_borrowed_packet();
+
+  xmp_terminate();
+
+  BOOST_CHECK(!g_lt->check_leaks());
+  BOOST_CHECK(!g_lt->check_errors());
+  return 0;
+}
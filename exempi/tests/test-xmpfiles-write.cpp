@@ -38,6 +38,7 @@
 #include <stdio.h>
 #include <string.h>
 #include <sys/stat.h>
+#include <unistd.h>
 
 #include <string>
 
@@ -49,6 +50,39 @@
 
 using boost::unit_test::test_suite;
 
+// Client I/O over a std::string.
+static int64_t string_read(void *opaque, uint64_t offset, void *buffer,
+                           uint32_t count)
+{
+  std::string *data = static_cast<std::string *>(opaque);
+  if (offset >= data->size()) {
+    return 0;
+  }
+  return data->copy(static_cast<char *>(buffer), count, offset);
+}
+
+static int string_write(void *opaque, uint64_t offset, const void *buffer,
+                        uint32_t count)
+{
+  std::string *data = static_cast<std::string *>(opaque);
+  if (offset + count > data->size()) {
+    data->resize(offset + count);
+  }
+  data->replace(offset, count, static_cast<const char *>(buffer), count);
+  return 0;
+}
+
+static int64_t string_length(void *opaque)
+{
+  return static_cast<std::string *>(opaque)->size();
+}
+
+static int string_truncate(void *opaque, uint64_t length)
+{
+  static_cast<std::string *>(opaque)->resize(length);
+  return 0;
+}
+
 // void test_xmpfiles_write()
 int test_main(int argc, char *argv[])
 {
@@ -110,6 +144,86 @@ int test_main(int argc, char *argv[])
   BOOST_CHECK(xmp_files_close(f, XMP_CLOSE_NOOPTION));
   BOOST_CHECK(xmp_files_free(f));
 
+  // Update through client I/O callbacks.
+  {
+    std::string data;
+    FILE *fp = fopen(g_testfile.c_str(), "rb");
+    BOOST_CHECK(fp != NULL);
+    char buf[4096];
+    size_t n;
+    while ((n = fread(buf, 1, sizeof(buf), fp)) > 0) {
+      data.append(buf, n);
+    }
+    fclose(fp);
+
+    XmpIOCallbacks callbacks = { string_read, string_write, string_length,
+                                 string_truncate };
+    f = xmp_files_open_io(&callbacks, &data, XMP_OPEN_FORUPDATE);
+    BOOST_CHECK(f != NULL);
+
+    xmp = xmp_files_get_new_xmp(f);
+    BOOST_CHECK(xmp != NULL);
+    BOOST_CHECK(xmp_set_property(xmp, NS_PHOTOSHOP, "ICCProfile", "bar", 0));
+    BOOST_CHECK(xmp_files_put_xmp(f, xmp));
+    BOOST_CHECK(xmp_free(xmp));
+    BOOST_CHECK(xmp_files_close(f, XMP_CLOSE_SAFEUPDATE));
+    BOOST_CHECK(xmp_files_free(f));
+
+    f = xmp_files_open_memory(data.data(), data.size(), XMP_OPEN_READ);
+    BOOST_CHECK(f != NULL);
+    xmp = xmp_files_get_new_xmp(f);
+    BOOST_CHECK(xmp != NULL);
+
+    the_prop = xmp_string_new();
+    BOOST_CHECK(
+      xmp_get_property(xmp, NS_PHOTOSHOP, "ICCProfile", the_prop, NULL));
+    BOOST_CHECK(strcmp("bar", xmp_string_cstr(the_prop)) == 0);
+    xmp_string_free(the_prop);
+
+    BOOST_CHECK(xmp_free(xmp));
+    BOOST_CHECK(xmp_files_free(f));
+  }
+
+  {
+    BOOST_CHECK(copy_file(g_testfile, "cache.jpg"));
+    unlink("formats.cache");
+
+    BOOST_CHECK(xmp_files_set_format_cache(16, "formats.cache"));
+    BOOST_CHECK(xmp_files_check_file_format("cache.jpg") == XMP_FT_JPEG);
+    BOOST_CHECK(xmp_files_check_file_format("cache.jpg") == XMP_FT_JPEG);
+
+    // A changed file is detected again.
+    FILE *fp = fopen("cache.jpg", "wb");
+    BOOST_CHECK(fp != NULL);
+    fputs("not an image", fp);
+    fclose(fp);
+    BOOST_CHECK(xmp_files_check_file_format("cache.jpg") == XMP_FT_UNKNOWN);
+
+    // The MP3 handler goes by the extension, a renamed file is not the same.
+    BOOST_CHECK(rename("cache.jpg", "cache.mp3") == 0);
+    BOOST_CHECK(xmp_files_check_file_format("cache.mp3") == XMP_FT_MP3);
+    BOOST_CHECK(xmp_files_check_file_format("cache.mp3") == XMP_FT_MP3);
+    BOOST_CHECK(rename("cache.mp3", "cache.dat") == 0);
+    BOOST_CHECK(xmp_files_check_file_format("cache.dat") == XMP_FT_UNKNOWN);
+    unlink("cache.dat");
+
+    BOOST_CHECK(xmp_files_check_file_format("test.jpg") == XMP_FT_JPEG);
+    BOOST_CHECK(xmp_files_set_format_cache(0, NULL));
+    BOOST_CHECK(access("formats.cache", R_OK) == 0);
+
+    BOOST_CHECK(xmp_files_set_format_cache(16, "formats.cache"));
+    BOOST_CHECK(xmp_files_check_file_format("test.jpg") == XMP_FT_JPEG);
+    BOOST_CHECK(xmp_files_set_format_cache(0, NULL));
+
+    // A snapshot that can't be written does not keep the old settings.
+    BOOST_CHECK(xmp_files_set_format_cache(16, "no-such-dir/formats.cache"));
+    BOOST_CHECK(xmp_files_check_file_format("test.jpg") == XMP_FT_JPEG);
+    BOOST_CHECK(xmp_files_set_format_cache(16, "formats.cache"));
+    BOOST_CHECK(access("no-such-dir", F_OK) != 0);
+    BOOST_CHECK(xmp_files_set_format_cache(0, NULL));
+  }
+
+
   //	unlink("test.jpg");
   xmp_terminate();
 
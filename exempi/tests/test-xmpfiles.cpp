@@ -46,6 +46,7 @@
 #include "utils.h"
 #include "xmp.h"
 #include "xmpconsts.h"
+#include "xmperrors.h"
 
 using boost::unit_test::test_suite;
 
@@ -105,6 +106,98 @@ int test_main(int argc, char* argv[])
   BOOST_CHECK(strcmp("sRGB IEC61966-2.1", xmp_string_cstr(the_prop)) == 0);
 
   xmp_string_free(the_prop);
+
+  // Memory mapped read-only access must give the same result.
+  {
+    XmpFilePtr fm = xmp_files_open_new(
+      g_testfile.c_str(), (XmpOpenFileOptions)(XMP_OPEN_READ | XMP_OPEN_USEMMAP));
+    BOOST_CHECK(fm != NULL);
+
+    XmpPtr xmpm = xmp_new_empty();
+    BOOST_CHECK(xmp_files_get_xmp(fm, xmpm));
+
+    XmpStringPtr expected = xmp_string_new();
+    XmpStringPtr mapped = xmp_string_new();
+    BOOST_CHECK(xmp_serialize(xmp, expected, XMP_SERIAL_OMITPACKETWRAPPER, 0));
+    BOOST_CHECK(xmp_serialize(xmpm, mapped, XMP_SERIAL_OMITPACKETWRAPPER, 0));
+    BOOST_CHECK(strcmp(xmp_string_cstr(expected), xmp_string_cstr(mapped)) == 0);
+
+    XmpStringPtr packet = xmp_string_new();
+    XmpPacketInfo packet_info;
+    BOOST_CHECK(xmp_files_get_xmp_xmpstring(fm, packet, &packet_info));
+    BOOST_CHECK(packet_info.offset == 2189);
+    BOOST_CHECK(packet_info.length == 4782);
+    BOOST_CHECK(packet_info.padSize == 2049);
+    BOOST_CHECK(xmp_string_len(packet) == 4782);
+    BOOST_CHECK(strncmp(xmp_string_cstr(packet), "<?xpacket begin=", 16) == 0);
+    xmp_string_free(packet);
+
+    xmp_string_free(mapped);
+    xmp_string_free(expected);
+    BOOST_CHECK(xmp_free(xmpm));
+    BOOST_CHECK(xmp_files_free(fm));
+  }
+
+  // Same again from a memory buffer.
+  {
+    std::string data;
+    FILE *fp = fopen(g_testfile.c_str(), "rb");
+    BOOST_CHECK(fp != NULL);
+    char buf[4096];
+    size_t n;
+    while ((n = fread(buf, 1, sizeof(buf), fp)) > 0) {
+      data.append(buf, n);
+    }
+    fclose(fp);
+
+    BOOST_CHECK(xmp_files_open_memory(data.data(), data.size(),
+                                      XMP_OPEN_FORUPDATE) == NULL);
+    BOOST_CHECK(xmp_get_error() == XMPErr_BadParam);
+
+    XmpFilePtr fb = xmp_files_open_memory(data.data(), data.size(),
+                                          XMP_OPEN_READ);
+    BOOST_CHECK(fb != NULL);
+
+    XmpFileType buffer_format;
+    BOOST_CHECK(xmp_files_get_file_info(fb, NULL, NULL, &buffer_format, NULL));
+    BOOST_CHECK(buffer_format == XMP_FT_JPEG);
+
+    XmpPtr xmpb = xmp_new_empty();
+    BOOST_CHECK(xmp_files_get_xmp(fb, xmpb));
+
+    XmpStringPtr expected = xmp_string_new();
+    XmpStringPtr buffered = xmp_string_new();
+    BOOST_CHECK(xmp_serialize(xmp, expected, XMP_SERIAL_OMITPACKETWRAPPER, 0));
+    BOOST_CHECK(xmp_serialize(xmpb, buffered, XMP_SERIAL_OMITPACKETWRAPPER, 0));
+    BOOST_CHECK(strcmp(xmp_string_cstr(expected), xmp_string_cstr(buffered)) == 0);
+
+    xmp_string_free(buffered);
+    xmp_string_free(expected);
+    BOOST_CHECK(xmp_free(xmpb));
+    BOOST_CHECK(xmp_files_free(fb));
+  }
+
+  // Only the photoshop schema from the file, read-only.
+  {
+    const char *namespaces[] = { NS_PHOTOSHOP };
+    XmpFilePtr fs = xmp_files_new();
+    BOOST_CHECK(xmp_files_set_parse_namespaces(fs, namespaces, 1));
+    BOOST_CHECK(!xmp_files_open(fs, g_testfile.c_str(), XMP_OPEN_FORUPDATE));
+    BOOST_CHECK(xmp_get_error() == XMPErr_BadParam);
+    BOOST_CHECK(xmp_files_open(fs, g_testfile.c_str(), XMP_OPEN_READ));
+
+    XmpPtr xmps = xmp_new_empty();
+    BOOST_CHECK(xmp_files_get_xmp(fs, xmps));
+    BOOST_CHECK(xmp_has_property(xmps, NS_PHOTOSHOP, "ICCProfile"));
+    // Native metadata still adds to other schemas, xmpMM only comes from the XMP.
+    const char *ns_xmp_mm = "http://ns.adobe.com/xap/1.0/mm/";
+    BOOST_CHECK(xmp_has_property(xmp, ns_xmp_mm, "DocumentID"));
+    BOOST_CHECK(!xmp_has_property(xmps, ns_xmp_mm, "DocumentID"));
+
+    BOOST_CHECK(xmp_free(xmps));
+    BOOST_CHECK(xmp_files_free(fs));
+  }
+
   BOOST_CHECK(xmp_free(xmp));
 
   BOOST_CHECK(xmp_files_free(f));
@@ -49,6 +49,66 @@
 
 using boost::unit_test::test_suite;
 
+static const char *kNS_DM = "http://ns.adobe.com/xmp/1.0/DynamicMedia/";
+
+#define PACKET(props)                                                   \
+  "<x:xmpmeta xmlns:x='adobe:ns:meta/'>"                                \
+  "<rdf:RDF xmlns:rdf='http://www.w3.org/1999/02/22-rdf-syntax-ns#'>"   \
+  "<rdf:Description rdf:about=''"                                       \
+  " xmlns:dc='http://purl.org/dc/elements/1.1/'"                        \
+  " xmlns:photoshop='http://ns.adobe.com/photoshop/1.0/'"               \
+  " xmlns:xmpDM='http://ns.adobe.com/xmp/1.0/DynamicMedia/'>"           \
+  props "</rdf:Description></rdf:RDF></x:xmpmeta>"
+
+static XmpPtr parse_packet(const char *packet)
+{
+  XmpPtr xmp = xmp_new_empty();
+  BOOST_CHECK(xmp_parse(xmp, packet, strlen(packet)));
+  return xmp;
+}
+
+// The post-parse fix-ups: alias moves and the xmpDM:copyright migration.
+static void test_touch_up()
+{
+  XmpStringPtr value = xmp_string_new();
+
+  // An alias is moved to its actual property, other names stay.
+  XmpPtr xmp = parse_packet(PACKET("<photoshop:Author>Jane Doe</photoshop:Author>"
+                                   "<photoshop:City>Paris</photoshop:City>"));
+  BOOST_CHECK(xmp_get_array_item(xmp, NS_DC, "creator", 1, value, NULL));
+  BOOST_CHECK(strcmp(xmp_string_cstr(value), "Jane Doe") == 0);
+  BOOST_CHECK(xmp_get_property(xmp, NS_PHOTOSHOP, "Author", value, NULL));
+  BOOST_CHECK(strcmp(xmp_string_cstr(value), "Jane Doe") == 0);
+  BOOST_CHECK(xmp_get_property(xmp, NS_PHOTOSHOP, "City", value, NULL));
+  BOOST_CHECK(strcmp(xmp_string_cstr(value), "Paris") == 0);
+  BOOST_CHECK(xmp_free(xmp));
+
+  xmp = parse_packet(PACKET("<photoshop:City>Paris</photoshop:City>"));
+  BOOST_CHECK(!xmp_has_property(xmp, NS_DC, "creator"));
+  BOOST_CHECK(xmp_free(xmp));
+
+  // The xmpDM:copyright migration creates the dc schema.
+  xmp = parse_packet(PACKET("<xmpDM:copyright>2020 Someone</xmpDM:copyright>"));
+  BOOST_CHECK(xmp_get_localized_text(xmp, NS_DC, "rights", NULL, "x-default",
+                                     NULL, value, NULL));
+  BOOST_CHECK(strcmp(xmp_string_cstr(value), "\n\n2020 Someone") == 0);
+  BOOST_CHECK(!xmp_has_property(xmp, kNS_DM, "copyright"));
+  BOOST_CHECK(xmp_free(xmp));
+
+  // With an existing dc schema, its AltText repairs still follow the migration.
+  xmp = parse_packet(PACKET("<dc:title><rdf:Alt><rdf:li>Title</rdf:li></rdf:Alt></dc:title>"
+                            "<xmpDM:copyright>2020 Someone</xmpDM:copyright>"));
+  BOOST_CHECK(xmp_get_localized_text(xmp, NS_DC, "title", NULL, "x-repair",
+                                     NULL, value, NULL));
+  BOOST_CHECK(strcmp(xmp_string_cstr(value), "Title") == 0);
+  BOOST_CHECK(xmp_get_localized_text(xmp, NS_DC, "rights", NULL, "x-default",
+                                     NULL, value, NULL));
+  BOOST_CHECK(strcmp(xmp_string_cstr(value), "\n\n2020 Someone") == 0);
+  BOOST_CHECK(xmp_free(xmp));
+
+  xmp_string_free(value);
+}
+
 // void test_exempi_iterate()
 int test_main(int argc, char *argv[])
 {
@@ -69,6 +129,9 @@ int test_main(int argc, char *argv[])
   BOOST_CHECK(xmp_free(xmp));
 
   free(buffer);
+
+  test_touch_up();
+
   xmp_terminate();
 
   BOOST_CHECK(!g_lt->check_leaks());
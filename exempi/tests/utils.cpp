@@ -61,6 +61,19 @@ void prepare_test(int argc, char *argv[], const char *filename)
   }
 }
 
+bool throwErrors(void * /*context*/, XMP_ErrorSeverity /*severity*/,
+                 XMP_Int32 /*cause*/, XMP_StringPtr /*message*/)
+{
+  return false;
+}
+
+XMP_Bool callErrorCallback(XMPMeta_ErrorCallbackProc clientProc, void *context,
+                           XMP_ErrorSeverity severity, XMP_Int32 cause,
+                           XMP_StringPtr message)
+{
+  return clientProc(context, severity, cause, message);
+}
+
 bool copy_file(const std::string &source, const std::string &dest)
 {
   std::string command = "cp ";
@@ -41,6 +41,8 @@
 
 #include <memory>
 
+#include "XMP_Const.h"
+
 extern std::string g_testfile;
 extern std::string g_src_testdir;
 
@@ -66,4 +68,14 @@ private:
 
 extern std::unique_ptr<LeakTracker> g_lt;
 
+/** Error callback for XMPMeta::SetErrorCallback that makes every error
+ * throw, as exempi does. */
+bool throwErrors(void *context, XMP_ErrorSeverity severity, XMP_Int32 cause,
+                 XMP_StringPtr message);
+
+/** Error callback wrapper that calls the client callback directly. */
+XMP_Bool callErrorCallback(XMPMeta_ErrorCallbackProc clientProc, void *context,
+                           XMP_ErrorSeverity severity, XMP_Int32 cause,
+                           XMP_StringPtr message);
+
 #endif
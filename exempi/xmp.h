@@ -76,6 +76,11 @@ typedef enum {
     XMP_OPEN_OPTIMIZEFILELAYOUT =
         0x00000200, /**< Optimize MPEG4 to support stream when updating
                      * This can take some time */
+    XMP_OPEN_USEMMAP = 0x00000400, /**< Memory map the file for read-only
+                                    * access, ignored for update. */
+    XMP_OPEN_PARALLELSCAN = 0x00000800, /**< Packet scan large files on
+                                         * several threads, up to the number
+                                         * of hardware threads. */
     XMP_OPEN_INBACKGROUND = 0x10000000 /**< Set if calling from background
                                         * thread. */
 } XmpOpenFileOptions;
@@ -284,6 +289,15 @@ typedef enum {
 #define XMP_IS_NODE_SCHEMA(opt) (((opt)&XMP_SCHEMA_NODE) != 0)
 #define XMP_IS_PROP_ALIAS(opt) (((opt)&XMP_PROP_IS_ALIAS) != 0)
 
+enum {                                /* Options for xmp_parse_with_options */
+       XMP_PARSE_REQUIREXMPMETA = 0x0001UL, /**< Require a surrounding
+                                             * x:xmpmeta element. */
+       XMP_PARSE_STRICTALIASING = 0x0004UL, /**< Do not reconcile alias
+                                             * differences, throw. */
+       XMP_PARSE_STREAMING = 0x0008UL       /**< Build the XMP directly from
+                                             * the XML, without an XML tree. */
+};
+
 enum {                                          /* Options for xmp_serialize */
        XMP_SERIAL_OMITPACKETWRAPPER = 0x0010UL, /**< Omit the XML packet
                                                  * wrapper. */
@@ -391,6 +405,60 @@ XmpFilePtr xmp_files_open_new(const char *path, XmpOpenFileOptions options);
  */
 bool xmp_files_open(XmpFilePtr xf, const char *path, XmpOpenFileOptions options);
 
+/** Only keep the properties of some schemas in the XMP of files opened
+ * later with this XmpFile. XMP_OPEN_FORUPDATE is then not allowed.
+ * See %xmp_set_parse_namespaces
+ * @param xf the XmpFilePtr.
+ * @param namespaces the schema namespace URIs to keep.
+ * @param count the number of URIs. 0 keeps all schemas again.
+ * @return true if successful.
+ */
+bool xmp_files_set_parse_namespaces(XmpFilePtr xf, const char **namespaces,
+                                    size_t count);
+
+/** Open XMP data held in memory. The buffer is not copied and must stay
+ * valid until the XmpFilePtr is freed. The data is read-only,
+ * XMP_OPEN_FORUPDATE is not allowed.
+ * @param buffer the file data
+ * @param len the length of buffer in bytes
+ * @param options open flags
+ * @return an XmpFilePtr if successful.
+ */
+XmpFilePtr xmp_files_open_memory(const void *buffer, size_t len,
+                                 XmpOpenFileOptions options);
+
+/** Callbacks for xmp_files_open_io(). opaque is the pointer passed to it.
+ * Offsets are absolute, the callbacks don't keep a current position.
+ */
+typedef struct _XmpIOCallbacks {
+    /** Read up to count bytes at offset. Return the number of bytes read,
+     * 0 at the end of the data, or -1 on error. Required. */
+    int64_t (*read)(void *opaque, uint64_t offset, void *buffer,
+                    uint32_t count);
+    /** Write count bytes at offset, extending the data if needed. Return 0
+     * on success or -1 on error. Only needed for XMP_OPEN_FORUPDATE. */
+    int (*write)(void *opaque, uint64_t offset, const void *buffer,
+                 uint32_t count);
+    /** Return the length of the data in bytes, or -1 on error. Required. */
+    int64_t (*length)(void *opaque);
+    /** Set the length of the data, cutting it or extending it with zeros.
+     * Return 0 on success or -1 on error. Only needed for
+     * XMP_OPEN_FORUPDATE. */
+    int (*truncate)(void *opaque, uint64_t length);
+} XmpIOCallbacks;
+
+/** Open XMP data through client callbacks.
+ * A safe update (XMP_CLOSE_SAFEUPDATE) builds the new data in memory and
+ * writes it back through the callbacks when closing.
+ * @param callbacks the I/O callbacks, copied.
+ * @param opaque passed to the callbacks. Must stay valid until the
+ * XmpFilePtr is freed.
+ * @param options open flags
+ * @return an XmpFilePtr if successful.
+ */
+XmpFilePtr xmp_files_open_io(const XmpIOCallbacks *callbacks, void *opaque,
+                             XmpOpenFileOptions options);
+
 /** Close an XMP file. Will flush the changes
  * @param xf the file object
  * @param options the options to close.
@@ -465,6 +533,17 @@ bool xmp_files_get_format_info(XmpFileType format,
  */
 XmpFileType xmp_files_check_file_format(const char *filePath);
 
+/** Configure the cache of detected file formats used by
+ * xmp_files_check_file_format(). An unchanged file at the same path (same
+ * device, inode, size and modification time) is not read again. The cache is
+ * off by default.
+ * @param capacity the maximum number of files remembered. 0 turns it off.
+ * @param snapshotPath optional file to load the cache from now and to save it
+ * to when it is reconfigured or at xmp_terminate(). Can be NULL.
+ * @return false on error
+ */
+bool xmp_files_set_format_cache(uint32_t capacity, const char *snapshotPath);
+
 /** Register a new namespace to add properties to
  *  This is done automatically when reading the metadata block
  *  @param namespaceURI the namespace URI to register
@@ -525,6 +604,44 @@ bool xmp_free(XmpPtr xmp);
  */
 bool xmp_parse(XmpPtr xmp, const char *buffer, size_t len);
 
+/** Parse the XML passed through the buffer and load it.
+ * @param xmp the XMP packet.
+ * @param buffer the buffer.
+ * @param len the length of the buffer.
+ * @param options options on how to parse the XML. See XMP_PARSE_*
+ * @return TRUE if success.
+ */
+bool xmp_parse_with_options(XmpPtr xmp, const char *buffer, size_t len,
+                            uint32_t options);
+
+/** Only keep the properties of some schemas when parsing into this packet.
+ * Top level properties of other schemas are dropped with their content.
+ * @param xmp the XMP packet.
+ * @param namespaces the schema namespace URIs to keep.
+ * @param count the number of URIs. 0 keeps all schemas again.
+ * @return TRUE if success.
+ */
+bool xmp_set_parse_namespaces(XmpPtr xmp, const char **namespaces,
+                              size_t count);
+
+/** Parse many complete packets at once, each into a new XMP packet.
+ * The packets are parsed on internal threads, up to one per processor.
+ * A library built with a global library lock parses the packets one at
+ * a time on the calling thread.
+ * @param buffers the buffers.
+ * @param lens the lengths of the buffers.
+ * @param count the number of buffers.
+ * @param options options on how to parse the XML. See XMP_PARSE_*
+ * @param xmps receives count XMP packets to free with %xmp_free, NULL
+ *             where the buffer could not be parsed.
+ * @param errors receives count error codes, 0 where the buffer was
+ *               parsed. Can be NULL.
+ * @return TRUE if every buffer was parsed. Otherwise the error is the
+ *         one of the first failed buffer.
+ */
+bool xmp_parse_batch(const char **buffers, const size_t *lens, size_t count,
+                     uint32_t options, XmpPtr *xmps, int *errors);
+
 /** Serialize the XMP Packet to the given buffer
  * @param xmp the XMP Packet
  * @param buffer the buffer to write the XMP to
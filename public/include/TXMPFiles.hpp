@@ -355,6 +355,23 @@ public:
 
     static XMP_FileFormat CheckPackageFormat ( XMP_StringPtr folderPath );
 
+    // ---------------------------------------------------------------------------------------------
+    /// @brief \c SetFormatCache() configures a cache of detected formats for \c CheckFileFormat()
+    /// and \c CheckPackageFormat().
+    ///
+    /// Files and package folders are remembered by path, file and package checks separately. A
+    /// later check of the same path returns the remembered format without reading the file, if the
+    /// file system identity is unchanged: the device, file number, length, and modification time.
+    /// The cache is off by default.
+    ///
+    /// @param capacity The maximum number of remembered files, the least recently used are dropped
+    /// first. Pass 0 to turn the cache off.
+    ///
+    /// @param snapshotPath Optional path of a file holding a snapshot of the cache. The snapshot is
+    /// loaded now and written back when the cache is reconfigured or XMPFiles is terminated.
+
+    static void SetFormatCache ( XMP_Uns32 capacity, XMP_StringPtr snapshotPath = 0 );
+
     // ---------------------------------------------------------------------------------------------
     /// @brief \c GetFileModDate() returns the last modification date of all files that are returned
     /// by \c GetAssociatedResources()
@@ -494,6 +511,10 @@ public:
     ///   \li \c #kXMPFiles_OpenUsePacketScanning - Force packet scanning, do not use a smart handler.
 	///   \li \c #kXMPFiles_OptimizeFileLayout - When updating a file, spend the effort necessary 
 	///    to optimize file layout.
+	///   \li \c #kXMPFiles_OpenUseMmap - For read-only access, memory map the file so the
+	///    handler can parse the native metadata in place instead of copying it.
+	///   \li \c #kXMPFiles_OpenParallelScan - When packet scanning a large local file, scan parts
+	///    of it on several threads.
     ///
     /// @return True if the file is succesfully opened and attached to a file handler. False for
     /// anticipated problems, such as passing \c #kXMPFiles_OpenUseSmartHandler but not having an
@@ -587,6 +608,23 @@ public:
     void SetAbortProc ( XMP_AbortProc abortProc,
                         void *        abortArg );
 
+    // ---------------------------------------------------------------------------------------------
+    /// @brief \c SetParseNamespaces() limits the main XMP of later opens to the properties of some
+    /// schemas.
+    ///
+    /// The list is given to \c TXMPMeta::SetParseNamespaces() for the handler's XMP object when a
+    /// file is opened, so \c GetXMP() only returns the properties of these schemas. Properties made
+    /// from native metadata are still added by the file handler. A file can't be opened for update
+    /// with a namespace list, the rest of its XMP would be lost when it is written.
+    ///
+    /// @param namespaceURIs An array of the schema namespace URIs to keep. Can be null if
+    /// \c uriCount is 0.
+    ///
+    /// @param uriCount The number of URIs in \c namespaceURIs. Zero keeps all schemas again.
+
+    void SetParseNamespaces ( const XMP_StringPtr * namespaceURIs,
+                              XMP_Index             uriCount );
+
     /// @}
 
     // =============================================================================================
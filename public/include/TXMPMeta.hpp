@@ -1426,6 +1426,11 @@ public:
     /// OR of these bit-flag constants:
     ///   \li \c #kXMP_ParseMoreBuffers - This is not the last buffer of input, more calls follow.
     ///   \li \c #kXMP_RequireXMPMeta - The \c x:xmpmeta XML element is required around \c rdf:RDF.
+    ///   \li \c #kXMP_ParseStreaming - Build the XMP tree directly as the XML is parsed, without
+    ///   first building an XML tree. This uses about half the memory. It must be passed with the
+    ///   first buffer. Recoverable RDF errors are reported after the last buffer is parsed.
+    ///
+    /// Only the schemas named by \c SetParseNamespaces() are kept, if it has been called.
     ///
     /// @see \c TXMPFiles::GetXMP()
 
@@ -1433,6 +1438,64 @@ public:
 						   XMP_StringLen  bufferSize,
 						   XMP_OptionBits options = 0 );
 
+    // ---------------------------------------------------------------------------------------------
+    /// @brief \c SetParseNamespaces() limits later parsing to the properties of some schemas.
+    ///
+    /// Use this when only a few schemas are wanted from packets that might be large, for example
+    /// because of \c crs: settings or \c xmpMM:History. \c ParseFromBuffer() drops the top level
+    /// properties of other schemas along with their content, no XMP nodes are made for them and
+    /// their RDF is not checked. With \c #kXMP_ParseStreaming the dropped content is not kept in
+    /// memory at all. Aliases are kept or dropped by the schema they are written in.
+    ///
+    /// The setting stays with the XMP object and is copied by \c Clone(). It can't be changed while
+    /// a parse with \c #kXMP_ParseMoreBuffers is in progress.
+    ///
+    /// @param namespaceURIs An array of the schema namespace URIs to keep. Can be null if
+    /// \c uriCount is 0.
+    ///
+    /// @param uriCount The number of URIs in \c namespaceURIs. Zero keeps all schemas again.
+
+    void SetParseNamespaces ( const XMP_StringPtr * namespaceURIs,
+							  XMP_Index             uriCount );
+
+    // ---------------------------------------------------------------------------------------------
+    /// @brief \c ParseBatch() parses many complete packets, each into its own XMP object.
+    ///
+    /// The packets are parsed at the same time on internal threads, up to one per processor. This
+    /// is the same as calling \c ParseFromBuffer() for each object, except for the threading. An
+    /// error in one packet does not stop the others. Its error ID is returned in \c errorIDs and
+    /// that XMP object is left empty. The error callbacks of the XMP objects can be called from the
+    /// internal threads.
+    ///
+    /// Each internal thread reuses its parser and node storage from one packet to the next, but
+    /// the threads exit at the end of the call, so nothing is reused between calls. A library
+    /// built with a global library lock parses the packets one at a time on the calling thread.
+    ///
+    /// This function is static; make the call directly from the concrete class (\c SXMPMeta).
+    ///
+    /// @param count The number of packets.
+    ///
+    /// @param buffers An array of \c count pointers to the packets.
+    ///
+    /// @param sizes An array of \c count packet lengths in bytes. \c #kXMP_UseNullTermination is
+    /// allowed.
+    ///
+    /// @param xmpObjs An array of \c count XMP objects to parse into. Their previous contents are
+    /// replaced.
+    ///
+    /// @param errorIDs An array of \c count error IDs to fill in, \c #kXMPErr_NoError for a packet
+    /// that was parsed.
+    ///
+    /// @param options The \c ParseFromBuffer() options for all of the packets, except
+    /// \c #kXMP_ParseMoreBuffers.
+
+    static void ParseBatch ( XMP_Index             count,
+                             const XMP_StringPtr * buffers,
+                             const XMP_StringLen * sizes,
+                             TXMPMeta *            xmpObjs,
+                             XMP_Int32 *           errorIDs,
+                             XMP_OptionBits        options = 0 );
+
     // ---------------------------------------------------------------------------------------------
     /// @brief \c SerializeToBuffer() serializes metadata in this XMP object into a string as RDF.
     ///
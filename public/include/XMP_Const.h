@@ -708,7 +708,10 @@ enum {
     kXMP_ParseMoreBuffers = 0x0002UL,
 
 	/// Do not reconcile alias differences, throw an exception.
-    kXMP_StrictAliasing   = 0x0004UL
+    kXMP_StrictAliasing   = 0x0004UL,
+
+	/// Build the XMP directly from the XML parse events, without an intermediate XML tree.
+    kXMP_ParseStreaming   = 0x0008UL
 
 };
 
@@ -1189,7 +1192,14 @@ enum {
     kXMPFiles_OpenRepairFile        = 0x00000100,
 
 	/// When updating a file, spend the effort necessary to optimize file layout.
-	kXMPFiles_OptimizeFileLayout    = 0x00000200
+	kXMPFiles_OptimizeFileLayout    = 0x00000200,
+
+	/// For read-only access, memory map the file so handlers can use the data in place. Ignored
+	/// when opening for update, falls back to normal reads if the file can't be mapped.
+	kXMPFiles_OpenUseMmap           = 0x00000400,
+
+	/// When packet scanning a large local file, scan parts of it on several threads.
+	kXMPFiles_OpenParallelScan      = 0x00000800
 
 };
 
@@ -88,6 +88,9 @@ inline XMP_Bool WrapFilesErrorNotify ( XMPFiles_ErrorCallbackProc proc, void * c
 #define zXMPFiles_CheckPackageFormat_1(folderPath) \
 	WXMPFiles_CheckPackageFormat_1 ( folderPath, &wResult )
 
+#define zXMPFiles_SetFormatCache_1(capacity,snapshotPath) \
+	WXMPFiles_SetFormatCache_1 ( capacity, snapshotPath, &wResult )
+
 #define zXMPFiles_GetFileModDate_1(filePath,modDate,format,options) \
 	WXMPFiles_GetFileModDate_1 ( filePath, modDate, format, options, &wResult )
 
@@ -114,6 +117,9 @@ inline XMP_Bool WrapFilesErrorNotify ( XMPFiles_ErrorCallbackProc proc, void * c
 #define zXMPFiles_SetAbortProc_1(abortProc,abortArg) \
 	WXMPFiles_SetAbortProc_1 ( this->xmpFilesRef, abortProc, abortArg, &wResult )
 
+#define zXMPFiles_SetParseNamespaces_1(namespaceURIs,uriCount) \
+	WXMPFiles_SetParseNamespaces_1 ( this->xmpFilesRef, namespaceURIs, uriCount, &wResult )
+
 #define zXMPFiles_GetXMP_1(xmpRef,clientPacket,packetInfo,SetClientString) \
 	WXMPFiles_GetXMP_1 ( this->xmpFilesRef, xmpRef, clientPacket, packetInfo, SetClientString, &wResult )
 
@@ -168,6 +174,10 @@ extern void WXMPFiles_CheckFileFormat_1 ( XMP_StringPtr filePath,
 extern void WXMPFiles_CheckPackageFormat_1 ( XMP_StringPtr folderPath,
                       						 WXMP_Result * result );
 
+extern void WXMPFiles_SetFormatCache_1 ( XMP_Uns32     capacity,
+                                         XMP_StringPtr snapshotPath,	// ! Can be null.
+                                         WXMP_Result * result );
+
 extern void WXMPFiles_GetFileModDate_1 ( XMP_StringPtr    filePath,
                                          XMP_DateTime *   modDate,
 					                     XMP_FileFormat * format,	// ! Can be null.
@@ -219,6 +229,11 @@ extern void WXMPFiles_SetAbortProc_1 ( XMPFilesRef   xmpFilesRef,
 									   void *        abortArg,
                                        WXMP_Result * result );
 
+extern void WXMPFiles_SetParseNamespaces_1 ( XMPFilesRef           xmpFilesRef,
+                                             const XMP_StringPtr * namespaceURIs,
+                                             XMP_Index             uriCount,
+                                             WXMP_Result *         result );
+
 extern void WXMPFiles_GetXMP_1 ( XMPFilesRef      xmpFilesRef,
                                  XMPMetaRef       xmpRef,		// ! Can be null.
     			                 void *           clientPacket,
@@ -187,6 +187,12 @@ inline XMP_Bool WrapErrorNotify ( XMPMeta_ErrorCallbackProc proc, void * context
 #define zXMPMeta_ParseFromBuffer_1(buffer,bufferSize,options) \
     WXMPMeta_ParseFromBuffer_1 ( this->xmpRef, buffer, bufferSize, options, &wResult )
 
+#define zXMPMeta_SetParseNamespaces_1(namespaceURIs,uriCount) \
+    WXMPMeta_SetParseNamespaces_1 ( this->xmpRef, namespaceURIs, uriCount, &wResult )
+
+#define zXMPMeta_ParseBatch_1(count,buffers,sizes,options,xmpRefs,errorIDs) \
+    WXMPMeta_ParseBatch_1 ( count, buffers, sizes, options, xmpRefs, errorIDs, &wResult )
+
 #define zXMPMeta_SerializeToBuffer_1(pktString,options,padding,newline,indent,baseIndent,SetClientString) \
     WXMPMeta_SerializeToBuffer_1 ( this->xmpRef, pktString, options, padding, newline, indent, baseIndent, SetClientString, &wResult )
 
@@ -593,6 +599,21 @@ XMP_PUBLIC WXMPMeta_ParseFromBuffer_1 ( XMPMetaRef     xmpRef,
                              XMP_OptionBits options,
                              WXMP_Result *  wResult );
 
+extern void
+XMP_PUBLIC WXMPMeta_SetParseNamespaces_1 ( XMPMetaRef            xmpRef,
+                                const XMP_StringPtr * namespaceURIs,
+                                XMP_Index             uriCount,
+                                WXMP_Result *         wResult );
+
+extern void
+XMP_PUBLIC WXMPMeta_ParseBatch_1 ( XMP_Index             count,
+                        const XMP_StringPtr * buffers,
+                        const XMP_StringLen * sizes,
+                        XMP_OptionBits        options,
+                        XMPMetaRef *          xmpRefs,
+                        XMP_Int32 *           errorIDs,
+                        WXMP_Result *         wResult );
+
 extern void
 XMP_PUBLIC WXMPMeta_SerializeToBuffer_1 ( XMPMetaRef     xmpRef,
                                void *         pktString,
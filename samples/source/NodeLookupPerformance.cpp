@@ -0,0 +1,156 @@
+// =================================================================================================
+
+/**
+* Times the property lookups of SXMPMeta for the narrow schemas and structs of common packets. These
+* have fewer children than the hashed index threshold, so each lookup is a linear search over the
+* node names. Top level properties, struct fields and qualifiers are each looked up a number of times,
+* the elapsed time and lookup rate are printed.
+*/
+
+#include <cstdio>
+#include <string>
+#include <cstring>
+#include <ctime>
+
+#include <stdexcept>
+
+#define TXMP_STRING_TYPE std::string
+#define XMP_INCLUDE_XMPFILES 0
+
+#include "public/include/XMP.hpp"
+#include "public/include/XMP.incl_cpp"
+
+using namespace std;
+
+// =================================================================================================
+
+static const char * kExifNames[] = {
+	"ExifVersion", "FlashpixVersion", "ColorSpace", "PixelXDimension", "PixelYDimension",
+	"DateTimeOriginal", "DateTimeDigitized", "ExposureTime", "FNumber", "ExposureProgram",
+	"ISOSpeedRatings", "ShutterSpeedValue", "ApertureValue", "BrightnessValue", "ExposureBiasValue",
+	"MaxApertureValue", "MeteringMode", "LightSource", "FocalLength", "FocalPlaneXResolution",
+	"FocalPlaneYResolution", "FocalPlaneResolutionUnit", "SensingMethod", "FileSource", "SceneType",
+	"CustomRendered", "ExposureMode", "WhiteBalance", "SceneCaptureType", 0 };
+
+static const char * kEventFields[] = {
+	"action", "instanceID", "when", "softwareAgent", "changed", "parameters", 0 };
+
+static const size_t kHistoryCount = 50;
+static const size_t kRepeatCount = 20000;
+
+static void MakeMetadata ( SXMPMeta & meta )
+{
+	char value [128];
+
+	for ( size_t i = 0; kExifNames[i] != 0; ++i ) {
+		snprintf ( value, sizeof(value), "%d", (int)(i * 37) );
+		meta.SetProperty ( kXMP_NS_EXIF, kExifNames[i], value );
+	}
+
+	for ( size_t i = 0; i < kHistoryCount; ++i ) {
+		string itemPath;
+		meta.AppendArrayItem ( kXMP_NS_XMP_MM, "History", kXMP_PropArrayIsOrdered, 0, kXMP_PropValueIsStruct );
+		SXMPUtils::ComposeArrayItemPath ( kXMP_NS_XMP_MM, "History", kXMP_ArrayLastItem, &itemPath );
+		for ( size_t f = 0; kEventFields[f] != 0; ++f ) {
+			snprintf ( value, sizeof(value), "%s %d", kEventFields[f], (int)i );
+			meta.SetStructField ( kXMP_NS_XMP_MM, itemPath.c_str(), kXMP_NS_XMP_ResourceEvent, kEventFields[f], value );
+		}
+	}
+
+	meta.SetLocalizedText ( kXMP_NS_DC, "title", "", "x-default", "A title" );
+	meta.SetQualifier ( kXMP_NS_EXIF, "ColorSpace", kXMP_NS_XMP, "Label", "sRGB" );
+	meta.SetQualifier ( kXMP_NS_EXIF, "ColorSpace", kXMP_NS_XMP_MM, "OriginalDocumentID", "doc" );
+	meta.SetQualifier ( kXMP_NS_EXIF, "ColorSpace", kXMP_NS_DC, "source", "camera" );
+
+}	// MakeMetadata
+
+// =================================================================================================
+
+static void ReportRate ( FILE * log, const char * mode, clock_t start, size_t lookupCount, size_t foundCount )
+{
+	double elapsed = double(clock()-start) / CLOCKS_PER_SEC;
+	fprintf ( log, "  %-14s : %d lookups, %.3f seconds, %.2f M lookups/s\n", mode, (int)lookupCount, elapsed,
+			  ((elapsed > 0) ? (double(lookupCount) / elapsed / 1.0e6) : 0.0) );
+	if ( foundCount != lookupCount ) fprintf ( log, "  ** %d lookups failed\n", (int)(lookupCount - foundCount) );
+
+}	// ReportRate
+
+// -------------------------------------------------------------------------------------------------
+
+static void ReportPerformance ( FILE * log, const SXMPMeta & meta )
+{
+	size_t lookupCount, foundCount;
+	clock_t start;
+
+	lookupCount = foundCount = 0;
+	start = clock();
+	for ( size_t r = 0; r < kRepeatCount; ++r ) {
+		for ( size_t i = 0; kExifNames[i] != 0; ++i ) {
+			foundCount += meta.GetProperty ( kXMP_NS_EXIF, kExifNames[i], 0, 0 );
+			++lookupCount;
+		}
+	}
+	ReportRate ( log, "properties", start, lookupCount, foundCount );
+
+	lookupCount = foundCount = 0;
+	start = clock();
+	for ( size_t r = 0; r < (kRepeatCount / 10); ++r ) {
+		for ( size_t i = 1; i <= kHistoryCount; ++i ) {
+			string itemPath;
+			SXMPUtils::ComposeArrayItemPath ( kXMP_NS_XMP_MM, "History", (XMP_Index)i, &itemPath );
+			for ( size_t f = 0; kEventFields[f] != 0; ++f ) {
+				foundCount += meta.GetStructField ( kXMP_NS_XMP_MM, itemPath.c_str(), kXMP_NS_XMP_ResourceEvent, kEventFields[f], 0, 0 );
+				++lookupCount;
+			}
+		}
+	}
+	ReportRate ( log, "struct fields", start, lookupCount, foundCount );
+
+	lookupCount = foundCount = 0;
+	start = clock();
+	for ( size_t r = 0; r < (kRepeatCount * 10); ++r ) {
+		foundCount += meta.GetQualifier ( kXMP_NS_EXIF, "ColorSpace", kXMP_NS_XMP, "Label", 0, 0 );
+		foundCount += meta.GetQualifier ( kXMP_NS_EXIF, "ColorSpace", kXMP_NS_DC, "source", 0, 0 );
+		lookupCount += 2;
+	}
+	ReportRate ( log, "qualifiers", start, lookupCount, foundCount );
+
+}	// ReportPerformance
+
+// =================================================================================================
+
+extern "C" int main ( int /*argc*/, const char * /*argv*/ [] )
+{
+	FILE * log = stdout;
+
+	try {
+
+		if ( ! SXMPMeta::Initialize() ) {
+			fprintf ( log, "SXMPMeta::Initialize failed\n" );
+			return 1;
+		}
+
+		{
+			SXMPMeta meta;
+			MakeMetadata ( meta );
+
+			fprintf ( log, "Property lookups in narrow schemas and structs\n\n" );
+			ReportPerformance ( log, meta );
+		}
+
+		SXMPMeta::Terminate();
+
+	} catch ( XMP_Error & excep ) {
+		fprintf ( log, "Caught XMP_Error %d : %s\n", excep.GetID(), excep.GetErrMsg() );
+		return 1;
+	} catch ( std::exception & excep ) {
+		fprintf ( log, "Caught exception: %s\n", excep.what() );
+		return 1;
+	} catch ( ... ) {
+		fprintf ( log, "Caught unknown exception\n" );
+		return 1;
+	}
+
+	return 0;
+
+}	// main
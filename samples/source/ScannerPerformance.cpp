@@ -0,0 +1,135 @@
+// =================================================================================================
+
+/**
+* Times the XMP packet scanner over synthetic worst case inputs: runs of stray '<' characters, packet
+* header prefixes that never complete, and many tiny packets that split the snip table. Each input is
+* fed to the scanner in large and small buffers, the throughput and final snip count are printed.
+*/
+
+#include <cstdio>
+#include <vector>
+#include <string>
+#include <cstring>
+#include <ctime>
+
+#include <cstdlib>
+#include <stdexcept>
+
+#include "public/include/XMP_Environment.h"
+#include "public/include/XMP_Const.h"
+
+#include "XMPFiles/source/FormatSupport/XMPScanner.hpp"
+#include "XMPFiles/source/FormatSupport/XMPScanner.cpp"
+
+using namespace std;
+
+// =================================================================================================
+
+static const size_t kInputSize = 32*1024*1024;
+
+static const char * kTinyPacket =
+	"<?xpacket begin='' id='W5M0MpCehiHzreSzNTczkc9d'?><x:xmpmeta xmlns:x='adobe:ns:meta/'/><?xpacket end='w'?>";
+
+// =================================================================================================
+
+static void FillRepeated ( vector<char> & input, const char * pattern )
+{
+	const size_t patternLen = strlen ( pattern );
+
+	for ( size_t i = 0; i < input.size(); ++i ) input[i] = pattern [i % patternLen];
+
+}	// FillRepeated
+
+// =================================================================================================
+
+static void FillPackets ( vector<char> & input, size_t gap )
+{
+	const size_t packetLen = strlen ( kTinyPacket );
+
+	memset ( &input[0], ' ', input.size() );
+	for ( size_t i = 0; (i + packetLen) <= input.size(); i += (packetLen + gap) ) {
+		memcpy ( &input[i], kTinyPacket, packetLen );
+	}
+
+}	// FillPackets
+
+// =================================================================================================
+
+static void FillRandom ( vector<char> & input )
+{
+
+	srand ( 1 );
+	for ( size_t i = 0; i < input.size(); ++i ) input[i] = (char) (rand() >> 4);
+
+}	// FillRandom
+
+// =================================================================================================
+
+static void ReportPerformance ( FILE * log, const char * content, const vector<char> & input )
+{
+	static const size_t kBufferSizes[] = { 64*1024, 4*1024, 0 };
+
+	for ( size_t b = 0; kBufferSizes[b] != 0; ++b ) {
+
+		const size_t bufferSize = kBufferSizes[b];
+
+		clock_t start = clock();
+
+		XMPScanner scanner ( (XMP_Int64)input.size() );
+		for ( size_t pos = 0; pos < input.size(); pos += bufferSize ) {
+			size_t len = bufferSize;
+			if ( len > (input.size() - pos) ) len = input.size() - pos;
+			scanner.Scan ( &input[pos], (XMP_Int64)pos, (XMP_Int64)len );
+		}
+
+		XMPScanner::SnipInfoVector snips;
+		scanner.Report ( snips );
+
+		clock_t end = clock();
+		double elapsed = double(end-start) / CLOCKS_PER_SEC;
+		double rate = (elapsed > 0) ? ((double)input.size() / (1024*1024) / elapsed) : 0;
+
+		fprintf ( log, "  %-24s %6d KB buffers : %.3f seconds, %8.1f MB/s, %ld snips\n",
+				  content, (int)(bufferSize / 1024), elapsed, rate, (long)snips.size() );
+
+	}
+
+}	// ReportPerformance
+
+// =================================================================================================
+
+extern "C" int main ( int /*argc*/, const char * /*argv*/ [] )
+{
+	FILE * log = stdout;
+	vector<char> input ( kInputSize );
+
+	fprintf ( log, "XMPScanner performance over %d MB of input\n\n", (int)(kInputSize / (1024*1024)) );
+
+	try {
+
+		FillRepeated ( input, "<" );
+		ReportPerformance ( log, "stray '<'", input );
+
+		FillRepeated ( input, "<?xpacket begin=" );
+		ReportPerformance ( log, "unfinished headers", input );
+
+		FillPackets ( input, 16 );
+		ReportPerformance ( log, "tiny packets", input );
+
+		FillPackets ( input, 4096 );
+		ReportPerformance ( log, "sparse packets", input );
+
+		FillRandom ( input );
+		ReportPerformance ( log, "random bytes", input );
+
+	} catch ( std::exception & excep ) {
+		fprintf ( log, "Caught exception: %s\n", excep.what() );
+		return 1;
+	} catch ( ... ) {
+		fprintf ( log, "Caught unknown exception\n" );
+		return 1;
+	}
+
+	return 0;
+
+}	// main
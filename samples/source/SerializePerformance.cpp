@@ -0,0 +1,132 @@
+// =================================================================================================
+
+/**
+* Times SXMPMeta::SerializeToBuffer for a large synthetic XMP object, the kind of packet written by
+* raw converters with many crs: settings and a long xmpMM:History. The object is serialized a number
+* of times with the default (canonical) and compact formats, the elapsed time and throughput are
+* printed.
+*/
+
+#include <cstdio>
+#include <string>
+#include <cstring>
+#include <ctime>
+
+#include <stdexcept>
+
+#define TXMP_STRING_TYPE std::string
+#define XMP_INCLUDE_XMPFILES 0
+
+#include "public/include/XMP.hpp"
+#include "public/include/XMP.incl_cpp"
+
+using namespace std;
+
+// =================================================================================================
+
+static const char * kNS_CRS = "http://ns.adobe.com/camera-raw-settings/1.0/";
+
+static const size_t kSettingCount = 400;
+static const size_t kCurvePointCount = 256;
+static const size_t kHistoryCount = 4000;
+static const size_t kRepeatCount = 20;
+
+static void MakeMetadata ( SXMPMeta & meta )
+{
+	char name [64], value [128];
+
+	SXMPMeta::RegisterNamespace ( kNS_CRS, "crs", 0 );
+
+	meta.SetProperty ( kXMP_NS_XMP, "CreatorTool", "SerializePerformance" );
+	meta.SetLocalizedText ( kXMP_NS_DC, "title", "", "x-default", "A title with <markup> & \"quotes\"" );
+	meta.AppendArrayItem ( kXMP_NS_DC, "subject", kXMP_PropArrayIsUnordered, "one" );
+	meta.AppendArrayItem ( kXMP_NS_DC, "subject", kXMP_PropArrayIsUnordered, "two" );
+
+	for ( size_t i = 0; i < kSettingCount; ++i ) {
+		snprintf ( name, sizeof(name), "Setting%d", (int)i );
+		snprintf ( value, sizeof(value), "%+d.%02d", (int)(i % 100) - 50, (int)(i % 97) );
+		meta.SetProperty ( kNS_CRS, name, value );
+	}
+
+	for ( size_t i = 0; i < kCurvePointCount; ++i ) {
+		snprintf ( value, sizeof(value), "%d, %d", (int)i, (int)((i * i) / 255) );
+		meta.AppendArrayItem ( kNS_CRS, "ToneCurvePV2012", kXMP_PropArrayIsOrdered, value );
+	}
+
+	for ( size_t i = 0; i < kHistoryCount; ++i ) {
+		string itemPath;
+		meta.AppendArrayItem ( kXMP_NS_XMP_MM, "History", kXMP_PropArrayIsOrdered, 0, kXMP_PropValueIsStruct );
+		SXMPUtils::ComposeArrayItemPath ( kXMP_NS_XMP_MM, "History", kXMP_ArrayLastItem, &itemPath );
+		meta.SetStructField ( kXMP_NS_XMP_MM, itemPath.c_str(), kXMP_NS_XMP_ResourceEvent, "action", "saved" );
+		snprintf ( value, sizeof(value), "xmp.iid:%08x-1c2b-4d3e-9f00-%012x", (unsigned)i, (unsigned)(i * 7919) );
+		meta.SetStructField ( kXMP_NS_XMP_MM, itemPath.c_str(), kXMP_NS_XMP_ResourceEvent, "instanceID", value );
+		snprintf ( value, sizeof(value), "2020-%02d-%02dT10:%02d:00+01:00", (int)(i % 12) + 1, (int)(i % 28) + 1, (int)(i % 60) );
+		meta.SetStructField ( kXMP_NS_XMP_MM, itemPath.c_str(), kXMP_NS_XMP_ResourceEvent, "when", value );
+		meta.SetStructField ( kXMP_NS_XMP_MM, itemPath.c_str(), kXMP_NS_XMP_ResourceEvent, "softwareAgent", "Raw Converter 12.0" );
+		meta.SetStructField ( kXMP_NS_XMP_MM, itemPath.c_str(), kXMP_NS_XMP_ResourceEvent, "changed", "/metadata" );
+	}
+
+}	// MakeMetadata
+
+// =================================================================================================
+
+static void ReportPerformance ( FILE * log, const char * mode, const SXMPMeta & meta, XMP_OptionBits options )
+{
+	string packet;
+	size_t totalSize = 0;
+	clock_t start = clock();
+
+	for ( size_t i = 0; i < kRepeatCount; ++i ) {
+		meta.SerializeToBuffer ( &packet, options );
+		totalSize += packet.size();
+	}
+
+	clock_t end = clock();
+	double elapsed = double(end-start) / CLOCKS_PER_SEC;
+	double megabytes = double(totalSize) / (1024.0 * 1024.0);
+
+	fprintf ( log, "  %-10s : %d KB packet, %.3f seconds, %.1f MB/s\n",
+			  mode, (int)(packet.size() / 1024), elapsed, ((elapsed > 0) ? (megabytes / elapsed) : 0.0) );
+
+}	// ReportPerformance
+
+// =================================================================================================
+
+extern "C" int main ( int /*argc*/, const char * /*argv*/ [] )
+{
+	FILE * log = stdout;
+
+	try {
+
+		if ( ! SXMPMeta::Initialize() ) {
+			fprintf ( log, "SXMPMeta::Initialize failed\n" );
+			return 1;
+		}
+
+		{
+			SXMPMeta meta;
+			MakeMetadata ( meta );
+
+			fprintf ( log, "SerializeToBuffer, %d serializations each\n\n", (int)kRepeatCount );
+
+			ReportPerformance ( log, "canonical", meta, 0 );
+			ReportPerformance ( log, "compact", meta, kXMP_UseCompactFormat );
+			ReportPerformance ( log, "rdf hash", meta, kXMP_UseCompactFormat | kXMP_IncludeRDFHash );
+		}
+
+		SXMPMeta::Terminate();
+
+	} catch ( XMP_Error & excep ) {
+		fprintf ( log, "Caught XMP_Error %d : %s\n", excep.GetID(), excep.GetErrMsg() );
+		return 1;
+	} catch ( std::exception & excep ) {
+		fprintf ( log, "Caught exception: %s\n", excep.what() );
+		return 1;
+	} catch ( ... ) {
+		fprintf ( log, "Caught unknown exception\n" );
+		return 1;
+	}
+
+	return 0;
+
+}	// main
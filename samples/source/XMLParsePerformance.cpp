@@ -0,0 +1,152 @@
+// =================================================================================================
+
+/**
+* Counts the heap allocations made while Expat builds the XML tree for a large synthetic XMP packet,
+* with the nodes allocated one by one and from an XML_NodeArena. The tree is built and deleted a
+* number of times for each mode, the allocation and free counts and the elapsed time are printed.
+*/
+
+#include <cstdio>
+#include <vector>
+#include <string>
+#include <cstring>
+#include <ctime>
+
+#include <cstdlib>
+#include <new>
+#include <stdexcept>
+
+#define TXMP_STRING_TYPE std::string
+#define XMP_INCLUDE_XMPFILES 0
+
+#include "public/include/XMP.hpp"
+#include "public/include/XMP.incl_cpp"
+
+#include "source/ExpatAdapter.hpp"
+
+using namespace std;
+
+// =================================================================================================
+
+static size_t sAllocCount = 0;
+static size_t sFreeCount = 0;
+
+void * operator new ( size_t size )
+{
+	void * ptr = malloc ( (size == 0) ? 1 : size );
+	if ( ptr == 0 ) throw std::bad_alloc();
+	++sAllocCount;
+	return ptr;
+}
+
+void operator delete ( void * ptr ) throw()
+{
+	if ( ptr == 0 ) return;
+	++sFreeCount;
+	free ( ptr );
+}
+
+void * operator new[] ( size_t size ) { return operator new ( size ); }
+void operator delete[] ( void * ptr ) throw() { operator delete ( ptr ); }
+
+void operator delete ( void * ptr, size_t /*size*/ ) throw() { operator delete ( ptr ); }
+void operator delete[] ( void * ptr, size_t /*size*/ ) throw() { operator delete ( ptr ); }
+
+// =================================================================================================
+
+static const size_t kPropertyCount = 20000;
+static const size_t kRepeatCount = 10;
+
+static void MakePacket ( string & packet )
+{
+	char buffer [512];
+
+	packet = "<?xpacket begin='' id='W5M0MpCehiHzreSzNTczkc9d'?>\n"
+			 "<x:xmpmeta xmlns:x='adobe:ns:meta/'>\n"
+			 " <rdf:RDF xmlns:rdf='http://www.w3.org/1999/02/22-rdf-syntax-ns#'>\n"
+			 "  <rdf:Description rdf:about='' xmlns:dc='http://purl.org/dc/elements/1.1/'\n"
+			 "    xmlns:xmp='http://ns.adobe.com/xap/1.0/' xmp:CreatorTool='XMLParsePerformance'>\n";
+
+	for ( size_t i = 0; i < kPropertyCount; ++i ) {
+		snprintf ( buffer, sizeof(buffer),
+				   "   <xmp:Label%d>Label value number %d with some text</xmp:Label%d>\n"
+				   "   <dc:subject%d><rdf:Bag><rdf:li>one</rdf:li><rdf:li>two</rdf:li></rdf:Bag></dc:subject%d>\n"
+				   "   <dc:title%d><rdf:Alt><rdf:li xml:lang='x-default'>Title %d</rdf:li></rdf:Alt></dc:title%d>\n",
+				   (int)i, (int)i, (int)i, (int)i, (int)i, (int)i, (int)i, (int)i );
+		packet += buffer;
+	}
+
+	packet += "  </rdf:Description>\n"
+			  " </rdf:RDF>\n"
+			  "</x:xmpmeta>\n"
+			  "<?xpacket end='w'?>";
+
+}	// MakePacket
+
+// =================================================================================================
+
+static void ReportPerformance ( FILE * log, const char * mode, const string & packet, bool useArena )
+{
+	size_t allocCount = 0, freeCount = 0;
+	clock_t start = clock();
+
+	for ( size_t i = 0; i < kRepeatCount; ++i ) {
+
+		size_t allocStart = sAllocCount, freeStart = sFreeCount;
+
+		XMLParserAdapter * xmlParser = XMP_NewExpatAdapter ( ExpatAdapter::kUseGlobalNamespaces );
+		if ( useArena ) xmlParser->nodeArena = new XML_NodeArena();
+		xmlParser->ParseBuffer ( packet.c_str(), packet.size(), true );
+		delete xmlParser;
+
+		allocCount += sAllocCount - allocStart;
+		freeCount += sFreeCount - freeStart;
+
+	}
+
+	clock_t end = clock();
+	double elapsed = double(end-start) / CLOCKS_PER_SEC;
+
+	fprintf ( log, "  %-16s : %.3f seconds, %ld allocations, %ld frees per tree\n",
+			  mode, elapsed, (long)(allocCount / kRepeatCount), (long)(freeCount / kRepeatCount) );
+
+}	// ReportPerformance
+
+// =================================================================================================
+
+extern "C" int main ( int /*argc*/, const char * /*argv*/ [] )
+{
+	FILE * log = stdout;
+
+	try {
+
+		if ( ! SXMPMeta::Initialize() ) {
+			fprintf ( log, "SXMPMeta::Initialize failed\n" );
+			return 1;
+		}
+
+		string packet;
+		MakePacket ( packet );
+
+		fprintf ( log, "XML tree allocations for a %d KB packet, %d trees each\n\n",
+				  (int)(packet.size() / 1024), (int)kRepeatCount );
+
+		ReportPerformance ( log, "separate nodes", packet, false );
+		ReportPerformance ( log, "node arena", packet, true );
+
+		SXMPMeta::Terminate();
+
+	} catch ( XMP_Error & excep ) {
+		fprintf ( log, "Caught XMP_Error %d : %s\n", excep.GetID(), excep.GetErrMsg() );
+		return 1;
+	} catch ( std::exception & excep ) {
+		fprintf ( log, "Caught exception: %s\n", excep.what() );
+		return 1;
+	} catch ( ... ) {
+		fprintf ( log, "Caught unknown exception\n" );
+		return 1;
+	}
+
+	return 0;
+
+}	// main
@@ -28,6 +28,14 @@ public:
 
 	XML_Parser parser;
 	XMP_NamespaceTable * registeredNamespaces;
+
+	// Reused for the elements passed to an event receiver, the attribute nodes are owned by eventAttrs.
+	// The nesting records which open elements are rdf:Description, for the about and ID fixes.
+	XML_Node eventNode;
+	XML_NodeVector eventAttrs;
+	std::vector<bool> eventNesting;
+
+	size_t parsedBytes;	// Input passed to Expat since the last reset, large parsers are not pooled.
 	
 	#if BanAllEntityUsage
 		bool isAborted;
@@ -44,16 +52,25 @@ public:
 	virtual ~ExpatAdapter();
 	
 	void ParseBuffer ( const void * buffer, size_t length, bool last = true );
+	bool Reset();
 
 private:
 
-	ExpatAdapter() : registeredNamespaces(0) {};	// ! Force use of constructor with namespace parameter.
+	ExpatAdapter() : registeredNamespaces(0), eventNode(0,"",kElemNode), parsedBytes(0) {};	// ! Force use of constructor with namespace parameter.
+
+	void SetHandlers();
 
 };
 
 extern "C" ExpatAdapter *
 XMP_PUBLIC XMP_NewExpatAdapter ( bool useGlobalNamespaces );
 
+// A per-thread pool of adapters using the global namespace table, for XMPMeta parsing. A released
+// adapter is reset with XML_ParserReset and handed out again by the next acquire on the thread.
+
+extern ExpatAdapter * XMP_AcquireExpatAdapter();
+extern void XMP_ReleaseExpatAdapter ( ExpatAdapter * adapter );
+
 // =================================================================================================
 
 #endif	// __ExpatAdapter_hpp__
@@ -19,6 +19,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <unistd.h>
+#include <sys/mman.h>
 #include <sys/stat.h>
 #include <sys/types.h>
 
@@ -26,6 +27,12 @@
 	#include <limits.h>
 #endif
 
+#if defined(__linux__)
+	#include <sys/ioctl.h>
+	#include <sys/syscall.h>
+	#include <linux/fs.h>
+#endif
+
 // =================================================================================================
 // Host_IO implementations for POSIX
 // =================================
@@ -159,6 +166,29 @@ bool Host_IO::GetModifyDate ( const char* filePath, XMP_DateTime* modifyDate )
 
 }	// Host_IO::GetModifyDate
 
+// =================================================================================================
+// Host_IO::GetFileIdentity
+// ========================
+
+bool Host_IO::GetFileIdentity ( const char* filePath, FileIdentity* identity )
+{
+	struct stat info;
+	int err = stat ( filePath, &info );
+	if ( err != 0 ) return false;
+	if ( (! S_ISREG(info.st_mode)) && (! S_ISDIR(info.st_mode)) ) return false;
+
+	identity->device = info.st_dev;
+	identity->fileNumber = info.st_ino;
+	identity->length = info.st_size;
+	#if XMP_MacBuild | XMP_iOSBuild
+		identity->modifyTime = ((XMP_Int64)info.st_mtimespec.tv_sec * 1000000000) + info.st_mtimespec.tv_nsec;
+	#else
+		identity->modifyTime = ((XMP_Int64)info.st_mtim.tv_sec * 1000000000) + info.st_mtim.tv_nsec;
+	#endif
+	return true;
+
+}	// Host_IO::GetFileIdentity
+
 // =================================================================================================
 // ConjureDerivedPath
 // ==================
@@ -381,18 +411,129 @@ void Host_IO::Write ( Host_IO::FileRef refNum, const void * buffer, XMP_Uns32 co
 
 }	// Host_IO::Write
 
+// =================================================================================================
+// Host_IO::ReadAt
+// ===============
+
+XMP_Uns32 Host_IO::ReadAt ( Host_IO::FileRef refNum, XMP_Int64 offset, void * buffer, XMP_Uns32 count )
+{
+	if ( count >= TwoGB ) XMP_Throw ( "Host_IO::ReadAt, request too large", kXMPErr_EnforceFailure );
+
+	XMP_Uns8 * bufferPtr = (XMP_Uns8*)buffer;
+	XMP_Uns32 totalRead = 0;
+
+	while ( totalRead < count ) {	// ! pread may return less than asked for before EOF.
+		ssize_t bytesRead = pread ( refNum, (bufferPtr + totalRead), (count - totalRead), (off_t)(offset + totalRead) );
+		if ( bytesRead == -1 ) {
+			if ( errno == EINTR ) continue;
+			XMP_Throw ( "Host_IO::ReadAt, pread failure", kXMPErr_ReadError );
+		}
+		if ( bytesRead == 0 ) break;	// Reached EOF.
+		totalRead += (XMP_Uns32)bytesRead;
+	}
+
+	return totalRead;
+
+}	// Host_IO::ReadAt
+
+// =================================================================================================
+// Host_IO::WriteAt
+// ================
+
+void Host_IO::WriteAt ( Host_IO::FileRef refNum, XMP_Int64 offset, const void * buffer, XMP_Uns32 count )
+{
+	if ( count >= TwoGB ) XMP_Throw ( "Host_IO::WriteAt, request too large", kXMPErr_EnforceFailure );
+
+	ssize_t bytesWritten = pwrite ( refNum, buffer, count, (off_t)offset );
+	if ( bytesWritten != (ssize_t)count ) {
+		int osCode = errno;	// Capture ASAP and once, might not be thread safe.
+		if ( osCode == ENOSPC ) {
+			XMP_Throw ( "Host_IO::WriteAt, disk full", kXMPErr_DiskSpace );
+		} else {
+			XMP_Throw ( "Host_IO::WriteAt, pwrite failure", kXMPErr_WriteError );
+		}
+	}
+
+}	// Host_IO::WriteAt
+
+// =================================================================================================
+// Host_IO::CopyRange
+// ==================
+//
+// On Linux first try to clone the range with FICLONERANGE (btrfs, XFS), then copy_file_range. The
+// clone needs block aligned offsets, except that the range may end at the source EOF. Anything
+// else gets EINVAL and moves on to copy_file_range. The system call is used directly rather than
+// the glibc wrapper, which older libraries lack.
+
+XMP_Int64 Host_IO::CopyRange ( Host_IO::FileRef srcFile, XMP_Int64 srcOffset,
+							   Host_IO::FileRef dstFile, XMP_Int64 dstOffset, XMP_Int64 length )
+{
+	if ( length <= 0 ) return 0;
+
+	#if defined(__linux__)
+
+		#ifdef FICLONERANGE
+		{
+			struct file_clone_range cloneRange;
+			cloneRange.src_fd = srcFile;
+			cloneRange.src_offset = (XMP_Uns64)srcOffset;
+			cloneRange.src_length = (XMP_Uns64)length;
+			cloneRange.dest_offset = (XMP_Uns64)dstOffset;
+			if ( ioctl ( dstFile, FICLONERANGE, &cloneRange ) == 0 ) return length;
+		}
+		#endif
+
+		#ifdef SYS_copy_file_range
+		{
+			XMP_Int64 totalCopied = 0;
+			while ( totalCopied < length ) {
+				loff_t srcPos = (loff_t)(srcOffset + totalCopied);
+				loff_t dstPos = (loff_t)(dstOffset + totalCopied);
+				size_t ioCount = (size_t)(length - totalCopied);
+				if ( ioCount > 0x40000000 ) ioCount = 0x40000000;
+				long bytesCopied = syscall ( SYS_copy_file_range, srcFile, &srcPos, dstFile, &dstPos, ioCount, 0 );
+				if ( bytesCopied == -1 ) {
+					if ( errno == EINTR ) continue;
+					break;	// ENOSYS, EXDEV, EINVAL, ... let the caller copy the rest.
+				}
+				if ( bytesCopied == 0 ) break;	// Source EOF.
+				totalCopied += bytesCopied;
+			}
+			return totalCopied;
+		}
+		#endif
+
+	#endif
+
+	return 0;	// No host service, the caller does the copy.
+
+}	// Host_IO::CopyRange
+
+// =================================================================================================
+// Host_IO::CloneFile
+// ==================
+
+bool Host_IO::CloneFile ( Host_IO::FileRef srcFile, Host_IO::FileRef dstFile )
+{
+	#if defined(__linux__) && defined(FICLONE)
+		return (ioctl ( dstFile, FICLONE, srcFile ) == 0);
+	#else
+		return false;
+	#endif
+
+}	// Host_IO::CloneFile
+
 // =================================================================================================
 // Host_IO::Length
 // ===============
 
 XMP_Int64 Host_IO::Length ( Host_IO::FileRef refNum )
 {
-	off_t currPos = lseek ( refNum, 0, kXMP_SeekFromCurrent );
-	off_t length  = lseek ( refNum, 0, kXMP_SeekFromEnd );
-	if ( (currPos == -1) || (length == -1) ) XMP_Throw ( "Host_IO::Length, lseek failure", kXMPErr_ExternalFailure );
-	(void) lseek ( refNum, currPos, kXMP_SeekFromStart );
+	struct stat fileInfo;
+	int err = fstat ( refNum, &fileInfo );
+	if ( err != 0 ) XMP_Throw ( "Host_IO::Length, fstat failure", kXMPErr_ExternalFailure );
 
-	return length;
+	return fileInfo.st_size;
 
 }	// Host_IO::Length
 
@@ -407,6 +548,31 @@ void Host_IO::SetEOF ( Host_IO::FileRef refNum, XMP_Int64 length )
 
 }	// Host_IO::SetEOF
 
+// =================================================================================================
+// Host_IO::MapFile
+// ================
+
+void* Host_IO::MapFile ( Host_IO::FileRef refNum, XMP_Int64 length )
+{
+	if ( (length <= 0) || ((XMP_Uns64)length > (XMP_Uns64)(size_t)(-1)) ) return 0;
+
+	void* mapAddr = mmap ( 0, (size_t)length, (PROT_READ | PROT_WRITE), MAP_PRIVATE, refNum, 0 );
+	if ( mapAddr == MAP_FAILED ) return 0;
+
+	return mapAddr;
+
+}	// Host_IO::MapFile
+
+// =================================================================================================
+// Host_IO::UnmapFile
+// ==================
+
+void Host_IO::UnmapFile ( void* mapAddr, XMP_Int64 length )
+{
+	if ( mapAddr != 0 ) (void) munmap ( mapAddr, (size_t)length );
+
+}	// Host_IO::UnmapFile
+
 // =================================================================================================
 // =====================================   Folder operations   =====================================
 // =================================================================================================
@@ -192,6 +192,35 @@ bool Host_IO::GetModifyDate ( const char* filePath, XMP_DateTime * modifyDate )
 
 }	// Host_IO::GetModifyDate
 
+// =================================================================================================
+// Host_IO::GetFileIdentity
+// ========================
+
+bool Host_IO::GetFileIdentity ( const char* filePath, FileIdentity* identity )
+{
+	BOOL ok;
+	Host_IO::FileRef fileHandle;
+
+	try {	// Host_IO::Open should not throw - fix after CS6.
+		fileHandle = Host_IO::Open ( filePath, Host_IO::openReadOnly );
+		if ( fileHandle == Host_IO::noFileRef ) return false;
+	} catch ( ... ) {
+		return false;
+	}
+
+	BY_HANDLE_FILE_INFORMATION info;
+	ok = GetFileInformationByHandle ( fileHandle, &info );
+	Host_IO::Close ( fileHandle );
+	if ( ! ok ) return false;
+
+	identity->device = info.dwVolumeSerialNumber;
+	identity->fileNumber = ((XMP_Uns64)info.nFileIndexHigh << 32) | info.nFileIndexLow;
+	identity->length = ((XMP_Int64)info.nFileSizeHigh << 32) | info.nFileSizeLow;
+	identity->modifyTime = ((XMP_Int64)info.ftLastWriteTime.dwHighDateTime << 32) | info.ftLastWriteTime.dwLowDateTime;
+	return true;
+
+}	// Host_IO::GetFileIdentity
+
 // =================================================================================================
 // ConjureDerivedPath
 // ==================
@@ -407,6 +436,79 @@ void Host_IO::Write ( Host_IO::FileRef fileHandle, const void * buffer, XMP_Uns3
 
 }	// Host_IO::Write
 
+// =================================================================================================
+// Host_IO::ReadAt
+// ===============
+//
+// ! The handles are opened for synchronous I/O, ReadFile with an OVERLAPPED offset still blocks and
+// ! moves the file pointer past the data. That is allowed, callers must not rely on the pointer.
+
+XMP_Uns32 Host_IO::ReadAt ( Host_IO::FileRef fileHandle, XMP_Int64 offset, void * buffer, XMP_Uns32 count )
+{
+	if ( count >= TwoGB ) XMP_Throw ( "Host_IO::ReadAt, request too large", kXMPErr_EnforceFailure );
+
+	OVERLAPPED position;
+	ZeroMemory ( &position, sizeof(position) );
+	position.Offset = (DWORD)offset;
+	position.OffsetHigh = (DWORD)(offset >> 32);
+
+	DWORD bytesRead = 0;
+	BOOL ok = ReadFile ( fileHandle, buffer, count, &bytesRead, &position );
+	if ( (! ok) && (GetLastError() != ERROR_HANDLE_EOF) ) XMP_Throw ( "Host_IO::ReadAt, ReadFile failure", kXMPErr_ReadError );
+
+	return bytesRead;
+
+}	// Host_IO::ReadAt
+
+// =================================================================================================
+// Host_IO::WriteAt
+// ================
+
+void Host_IO::WriteAt ( Host_IO::FileRef fileHandle, XMP_Int64 offset, const void * buffer, XMP_Uns32 count )
+{
+	if ( count >= TwoGB ) XMP_Throw ( "Host_IO::WriteAt, request too large", kXMPErr_EnforceFailure );
+
+	OVERLAPPED position;
+	ZeroMemory ( &position, sizeof(position) );
+	position.Offset = (DWORD)offset;
+	position.OffsetHigh = (DWORD)(offset >> 32);
+
+	DWORD bytesWritten = 0;
+	BOOL ok = WriteFile ( fileHandle, buffer, count, &bytesWritten, &position );
+	if ( (! ok) || (bytesWritten != count) ) {
+		DWORD osCode = GetLastError();
+		if ( osCode == ERROR_DISK_FULL ) {
+			XMP_Throw ( "Host_IO::WriteAt, disk full", kXMPErr_DiskSpace );
+		} else {
+			XMP_Throw ( "Host_IO::WriteAt, WriteFile failure", kXMPErr_WriteError );
+		}
+	}
+
+}	// Host_IO::WriteAt
+
+// =================================================================================================
+// Host_IO::CopyRange
+// ==================
+//
+// *** Could use FSCTL_DUPLICATE_EXTENTS_TO_FILE on ReFS, for now the caller always does the copy.
+
+XMP_Int64 Host_IO::CopyRange ( Host_IO::FileRef /*srcFile*/, XMP_Int64 /*srcOffset*/,
+							   Host_IO::FileRef /*dstFile*/, XMP_Int64 /*dstOffset*/, XMP_Int64 /*length*/ )
+{
+	return 0;
+
+}	// Host_IO::CopyRange
+
+// =================================================================================================
+// Host_IO::CloneFile
+// ==================
+
+bool Host_IO::CloneFile ( Host_IO::FileRef /*srcFile*/, Host_IO::FileRef /*dstFile*/ )
+{
+	return false;
+
+}	// Host_IO::CloneFile
+
 // =================================================================================================
 // Host_IO::Length
 // ===============
@@ -437,6 +539,35 @@ void Host_IO::SetEOF ( Host_IO::FileRef fileHandle, XMP_Int64 length )
 
 }	// Host_IO::SetEOF
 
+// =================================================================================================
+// Host_IO::MapFile
+// ================
+
+void* Host_IO::MapFile ( Host_IO::FileRef fileHandle, XMP_Int64 length )
+{
+	if ( (length <= 0) || ((XMP_Uns64)length > (XMP_Uns64)(SIZE_T)(-1)) ) return 0;
+
+	HANDLE mapHandle = CreateFileMappingW ( fileHandle, 0, PAGE_WRITECOPY, 0, 0, 0 );
+	if ( mapHandle == 0 ) return 0;
+
+	// ! The view keeps the mapping object alive, the handle can be closed right away.
+	void* mapAddr = MapViewOfFile ( mapHandle, FILE_MAP_COPY, 0, 0, (SIZE_T)length );
+	CloseHandle ( mapHandle );
+
+	return mapAddr;
+
+}	// Host_IO::MapFile
+
+// =================================================================================================
+// Host_IO::UnmapFile
+// ==================
+
+void Host_IO::UnmapFile ( void* mapAddr, XMP_Int64 /* length */ )
+{
+	if ( mapAddr != 0 ) (void) UnmapViewOfFile ( mapAddr );
+
+}	// Host_IO::UnmapFile
+
 // =================================================================================================
 // Folder operations
 // =================================================================================================
@@ -54,6 +54,10 @@ namespace Host_IO {
 	// GetModifyDate - Return the file system modification date. Returns false if the file or folder
 	// does not exist.
 	//
+	// GetFileIdentity - Return what the file system says identifies a file or folder in its current
+	// state: the device and file number, the length, and a host-specific modification time. Returns
+	// false if the path does not exist or the host can't tell. Never throws an exception.
+	//
 	// CreateTemp - Create a (presumably) temporary file related to some other file. The source
 	// file path is passed in, a derived name is selected in the same folder. The source file need
 	// not exist, but all folders in the path must exist. The derived name is guaranteed to not
@@ -90,11 +94,39 @@ namespace Host_IO {
 	// Write - Write from a buffer. Requests are limited to less than 2GB in case the host uses an
 	// SInt32 count. Throws an XMP_Error exception for any errors.
 	//
+	// ReadAt - Read into a buffer from an absolute offset, returning the number of bytes read. Only
+	// returns less than count at EOF. Does not use the I/O position, and may leave it anywhere.
+	// Reads from different threads may overlap, as long as nothing changes the file meanwhile.
+	// Requests are limited to less than 2GB. Throws an XMP_Error exception for errors.
+	//
+	// WriteAt - Write from a buffer to an absolute offset. Like ReadAt it does not use the I/O
+	// position, and may leave it anywhere. Requests are limited to less than 2GB. Throws an
+	// XMP_Error exception for any errors.
+	//
+	// CopyRange - Copy a byte range between two open files inside the host, without passing the
+	// data through a user buffer. Shares the storage (reflink) if the file system allows it,
+	// otherwise uses a kernel side copy. Returns the number of bytes copied, which can be anything
+	// from 0 to length. A short count is not an error, the caller must copy the rest itself, and 0
+	// is returned if the host has no such service or it does not work for these files. Like ReadAt
+	// and WriteAt the I/O positions are not used. The ranges must not overlap. Never throws.
+	//
+	// CloneFile - Replace the contents of the destination file with a reflink clone of the whole
+	// source file, sharing the storage until either file is changed. Returns false if the host or
+	// file system can't do this, the destination is then unchanged. Never throws.
+	//
 	// Length - Returns the length of an open file in bytes. The I/O position is not changed.
 	// Throws an XMP_Error exception for any errors.
 	//
 	// SetEOF - Sets a new EOF offset. The I/O position may be changed. Throws an XMP_Error
 	// exception for any errors.
+	//
+	// MapFile - Map the first length bytes of an open file into memory. The mapping is private
+	// and copy-on-write, changes made through it never reach the file, which lets in-place parsers
+	// byte swap the data. Returns 0 if the file can't be mapped, for example because it is empty,
+	// is not a regular file, or is too big for the address space. Never throws an exception. The
+	// mapping stays valid after the file is closed.
+	//
+	// UnmapFile - Release a mapping made by MapFile, passing the same length. Never throws.
 
 	#if XMP_WinBuild
 		typedef HANDLE FileRef;
@@ -115,6 +147,16 @@ namespace Host_IO {
 	
 	bool GetModifyDate ( const char* filePath, XMP_DateTime* modifyDate );
 
+	struct FileIdentity {
+		XMP_Uns64 device;
+		XMP_Uns64 fileNumber;
+		XMP_Int64 length;
+		XMP_Int64 modifyTime;
+		FileIdentity() : device(0), fileNumber(0), length(0), modifyTime(0) {};
+	};
+
+	bool GetFileIdentity ( const char* filePath, FileIdentity* identity );
+
 	std::string CreateTemp ( const char* sourcePath );
 
 	enum { openReadOnly = true, openReadWrite = false };
@@ -129,9 +171,16 @@ namespace Host_IO {
 	XMP_Int64	Seek     ( FileRef file, XMP_Int64 offset, SeekMode mode );
 	XMP_Uns32	Read     ( FileRef file, void* buffer, XMP_Uns32 count );
 	void		Write    ( FileRef file, const void* buffer, XMP_Uns32 count );
+	XMP_Uns32	ReadAt   ( FileRef file, XMP_Int64 offset, void* buffer, XMP_Uns32 count );
+	void		WriteAt  ( FileRef file, XMP_Int64 offset, const void* buffer, XMP_Uns32 count );
+	XMP_Int64	CopyRange ( FileRef srcFile, XMP_Int64 srcOffset, FileRef dstFile, XMP_Int64 dstOffset, XMP_Int64 length );
+	bool		CloneFile ( FileRef srcFile, FileRef dstFile );
 	XMP_Int64	Length   ( FileRef file );
 	void		SetEOF   ( FileRef file, XMP_Int64 length );
 
+	void*	MapFile   ( FileRef file, XMP_Int64 length );
+	void	UnmapFile ( void* mapAddr, XMP_Int64 length );
+
 	inline XMP_Int64 Offset ( FileRef file ) { return Host_IO::Seek ( file, 0, kXMP_SeekFromCurrent ); };
 	inline XMP_Int64 Rewind ( FileRef file ) { return Host_IO::Seek ( file, 0, kXMP_SeekFromStart ); };	// Always returns 0.
 	inline XMP_Int64 ToEOF  ( FileRef file ) { return Host_IO::Seek ( file, 0, kXMP_SeekFromEnd ); };
@@ -13,6 +13,7 @@
 #include "public/include/XMP_IO.hpp"
 
 #include "source/XIO.hpp"
+#include "source/XMPFiles_IO.hpp"
 #include "source/XMP_LibUtils.hpp"
 #include "source/UnicodeConversions.hpp"
 
@@ -149,6 +150,9 @@ void XIO::ReplaceTextFile ( XMP_IO* textFile, const std::string & newContent, bo
 // =================================================================================================
 // XIO::Copy
 // =========
+//
+// When both sides are local files the host is asked to do the copy, in large pieces so the abort
+// proc is still checked now and then. The buffer loop takes over if the host copy comes up short.
 
 void XIO::Copy ( XMP_IO* sourceFile, XMP_IO* destFile, XMP_Int64 length,
 				 XMP_AbortProc abortProc /* = 0 */, void* abortArg /* = 0 */ )
@@ -156,12 +160,25 @@ void XIO::Copy ( XMP_IO* sourceFile, XMP_IO* destFile, XMP_Int64 length,
 	const bool checkAbort = (abortProc != 0);
 	XMP_Uns8 buffer [64*1024];
 
+	XMPFiles_IO * hostSource = dynamic_cast<XMPFiles_IO*> ( sourceFile );
+	XMPFiles_IO * hostDest   = dynamic_cast<XMPFiles_IO*> ( destFile );
+
 	while ( length > 0 ) {
 
 		if ( checkAbort && abortProc(abortArg) ) {
 			XMP_Throw ( "XIO::Copy, user abort", kXMPErr_UserAbort );
 		}
 
+		if ( (hostSource != 0) && (hostDest != 0) ) {
+			XMP_Int64 hostCount = 64*1024*1024;
+			if ( length < hostCount ) hostCount = length;
+			XMP_Int64 amountCopied = hostDest->CopyFrom ( hostSource, hostCount );
+			length -= amountCopied;
+			if ( amountCopied == hostCount ) continue;
+			hostSource = hostDest = 0;	// Short, finish with the buffer loop.
+			if ( length == 0 ) break;
+		}
+
 		XMP_Int32 ioCount = sizeof(buffer);
 		if ( length < ioCount ) ioCount = (XMP_Int32)length;
 
@@ -192,6 +209,15 @@ void XIO::Move ( XMP_IO* srcFile, XMP_Int64 srcOffset,
 
 	const bool checkAbort = (abortProc != 0);
 
+	if ( (srcFile != dstFile) &&
+		 (dynamic_cast<XMPFiles_IO*> ( srcFile ) != 0) && (dynamic_cast<XMPFiles_IO*> ( dstFile ) != 0) ) {
+		// Different local files can't shadow each other, let XIO::Copy use the host copy.
+		srcFile->Seek ( srcOffset, kXMP_SeekFromStart );
+		dstFile->Seek ( dstOffset, kXMP_SeekFromStart );
+		XIO::Copy ( srcFile, dstFile, length, abortProc, abortArg );
+		return;
+	}
+
 	if ( srcOffset > dstOffset ) {	// avoiding shadow effects
 
 	// move down -> shift lowest packet first !
@@ -26,6 +26,7 @@
 // The overall parsing would be faster and use less memory if the RDF recognition were done on the
 // fly using a state machine. But it was much easier to write the recursive descent version. The
 // current implementation is pretty fast in absolute terms, so being faster might not be crucial.
+// The XMPCore kXMP_ParseStreaming option does the recognition on the fly, see XML_EventReceiver.
 //
 // Like the XMP tree, the XML tree contains vectors of pointers for down links, and offspring have
 // a pointer to their parent. Unlike the XMP tree, this is an exact XML document tree. There are no
@@ -103,6 +104,50 @@ private:
 
 };
 
+// =================================================================================================
+// Block storage for the nodes of an XML tree that is built once and then discarded as a whole. The
+// nodes are destroyed together by Release, not by their parents, so a tree using an arena must not
+// be edited. The node strings and vectors are still ordinary heap storage.
+
+class XML_NodeArena {
+public:
+
+	XML_NodePtr NewNode ( XML_NodePtr parent, XMP_StringPtr name, XMP_Uns8 kind );
+	void Clear();	// Delete the nodes but keep some of the blocks for reuse.
+	void Release();
+
+	size_t NodeCount() const { return this->nodeCount; };
+
+	XML_NodeArena() : nodeCount(0) {};
+	~XML_NodeArena() { this->Release(); };
+
+private:
+
+	enum { kNodesPerBlock = 64, kMaxKeptBlocks = 16 };
+
+	std::vector<XML_NodePtr> blocks;
+	size_t nodeCount;
+
+};
+
+// =================================================================================================
+// Optional receiver of the XML parse events. When an adapter has one it does not build the XML tree,
+// the elements are passed to the receiver as they are parsed. The element node and its attributes
+// are reused for the next element, the receiver must copy anything it wants to keep. Comments and
+// PIs other than the XMP packet wrapper are dropped, as they are from the tree.
+
+class XML_EventReceiver {
+public:
+
+	virtual void StartElement ( const XML_Node & elemNode ) = 0;
+	virtual void EndElement() = 0;
+	virtual void CharacterData ( XMP_StringPtr cData, size_t len ) = 0;
+	virtual void ProcessingInstruction ( XMP_StringPtr target, XMP_StringPtr data ) = 0;
+
+	virtual ~XML_EventReceiver() {};
+
+};
+
 // =================================================================================================
 // Abstract base class for XML parser adapters used by the XMP toolkit.
 
@@ -113,14 +158,43 @@ public:
 
 	XMLParserAdapter() : tree(0,"",kRootNode), rootNode(0), rootCount(0),
 	                     charEncoding(XMP_OptionBits(-1)), pendingCount(0),
-	                     errorCallback(0)
+	                     errorCallback(0), eventReceiver(0), nodeArena(0)
 	{
 		#if XMP_DebugBuild
 			parseLog = 0;
 		#endif
 	};
 
-	virtual ~XMLParserAdapter() {};
+	virtual ~XMLParserAdapter()
+	{
+		delete this->eventReceiver;
+		if ( this->nodeArena != 0 ) {
+			this->tree.content.clear();	// ! The tree nodes are owned by the arena.
+			delete this->nodeArena;
+		}
+	};
+
+	// Return the adapter to its just constructed state so it can parse another document. The node
+	// arena is kept, the event receiver and error callback are dropped. Returns false if the adapter
+	// can't be reused, it must then be deleted.
+	virtual bool Reset()
+	{
+		delete this->eventReceiver;
+		this->eventReceiver = 0;
+		if ( this->nodeArena != 0 ) {
+			this->tree.content.clear();	// ! The tree nodes are owned by the arena.
+			this->nodeArena->Clear();
+		}
+		this->tree.ClearNode();
+		this->tree.kind = kRootNode;
+		this->parseStack.clear();
+		this->rootNode = 0;
+		this->rootCount = 0;
+		this->charEncoding = XMP_OptionBits(-1);
+		this->pendingCount = 0;
+		this->errorCallback = 0;
+		return true;
+	};
 	
 	virtual void ParseBuffer ( const void * buffer, size_t length, bool last ) = 0;
 	
@@ -143,6 +217,8 @@ public:
 	unsigned char	pendingInput[kXMLPendingInputMax];	// Buffered input for character encoding checks.
 
 	GenericErrorCallback * errorCallback;	// Set if the relevant XMPCore or XMPFiles object has one.
+	XML_EventReceiver * eventReceiver;	// Owned by the adapter. Set before parsing to not build the tree.
+	XML_NodeArena * nodeArena;	// Owned by the adapter. Set before parsing to allocate the tree nodes together.
 
 	#if XMP_DebugBuild
 		FILE * parseLog;
@@ -10,6 +10,7 @@
 #include "source/XMLParserAdapter.hpp"
 
 #include <map>
+#include <new>
 #include <cstring>
 #include <cstdio>
 
@@ -471,3 +472,57 @@ void XML_Node::ClearNode()
 }	// XML_Node::ClearNode
 
 // =================================================================================================
+// XML_NodeArena::NewNode
+//=======================
+
+XML_NodePtr XML_NodeArena::NewNode ( XML_NodePtr parent, XMP_StringPtr name, XMP_Uns8 kind )
+{
+	size_t blockNum = this->nodeCount / kNodesPerBlock;
+	size_t slot = this->nodeCount % kNodesPerBlock;
+
+	if ( blockNum == this->blocks.size() ) {
+		void * block = ::operator new ( kNodesPerBlock * sizeof(XML_Node) );
+		this->blocks.push_back ( (XML_NodePtr)block );
+	}
+
+	XML_NodePtr node = new ( &this->blocks[blockNum][slot] ) XML_Node ( parent, name, kind );
+	++this->nodeCount;
+	return node;
+
+}	// XML_NodeArena::NewNode
+
+// =================================================================================================
+// XML_NodeArena::Clear
+//=====================
+
+void XML_NodeArena::Clear()
+{
+
+	for ( size_t i = 0; i < this->nodeCount; ++i ) {
+		XML_NodePtr node = &this->blocks[i/kNodesPerBlock][i%kNodesPerBlock];
+		node->attrs.clear();	// ! The children are in the arena too, don't let the destructor delete them.
+		node->content.clear();
+		node->~XML_Node();
+	}
+	this->nodeCount = 0;
+
+	for ( size_t i = kMaxKeptBlocks, vLim = this->blocks.size(); i < vLim; ++i ) ::operator delete ( this->blocks[i] );
+	if ( this->blocks.size() > kMaxKeptBlocks ) this->blocks.resize ( kMaxKeptBlocks );
+
+}	// XML_NodeArena::Clear
+
+// =================================================================================================
+// XML_NodeArena::Release
+//=======================
+
+void XML_NodeArena::Release()
+{
+
+	this->Clear();
+
+	for ( size_t i = 0, vLim = this->blocks.size(); i < vLim; ++i ) ::operator delete ( this->blocks[i] );
+	this->blocks.clear();
+
+}	// XML_NodeArena::Release
+
+// =================================================================================================
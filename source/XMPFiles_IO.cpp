@@ -16,6 +16,8 @@
 #include "source/XMPFiles_IO.hpp"
 #include "source/XIO.hpp"
 
+#include <cstring>
+
 
 #define EMPTY_FILE_PATH ""
 #define XMP_FILESIO_STATIC_START try { /* int a;*/
@@ -44,6 +46,13 @@
 	XMP_FILESIO_STATIC_NOTIFY_ERROR(errorCallback, (filePath), (severity), (error))
 
 
+// =================================================================================================
+
+static XMP_Uns32 sDefaultCachePageSize  = XMPFiles_IO::kDefaultCachePageSize;
+static XMP_Uns32 sDefaultCachePageCount = XMPFiles_IO::kDefaultCachePageCount;
+
+static XMPFiles_IO::CloneFileProc sCloneFileProc = Host_IO::CloneFile;
+
 // =================================================================================================
 // XMPFiles_IO::New_XMPFiles_IO
 // ============================
@@ -73,8 +82,6 @@ XMPFiles_IO * XMPFiles_IO::New_XMPFiles_IO (
 		return 0;
 	}
 
-	Host_IO::Rewind ( hostFile );	// Make sure offset really is 0.
-
 	XMPFiles_IO * newFile = new XMPFiles_IO ( hostFile, filePath, readOnly, _errorCallback, _progressTracker );
 	return newFile;
 	XMP_FILESIO_STATIC_END1 ( _errorCallback, filePath, kXMPErrSev_FileFatal )
@@ -100,11 +107,16 @@ XMPFiles_IO::XMPFiles_IO (
 	, derivedTemp(0)
 	, progressTracker(_progressTracker)
 	, errorCallback(_errorCallback)
+	, cachePageSize(0)
+	, cacheClock(0)
+	, writeBufferSize(_readOnly ? 0 : (XMP_Uns32)kDefaultWriteBufferSize)
+	, writeOffset(0)
 {
 	XMP_FILESIO_START
 	XMP_Assert ( this->fileRef != Host_IO::noFileRef );
 
 	this->currLength = Host_IO::Length ( this->fileRef );
+	this->SetReadCache ( sDefaultCachePageSize, sDefaultCachePageCount );
 	XMP_FILESIO_END2 ( _filePath, kXMPErrSev_FileFatal )
 }	// XMPFiles_IO::XMPFiles_IO
 
@@ -117,6 +129,7 @@ XMPFiles_IO::~XMPFiles_IO()
 	try {
 		XMP_FILESIO_START
 		if ( this->derivedTemp != 0 ) this->DeleteTemp();
+		if ( ! this->isTemp ) this->FlushWrites();
 		if ( this->fileRef != Host_IO::noFileRef ) Host_IO::Close ( this->fileRef );
 		if ( this->isTemp && (! this->filePath.empty()) ) Host_IO::Delete ( this->filePath.c_str() );
 		XMP_FILESIO_END1 ( kXMPErrSev_Recoverable )
@@ -145,8 +158,7 @@ XMP_Uns32 XMPFiles_IO::Read ( void * buffer, XMP_Uns32 count, bool readAll /* =
 {
 	XMP_FILESIO_START
 	XMP_Assert ( this->fileRef != Host_IO::noFileRef );
-	XMP_Assert ( this->currOffset == Host_IO::Offset ( this->fileRef ) );
-	XMP_Assert ( this->currLength == Host_IO::Length ( this->fileRef ) );
+	XMP_Assert ( (! this->writeBuffer.empty()) || (this->currLength == Host_IO::Length ( this->fileRef )) );
 	XMP_Assert ( this->currOffset <= this->currLength );
 
 	if ( count > (this->currLength - this->currOffset) ) {
@@ -154,7 +166,17 @@ XMP_Uns32 XMPFiles_IO::Read ( void * buffer, XMP_Uns32 count, bool readAll /* =
 		count = (XMP_Uns32) (this->currLength - this->currOffset);
 	}
 
-	XMP_Uns32 amountRead = Host_IO::Read ( this->fileRef, buffer, count );
+	this->FlushWrites();	// ! The cache and host reads must see the pending data.
+
+	XMP_Uns32 amountRead;
+	if ( this->mapping.get() != 0 ) {
+		memcpy ( buffer, (this->mapping.get() + this->currOffset), count );	// AUDIT: Safe, count is clipped to EOF.
+		amountRead = count;
+	} else if ( count < this->cachePageSize ) {
+		amountRead = this->ReadCached ( buffer, count );
+	} else {
+		amountRead = Host_IO::ReadAt ( this->fileRef, this->currOffset, buffer, count );
+	}
 	XMP_Enforce ( amountRead == count );
 
 	this->currOffset += amountRead;
@@ -172,22 +194,42 @@ void XMPFiles_IO::Write ( const void * buffer, XMP_Uns32 count )
 {
 	XMP_FILESIO_START
 	XMP_Assert ( this->fileRef != Host_IO::noFileRef );
-	XMP_Assert ( this->currOffset == Host_IO::Offset ( this->fileRef ) );
-	XMP_Assert ( this->currLength == Host_IO::Length ( this->fileRef ) );
+	XMP_Assert ( (! this->writeBuffer.empty()) || (this->currLength == Host_IO::Length ( this->fileRef )) );
 	XMP_Assert ( this->currOffset <= this->currLength );
 
 	try {
 		if ( this->readOnly )
 			XMP_Throw ( "New_XMPFiles_IO, write not permitted on read only file", kXMPErr_FilePermission );
-		Host_IO::Write ( this->fileRef, buffer, count );
+		this->InvalidateCache ( this->currOffset, count );
+
+		size_t pendingCount = this->writeBuffer.size();
+		if ( (pendingCount != 0) &&
+			 ((this->currOffset != (this->writeOffset + (XMP_Int64)pendingCount)) ||
+			  ((pendingCount + count) > this->writeBufferSize)) ) {
+			this->FlushWrites();	// Not contiguous, or no room.
+		}
+
+		if ( count >= this->writeBufferSize ) {
+			Host_IO::WriteAt ( this->fileRef, this->currOffset, buffer, count );
+		} else {
+			if ( this->writeBuffer.empty() ) {
+				this->writeBuffer.reserve ( this->writeBufferSize );
+				this->writeOffset = this->currOffset;
+			}
+			const XMP_Uns8 * bytePtr = (const XMP_Uns8*)buffer;
+			this->writeBuffer.insert ( this->writeBuffer.end(), bytePtr, (bytePtr + count) );
+		}
+
 		if ( this->progressTracker != 0 ) this->progressTracker->AddWorkDone ( (float) count );
 	} catch ( ... ) {
 		try {
 			// we should try to maintain the state as best as possible
 			// but no exception should escape from this backup plan.
-			// Make sure the internal state reflects partial writes.
-			this->currOffset = Host_IO::Offset ( this->fileRef );
+			// Make sure the internal state reflects partial writes. The offset is left alone, a
+			// positional write does not move it.
+			this->writeBuffer.clear();
 			this->currLength = Host_IO::Length ( this->fileRef );
+			if ( this->currOffset > this->currLength ) this->currOffset = this->currLength;
 		} catch ( ... ) {
 			// don't do anything
 		}
@@ -208,8 +250,7 @@ XMP_Int64 XMPFiles_IO::Seek ( XMP_Int64 offset, SeekMode mode )
 {
 	XMP_FILESIO_START
 	XMP_Assert ( this->fileRef != Host_IO::noFileRef );
-	XMP_Assert ( this->currOffset == Host_IO::Offset ( this->fileRef ) );
-	XMP_Assert ( this->currLength == Host_IO::Length ( this->fileRef ) );
+	XMP_Assert ( (! this->writeBuffer.empty()) || (this->currLength == Host_IO::Length ( this->fileRef )) );
 
 	XMP_Int64 newOffset = offset;
 	if ( mode == kXMP_SeekFromCurrent ) {
@@ -219,14 +260,19 @@ XMP_Int64 XMPFiles_IO::Seek ( XMP_Int64 offset, SeekMode mode )
 	}
 	XMP_Enforce ( newOffset >= 0 );
 
+	// ! The host file position is never used, all host I/O is positional.
+
+	if ( newOffset != this->currOffset ) this->FlushWrites();	// ! Offset() must not flush.
+
 	if ( newOffset <= this->currLength ) {
-		this->currOffset = Host_IO::Seek ( this->fileRef, offset, mode );
+		this->currOffset = newOffset;
 	} else if ( this->readOnly ) {
 		XMP_Throw ( "XMPFiles_IO::Seek, read-only seek beyond EOF", kXMPErr_EnforceFailure );
 	} else {
+		this->InvalidateCache ( this->currLength, (newOffset - this->currLength) );
 		Host_IO::SetEOF ( this->fileRef, newOffset );	// Extend a file open for writing.
 		this->currLength = newOffset;
-		this->currOffset = Host_IO::Seek ( this->fileRef, 0, kXMP_SeekFromEnd );
+		this->currOffset = newOffset;
 	}
 
 	XMP_Assert ( this->currOffset == newOffset );
@@ -244,8 +290,7 @@ XMP_Int64 XMPFiles_IO::Length()
 {
 	XMP_FILESIO_START
 	XMP_Assert ( this->fileRef != Host_IO::noFileRef );
-	XMP_Assert ( this->currOffset == Host_IO::Offset ( this->fileRef ) );
-	XMP_Assert ( this->currLength == Host_IO::Length ( this->fileRef ) );
+	XMP_Assert ( (! this->writeBuffer.empty()) || (this->currLength == Host_IO::Length ( this->fileRef )) );
 	XMP_FILESIO_END1 ( kXMPErrSev_FileFatal )
 	return this->currLength;
 
@@ -259,21 +304,18 @@ void XMPFiles_IO::Truncate ( XMP_Int64 length )
 {
 	XMP_FILESIO_START
 	XMP_Assert ( this->fileRef != Host_IO::noFileRef );
-	XMP_Assert ( this->currOffset == Host_IO::Offset ( this->fileRef ) );
-	XMP_Assert ( this->currLength == Host_IO::Length ( this->fileRef ) );
+	XMP_Assert ( (! this->writeBuffer.empty()) || (this->currLength == Host_IO::Length ( this->fileRef )) );
 
 	if ( this->readOnly )
 		XMP_Throw ( "New_XMPFiles_IO, truncate not permitted on read only file", kXMPErr_FilePermission );
 
 	XMP_Enforce ( length <= this->currLength );
+	this->FlushWrites();
+	this->InvalidateCache ( length, -1 );
 	Host_IO::SetEOF ( this->fileRef, length );
 
 	this->currLength = length;
 	if ( this->currOffset > this->currLength ) this->currOffset = this->currLength;
-
-	// ! Seek to the expected offset, some versions of Host_IO::SetEOF implicitly seek to EOF.
-	Host_IO::Seek ( this->fileRef, this->currOffset, kXMP_SeekFromStart );
-	XMP_Assert ( this->currOffset == Host_IO::Offset ( this->fileRef ) );
 	XMP_FILESIO_END1 ( kXMPErrSev_FileFatal )
 
 }	// XMPFiles_IO::Truncate
@@ -313,6 +355,43 @@ XMP_IO* XMPFiles_IO::DeriveTemp()
 
 }	// XMPFiles_IO::DeriveTemp
 
+// =================================================================================================
+// XMPFiles_IO::CloneToTemp
+// ========================
+
+bool XMPFiles_IO::CloneToTemp()
+{
+	XMPFiles_IO * temp = (XMPFiles_IO*) this->DeriveTemp();
+	XMP_Assert ( temp != 0 );	// DeriveTemp throws on failure.
+
+	XMP_FILESIO_START
+	XMP_Assert ( temp->fileRef != Host_IO::noFileRef );
+
+	this->FlushWrites();
+	temp->FlushWrites();
+	if ( ! sCloneFileProc ( this->fileRef, temp->fileRef ) ) return false;
+
+	temp->InvalidateCache();
+	temp->currLength = Host_IO::Length ( temp->fileRef );
+	temp->currOffset = 0;
+	XMP_Assert ( temp->currLength == this->currLength );
+	return true;
+	XMP_FILESIO_END2 ( temp->filePath.c_str(), kXMPErrSev_FileFatal )
+	return false;
+
+}	// XMPFiles_IO::CloneToTemp
+
+// =================================================================================================
+// XMPFiles_IO::SetCloneFileProc
+// =============================
+
+/* class static */
+void XMPFiles_IO::SetCloneFileProc ( CloneFileProc cloneProc )
+{
+	sCloneFileProc = (cloneProc != 0) ? cloneProc : Host_IO::CloneFile;
+
+}	// XMPFiles_IO::SetCloneFileProc
+
 // =================================================================================================
 // XMPFiles_IO::AbsorbTemp
 // =======================
@@ -334,6 +413,7 @@ void XMPFiles_IO::AbsorbTemp()
 	Host_IO::SwapData ( this->filePath.c_str(), temp->filePath.c_str() );
 	this->DeleteTemp();
 
+	this->InvalidateCache();
 	this->fileRef = Host_IO::Open ( this->filePath.c_str(), Host_IO::openReadWrite );
 	this->currLength = Host_IO::Length ( this->fileRef );
 	this->currOffset = 0;
@@ -352,6 +432,8 @@ void XMPFiles_IO::DeleteTemp()
 
 	if ( temp != 0 ) {
 
+		temp->writeBuffer.clear();	// ! The temp is going away, don't bother writing.
+
 		if ( temp->fileRef != Host_IO::noFileRef ) {
 			Host_IO::Close ( temp->fileRef );
 			temp->fileRef = Host_IO::noFileRef;
@@ -378,11 +460,306 @@ void XMPFiles_IO::Close()
 {
 	XMP_FILESIO_START
 	if ( this->fileRef != Host_IO::noFileRef ) {
+		this->FlushWrites();
 		Host_IO::Close ( this->fileRef );
 		this->fileRef = Host_IO::noFileRef;
 	}
+	this->InvalidateCache();
+	this->mapping.reset();	// ! Handlers might still hold references to the mapping.
 	XMP_FILESIO_END1 ( kXMPErrSev_FileFatal )
 
 }	// XMPFiles_IO::Close
 
 // =================================================================================================
+// XMPFiles_IO::ReadAt
+// ===================
+//
+// ! Must not touch any member that Read changes, concurrent callers rely on that. The cache is
+// ! bypassed for the same reason, currLength is only changed by writes.
+
+XMP_Uns32 XMPFiles_IO::ReadAt ( XMP_Int64 offset, void * buffer, XMP_Uns32 count ) const
+{
+	XMP_FILESIO_START
+	XMP_Assert ( this->fileRef != Host_IO::noFileRef );
+	XMP_Enforce ( offset >= 0 );
+
+	if ( offset >= this->currLength ) return 0;
+	if ( count > (this->currLength - offset) ) count = (XMP_Uns32) (this->currLength - offset);
+
+	if ( this->mapping.get() != 0 ) {
+		memcpy ( buffer, (this->mapping.get() + offset), count );	// AUDIT: Safe, count is clipped to EOF.
+		return count;
+	}
+
+	XMP_Uns32 amountRead = Host_IO::ReadAt ( this->fileRef, offset, buffer, count );
+
+	if ( ! this->writeBuffer.empty() ) {
+		// Overlay the pending writes. The host file has everything before them, so together they
+		// cover the whole clipped request.
+		XMP_Int64 overlapStart = offset;
+		XMP_Int64 overlapEnd = offset + count;
+		XMP_Int64 pendingEnd = this->writeOffset + (XMP_Int64)this->writeBuffer.size();
+		if ( overlapStart < this->writeOffset ) overlapStart = this->writeOffset;
+		if ( overlapEnd > pendingEnd ) overlapEnd = pendingEnd;
+		if ( overlapStart < overlapEnd ) {
+			memcpy ( ((XMP_Uns8*)buffer + (overlapStart - offset)),
+					 &this->writeBuffer[(size_t)(overlapStart - this->writeOffset)],
+					 (size_t)(overlapEnd - overlapStart) );	// AUDIT: Safe, within both ranges.
+			if ( amountRead < (XMP_Uns32)(overlapEnd - offset) ) amountRead = (XMP_Uns32)(overlapEnd - offset);
+		}
+	}
+
+	return amountRead;
+	XMP_FILESIO_END1 ( kXMPErrSev_FileFatal )
+	return 0;
+
+}	// XMPFiles_IO::ReadAt
+
+// =================================================================================================
+// XMPFiles_IO::CopyFrom
+// =====================
+
+XMP_Int64 XMPFiles_IO::CopyFrom ( XMPFiles_IO * source, XMP_Int64 length )
+{
+	XMP_FILESIO_START
+	XMP_Assert ( this->fileRef != Host_IO::noFileRef );
+	XMP_Assert ( source->fileRef != Host_IO::noFileRef );
+
+	if ( this->readOnly )
+		XMP_Throw ( "XMPFiles_IO::CopyFrom, write not permitted on read only file", kXMPErr_FilePermission );
+	if ( source == this ) return 0;	// ! The ranges could overlap, leave it to the caller.
+
+	XMP_Int64 available = source->currLength - source->currOffset;
+	if ( length > available ) length = available;	// The caller's read will report the shortfall.
+	if ( length <= 0 ) return 0;
+
+	source->FlushWrites();
+	this->FlushWrites();
+
+	this->InvalidateCache ( this->currOffset, length );
+	XMP_Int64 amountCopied = Host_IO::CopyRange ( source->fileRef, source->currOffset,
+												  this->fileRef, this->currOffset, length );
+	if ( amountCopied <= 0 ) return 0;
+
+	source->currOffset += amountCopied;
+	this->currOffset += amountCopied;
+	if ( this->currOffset > this->currLength ) this->currLength = this->currOffset;
+	if ( this->progressTracker != 0 ) this->progressTracker->AddWorkDone ( (float) amountCopied );
+
+	return amountCopied;
+	XMP_FILESIO_END1 ( kXMPErrSev_FileFatal )
+	return 0;
+
+}	// XMPFiles_IO::CopyFrom
+
+// =================================================================================================
+// XMPFiles_IO::MapFile
+// ====================
+
+namespace {
+	class FileUnmapper {	// The deleter for the MappedData shared pointer.
+	public:
+		explicit FileUnmapper ( XMP_Int64 _length ) : length(_length) {};
+		void operator() ( XMP_Uns8 * mapAddr ) const { Host_IO::UnmapFile ( mapAddr, this->length ); };
+	private:
+		XMP_Int64 length;
+	};
+}
+
+bool XMPFiles_IO::MapFile()
+{
+	XMP_FILESIO_START
+	XMP_Assert ( this->fileRef != Host_IO::noFileRef );
+
+	if ( this->mapping.get() != 0 ) return true;
+	if ( ! this->readOnly ) return false;	// ! Writes would not be seen through a private mapping.
+
+	XMP_Uns8 * mapAddr = (XMP_Uns8*) Host_IO::MapFile ( this->fileRef, this->currLength );
+	if ( mapAddr == 0 ) return false;	// Not an error, continue reading through the host file.
+
+	this->mapping = MappedData ( mapAddr, FileUnmapper ( this->currLength ) );
+	this->InvalidateCache();
+	return true;
+	XMP_FILESIO_END1 ( kXMPErrSev_Recoverable )
+	return false;
+
+}	// XMPFiles_IO::MapFile
+
+// =================================================================================================
+// XMPFiles_IO::SetReadCache
+// =========================
+
+void XMPFiles_IO::SetReadCache ( XMP_Uns32 pageSize, XMP_Uns32 pageCount )
+{
+	if ( (pageSize == 0) || (pageCount == 0) ) pageSize = pageCount = 0;
+
+	this->cachePageSize = pageSize;
+	this->cachePages.assign ( pageCount, CachePage() );
+	this->cacheStorage.clear();
+	this->cacheClock = 0;
+
+}	// XMPFiles_IO::SetReadCache
+
+// =================================================================================================
+// XMPFiles_IO::SetDefaultReadCache
+// ================================
+
+/* class static */
+void XMPFiles_IO::SetDefaultReadCache ( XMP_Uns32 pageSize, XMP_Uns32 pageCount )
+{
+	if ( (pageSize == 0) || (pageCount == 0) ) pageSize = pageCount = 0;
+
+	sDefaultCachePageSize = pageSize;
+	sDefaultCachePageCount = pageCount;
+
+}	// XMPFiles_IO::SetDefaultReadCache
+
+// =================================================================================================
+// XMPFiles_IO::SetWriteBuffer
+// ===========================
+
+void XMPFiles_IO::SetWriteBuffer ( XMP_Uns32 size )
+{
+	this->FlushWrites();
+
+	this->writeBufferSize = size;
+	std::vector<XMP_Uns8>().swap ( this->writeBuffer );	// Release the old capacity.
+
+}	// XMPFiles_IO::SetWriteBuffer
+
+// =================================================================================================
+// XMPFiles_IO::FlushWrites
+// ========================
+
+void XMPFiles_IO::FlushWrites()
+{
+	if ( this->writeBuffer.empty() ) return;
+
+	XMP_FILESIO_START
+	XMP_Assert ( this->fileRef != Host_IO::noFileRef );
+
+	try {
+		Host_IO::WriteAt ( this->fileRef, this->writeOffset, &this->writeBuffer[0], (XMP_Uns32)this->writeBuffer.size() );
+		this->writeBuffer.clear();
+	} catch ( ... ) {
+		try {
+			// As in Write, make the state reflect what really reached the file.
+			this->writeBuffer.clear();
+			this->InvalidateCache ( this->writeOffset, -1 );
+			this->currLength = Host_IO::Length ( this->fileRef );
+			if ( this->currOffset > this->currLength ) this->currOffset = this->currLength;
+		} catch ( ... ) {
+			// don't do anything
+		}
+		throw;
+	}
+	XMP_FILESIO_END1 ( kXMPErrSev_FileFatal )
+
+}	// XMPFiles_IO::FlushWrites
+
+// =================================================================================================
+// XMPFiles_IO::ReadCached
+// =======================
+//
+// Copy from the cache pages, loading them as needed. The caller has already clipped count to EOF.
+
+XMP_Uns32 XMPFiles_IO::ReadCached ( void * buffer, XMP_Uns32 count )
+{
+	XMP_Assert ( this->cachePageSize != 0 );
+	XMP_Assert ( count <= (this->currLength - this->currOffset) );
+
+	XMP_Uns8 * destPtr = (XMP_Uns8*)buffer;
+	XMP_Int64 filePos = this->currOffset;
+	XMP_Uns32 amountRead = 0;
+
+	while ( amountRead < count ) {
+
+		XMP_Int64 pageOffset = filePos - (filePos % this->cachePageSize);
+		size_t pageIndex = 0;
+		size_t pageCount = this->cachePages.size();
+
+		for ( ; pageIndex < pageCount; ++pageIndex ) {
+			if ( this->cachePages[pageIndex].offset == pageOffset ) break;
+		}
+		if ( pageIndex == pageCount ) pageIndex = this->LoadCachePage ( pageOffset );
+
+		CachePage & page = this->cachePages[pageIndex];
+		page.lastUse = ++this->cacheClock;
+
+		XMP_Uns32 pagePos = (XMP_Uns32) (filePos - pageOffset);
+		if ( pagePos >= page.length ) break;	// Should not happen, the count is clipped to EOF.
+
+		XMP_Uns32 ioCount = page.length - pagePos;
+		if ( ioCount > (count - amountRead) ) ioCount = count - amountRead;
+
+		const XMP_Uns8 * pageData = &this->cacheStorage[pageIndex * this->cachePageSize];
+		memcpy ( destPtr, (pageData + pagePos), ioCount );	// AUDIT: Safe, ioCount is within both buffers.
+
+		destPtr += ioCount;
+		filePos += ioCount;
+		amountRead += ioCount;
+
+	}
+
+	return amountRead;
+
+}	// XMPFiles_IO::ReadCached
+
+// =================================================================================================
+// XMPFiles_IO::LoadCachePage
+// ==========================
+//
+// Read a page into an unused slot, or into the least recently used one. Returns the slot index.
+
+size_t XMPFiles_IO::LoadCachePage ( XMP_Int64 pageOffset )
+{
+	XMP_Assert ( (pageOffset % this->cachePageSize) == 0 );
+	XMP_Assert ( pageOffset < this->currLength );
+
+	if ( this->cacheStorage.empty() ) {
+		this->cacheStorage.resize ( this->cachePages.size() * this->cachePageSize );
+	}
+
+	size_t pageIndex = 0;
+	for ( size_t i = 0, limit = this->cachePages.size(); i < limit; ++i ) {
+		if ( this->cachePages[i].offset == -1 ) { pageIndex = i; break; }
+		if ( this->cachePages[i].lastUse < this->cachePages[pageIndex].lastUse ) pageIndex = i;
+	}
+
+	CachePage & page = this->cachePages[pageIndex];
+	page.offset = -1;	// In case the read throws.
+
+	XMP_Uns32 pageLength = this->cachePageSize;
+	if ( pageLength > (this->currLength - pageOffset) ) pageLength = (XMP_Uns32) (this->currLength - pageOffset);
+
+	XMP_Uns8 * pageData = &this->cacheStorage[pageIndex * this->cachePageSize];
+	XMP_Uns32 amountRead = Host_IO::ReadAt ( this->fileRef, pageOffset, pageData, pageLength );
+	XMP_Enforce ( amountRead == pageLength );
+
+	page.offset = pageOffset;
+	page.length = pageLength;
+	return pageIndex;
+
+}	// XMPFiles_IO::LoadCachePage
+
+// =================================================================================================
+// XMPFiles_IO::InvalidateCache
+// ============================
+//
+// Discard the pages overlapping a byte range, a negative length means through EOF. Whole pages are
+// compared, not just their valid portion, so a short page at EOF is dropped when the file grows.
+
+void XMPFiles_IO::InvalidateCache ( XMP_Int64 offset, XMP_Int64 length )
+{
+	for ( size_t i = 0, limit = this->cachePages.size(); i < limit; ++i ) {
+		CachePage & page = this->cachePages[i];
+		if ( page.offset == -1 ) continue;
+		if ( (page.offset + this->cachePageSize) <= offset ) continue;
+		if ( (length >= 0) && (page.offset >= (offset + length)) ) continue;
+		page.offset = -1;
+		page.length = 0;
+	}
+
+}	// XMPFiles_IO::InvalidateCache
+
+// =================================================================================================
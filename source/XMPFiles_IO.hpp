@@ -19,7 +19,9 @@
 #include "source/XMP_ProgressTracker.hpp"
 #include "XMP_LibUtils.hpp"
 
+#include <memory>
 #include <string>
+#include <vector>
 
 // =================================================================================================
 
@@ -55,6 +57,25 @@ public:
 	XMP_IO * DeriveTemp();
 	void AbsorbTemp();
 	void DeleteTemp();
+
+	// Clone mode for the temp, not part of XMP_IO. Derives the temp if needed, then replaces its
+	// contents with a reflink clone of this file (Host_IO::CloneFile), leaving the temp offset at
+	// 0. Only changed blocks are allocated when the temp is later patched in place, so a copy then
+	// update of a huge file costs about as much as the update. Returns false if the file system
+	// can't clone, the caller must then copy the contents itself.
+
+	bool CloneToTemp();
+
+	// True if tempRef is the temp already derived from this file. Unlike comparing with the result
+	// of DeriveTemp, this never creates a temp.
+
+	bool IsDerivedTemp ( const XMP_IO * tempRef ) const { return (tempRef != 0) && (tempRef == this->derivedTemp); };
+
+	// Only for testing, replaces Host_IO::CloneFile in CloneToTemp so that both outcomes can be
+	// tested on any file system. Zero restores Host_IO::CloneFile.
+
+	typedef bool (* CloneFileProc) ( Host_IO::FileRef srcFile, Host_IO::FileRef dstFile );
+	static void SetCloneFileProc ( CloneFileProc cloneProc );
 	
 	void SetProgressTracker(XMP_ProgressTracker * _progressTracker) {
 		this->progressTracker = _progressTracker;
@@ -66,6 +87,56 @@ public:
 
 	void Close();	// Not part of XMP_IO, added here to let errors propagate.
 
+	// Positional read, not part of XMP_IO. Reads from an absolute offset without using or changing
+	// the current offset and without touching the read cache, returning the number of bytes read.
+	// Only returns less than count at EOF. Unlike the other functions, ReadAt may be called from
+	// several threads at once on the same object, provided nothing writes to the file meanwhile.
+	// Pending buffered writes are seen without being flushed.
+
+	XMP_Uns32 ReadAt ( XMP_Int64 offset, void * buffer, XMP_Uns32 count ) const;
+
+	// Host side copy, not part of XMP_IO. Copies up to length bytes from the current offset of the
+	// source to the current offset of this file using Host_IO::CopyRange, and advances both
+	// offsets by the amount copied. The return value is that amount. It may be short, even 0 when
+	// the host can't copy between these files. The caller copies the rest through a buffer.
+
+	XMP_Int64 CopyFrom ( XMPFiles_IO * source, XMP_Int64 length );
+
+	// Optional block read cache. Reads smaller than a page are served from a small set of page
+	// aligned blocks that are loaded on demand and recycled in LRU order, so the many tiny field
+	// reads done by the handlers cost one host read per page instead of one per field. Writes
+	// discard any overlapping pages when they reach the host, directly or through FlushWrites. A
+	// zero page size or page count turns the cache off. SetDefaultReadCache affects XMPFiles_IO
+	// objects created afterwards, it should only be called during initialization.
+
+	enum { kDefaultCachePageSize = 16*1024, kDefaultCachePageCount = 8 };
+
+	void SetReadCache ( XMP_Uns32 pageSize, XMP_Uns32 pageCount );
+	static void SetDefaultReadCache ( XMP_Uns32 pageSize, XMP_Uns32 pageCount );
+
+	// Write combining. Writes smaller than the buffer that continue where the previous one ended
+	// are collected and passed to the host in one piece. The buffer is flushed before any read,
+	// by a Seek that moves the offset, and by Truncate, Close and AbsorbTemp. Errors from the
+	// buffered writes surface at that point. A zero size turns the buffering off.
+
+	enum { kDefaultWriteBufferSize = 64*1024 };
+
+	void SetWriteBuffer ( XMP_Uns32 size );
+	void FlushWrites();
+
+	// Memory mapped reading, only for files opened read-only. MapFile returns false and leaves the
+	// object reading through the host file if the file can't be mapped. Once mapped, reads are a
+	// copy from the mapping without any host calls. GetMapping returns a shared reference to the
+	// whole file contents, or an empty reference if the file is not mapped. Handlers can keep the
+	// reference to point straight into the file data after the XMPFiles_IO object is closed. The
+	// mapping is private, handlers may modify it in place (e.g. byte swapping) without affecting
+	// the file.
+
+	typedef std::shared_ptr<XMP_Uns8> MappedData;
+
+	bool MapFile();
+	MappedData GetMapping() const { return this->mapping; };
+
 private:
 	bool					readOnly;
 	std::string				filePath;
@@ -78,12 +149,39 @@ private:
 	XMP_ProgressTracker *	progressTracker;	// ! Owned by the XMPFiles object!
 	GenericErrorCallback *	errorCallback;		// ! Owned by the XMPFiles object!
 
+	struct CachePage {
+		XMP_Int64 offset;	// File offset of the page, a multiple of the page size, -1 if unused.
+		XMP_Uns32 length;	// Valid bytes in the page, only less than the page size at EOF.
+		XMP_Uns32 lastUse;	// Value of cacheClock when the page was last touched.
+		CachePage() : offset(-1), length(0), lastUse(0) {};
+	};
+
+	XMP_Uns32				cachePageSize;
+	std::vector<CachePage>	cachePages;
+	std::vector<XMP_Uns8>	cacheStorage;	// ! Allocated on first use, pages are consecutive slices.
+	XMP_Uns32				cacheClock;
+
+	MappedData				mapping;	// Empty unless MapFile succeeded, the cache is not used then.
+
+	XMP_Uns32				writeBufferSize;
+	std::vector<XMP_Uns8>	writeBuffer;	// The pending bytes, the capacity is reserved on first use.
+	XMP_Int64				writeOffset;	// File offset of the first pending byte.
+
+	XMP_Uns32 ReadCached ( void * buffer, XMP_Uns32 count );
+	size_t LoadCachePage ( XMP_Int64 pageOffset );
+	void InvalidateCache ( XMP_Int64 offset, XMP_Int64 length );
+	void InvalidateCache() { this->InvalidateCache ( 0, -1 ); };
+
 	// Hidden on purpose.
 	XMPFiles_IO()
 		: fileRef(Host_IO::noFileRef)
 		, isTemp(false)
 		, derivedTemp(0)
-		, progressTracker(0) {};
+		, progressTracker(0)
+		, cachePageSize(0)
+		, cacheClock(0)
+		, writeBufferSize(0)
+		, writeOffset(0) {};
 
 	// The copy constructor and assignment operators are private to prevent client use. Allowing
 	// them would require shared I/O state between XMPFiles_IO objects.
@@ -0,0 +1,112 @@
+/*
+ * exempi - XMP_VectorScan.hpp
+ *
+ * Copyright (C) 2026 The exempi contributors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1 Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *
+ * 2 Redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the
+ * distribution.
+ *
+ * 3 Neither the name of the Authors, nor the names of its
+ * contributors may be used to endorse or promote products derived
+ * from this software wit hout specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __XMP_VectorScan_hpp__
+#define __XMP_VectorScan_hpp__ 1
+
+#include "public/include/XMP_Environment.h"	// ! XMP_Environment.h must be the first included header.
+#include "public/include/XMP_Const.h"
+
+// =================================================================================================
+// Support for the vector byte scans of the packet scanner and the parser's UTF-8 check. SSE2 is
+// part of the x86-64 base, AVX2 is chosen at run time with HaveAVX2. Define ScanWithSSE2 or
+// ScanWithAVX2 as 0 to build only the scalar forms.
+// =================================================================================================
+
+#ifndef ScanWithSSE2
+	#if (defined(__GNUC__) && (defined(__x86_64__) || defined(__SSE2__))) || \
+		(defined(_MSC_VER) && (defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))))
+		#define ScanWithSSE2	1
+	#else
+		#define ScanWithSSE2	0
+	#endif
+#endif
+
+#ifndef ScanWithAVX2
+	#if ScanWithSSE2 && defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+		#define ScanWithAVX2	1
+	#else
+		#define ScanWithAVX2	0
+	#endif
+#endif
+
+#if ScanWithSSE2
+	#include <emmintrin.h>
+#endif
+#if ScanWithAVX2
+	#include <immintrin.h>
+#endif
+
+// -------------------------------------------------------------------------------------------------
+// The index of the lowest or highest set bit of a movemask result, the mask must not be zero.
+
+static inline int LowBitIndex ( XMP_Uns32 mask )
+{
+	#if defined(__GNUC__)
+		return __builtin_ctz ( mask );
+	#else
+		int index = 0;
+		while ( (mask & 1) == 0 ) { mask >>= 1; ++index; }
+		return index;
+	#endif
+}
+
+static inline int HighBitIndex ( XMP_Uns32 mask )
+{
+	#if defined(__GNUC__)
+		return 31 - __builtin_clz ( mask );
+	#else
+		int index = 31;
+		while ( (mask & 0x80000000UL) == 0 ) { mask <<= 1; --index; }
+		return index;
+	#endif
+}
+
+#if ScanWithAVX2
+
+// The CPU check is done once per process.
+
+inline bool HaveAVX2()
+{
+	static const bool haveAVX2 = (__builtin_cpu_supports ( "avx2" ) != 0);
+	return haveAVX2;
+}
+
+#endif
+
+// =================================================================================================
+
+#endif	// __XMP_VectorScan_hpp__